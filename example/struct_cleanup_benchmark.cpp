@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#define VK_STRUCT_CLEANUP_CONFIG_MAIN
+#include "vk_struct_cleanup.hpp"
+
+// Times `vk_struct_cleanup` over many heap-allocated graphics pipeline descriptions, each with
+// shader stages, names, fixed-function state and a pNext chain to walk. The number of pipelines
+// can be given as the first argument, defaulting to 100000.
+
+namespace {
+
+template <typename T>
+T *allocate(std::size_t count = 1) {
+    return static_cast<T *>(calloc(count, sizeof(T)));
+}
+
+char *allocateString(char const *pStr) {
+    auto *pNew = static_cast<char *>(malloc(strlen(pStr) + 1));
+    strcpy(pNew, pStr);
+    return pNew;
+}
+
+VkGraphicsPipelineCreateInfo *buildPipeline() {
+    auto *pStages = allocate<VkPipelineShaderStageCreateInfo>(2);
+    for (uint32_t i = 0; i < 2; ++i) {
+        pStages[i].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pStages[i].pName = allocateString("main");
+    }
+
+    auto *pVertexInput = allocate<VkPipelineVertexInputStateCreateInfo>();
+    pVertexInput->sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    pVertexInput->vertexBindingDescriptionCount = 1;
+    pVertexInput->pVertexBindingDescriptions = allocate<VkVertexInputBindingDescription>();
+    pVertexInput->vertexAttributeDescriptionCount = 3;
+    pVertexInput->pVertexAttributeDescriptions = allocate<VkVertexInputAttributeDescription>(3);
+
+    auto *pViewport = allocate<VkPipelineViewportStateCreateInfo>();
+    pViewport->sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    pViewport->viewportCount = 1;
+    pViewport->pViewports = allocate<VkViewport>();
+
+    auto *pColorBlend = allocate<VkPipelineColorBlendStateCreateInfo>();
+    pColorBlend->sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    pColorBlend->attachmentCount = 1;
+    pColorBlend->pAttachments = allocate<VkPipelineColorBlendAttachmentState>();
+
+    auto *pRendering = allocate<VkPipelineRenderingCreateInfo>();
+    pRendering->sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    pRendering->colorAttachmentCount = 1;
+    pRendering->pColorAttachmentFormats = allocate<VkFormat>();
+
+    auto *pPipeline = allocate<VkGraphicsPipelineCreateInfo>();
+    pPipeline->sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pPipeline->pNext = pRendering;
+    pPipeline->stageCount = 2;
+    pPipeline->pStages = pStages;
+    pPipeline->pVertexInputState = pVertexInput;
+    pPipeline->pViewportState = pViewport;
+    pPipeline->pColorBlendState = pColorBlend;
+
+    return pPipeline;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::size_t count = 100000;
+    if (argc > 1)
+        count = std::strtoull(argv[1], nullptr, 10);
+
+    std::vector<VkGraphicsPipelineCreateInfo *> pipelines;
+    pipelines.reserve(count);
+    for (std::size_t i = 0; i < count; ++i)
+        pipelines.push_back(buildPipeline());
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto *pPipeline : pipelines) {
+        vk_struct_cleanup(pPipeline);
+        free(pPipeline);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "Cleaned up " << count << " pipelines in " << ns / 1000000.0 << " ms ("
+              << static_cast<double>(ns) / count << " ns each)" << std::endl;
+}
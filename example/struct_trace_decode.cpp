@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#define VK_STRUCT_TRACE_CONFIG_DECODE
+#include "vk_struct_trace.hpp"
+
+#define VK_STRUCT_PRINTER_CONFIG_MAIN
+#include "vk_struct_printer.hpp"
+
+// Prints every struct in a trace file, as written by `vk_trace_write_header` followed by
+// `vk_trace_drain`, so that the capturing program never formats anything itself.
+
+namespace {
+
+class StdoutSink final : public VkPrintSink {
+  public:
+    void write(char const *pData, std::size_t size) override {
+        std::fwrite(pData, 1, size, stdout);
+    }
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream inFile(argv[1], std::ifstream::binary);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<char> trace{std::istreambuf_iterator<char>{inFile},
+                            std::istreambuf_iterator<char>{}};
+
+    StdoutSink sink;
+    bool const valid = vk_trace_decode(
+        trace.data(), trace.size(),
+        [](VkTraceRecord const &record, void *pUserData) {
+            std::printf("[thread %u, #%llu] ", static_cast<unsigned>(record.thread),
+                        static_cast<unsigned long long>(record.sequence));
+            vk_print_struct(record.pStruct, *static_cast<StdoutSink *>(pUserData));
+        },
+        &sink);
+
+    if (!valid) {
+        std::fflush(stdout);
+        std::cerr << "Error: The trace is invalid, truncated, or from a different Vulkan header"
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
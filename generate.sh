@@ -41,6 +41,22 @@ elif [ ! -x VkErrorCode ]; then
     printf " >> Error: Could not find 'VkErrorCode' executable\n"
 elif [ ! -x VkStructCleanup ]; then
     printf " >> Error: Could not find 'VkStructCleanup' executable\n"
+elif [ ! -x VkStructIntern ]; then
+    printf " >> Error: Could not find 'VkStructIntern' executable\n"
+elif [ ! -x VkStructReflection ]; then
+    printf " >> Error: Could not find 'VkStructReflection' executable\n"
+elif [ ! -x VkFormatInfo ]; then
+    printf " >> Error: Could not find 'VkFormatInfo' executable\n"
+elif [ ! -x VkDispatchTable ]; then
+    printf " >> Error: Could not find 'VkDispatchTable' executable\n"
+elif [ ! -x VkEnumValidation ]; then
+    printf " >> Error: Could not find 'VkEnumValidation' executable\n"
+elif [ ! -x VkStructValidation ]; then
+    printf " >> Error: Could not find 'VkStructValidation' executable\n"
+elif [ ! -x VkStructPrinter ]; then
+    printf " >> Error: Could not find 'VkStructPrinter' executable\n"
+elif [ ! -x VkStructTrace ]; then
+    printf " >> Error: Could not find 'VkStructTrace' executable\n"
 fi
 
 # Clone/update the Vulkan-Docs repository
@@ -55,12 +71,28 @@ mkdir -p ../include/detail_value_serialization/
 mkdir -p ../include/detail_equality_checks/
 mkdir -p ../include/detail_error_code/
 mkdir -p ../include/detail_struct_cleanup/
+mkdir -p ../include/detail_struct_intern/
+mkdir -p ../include/detail_struct_reflection/
+mkdir -p ../include/detail_format_info/
+mkdir -p ../include/detail_dispatch_table/
+mkdir -p ../include/detail_enum_validation/
+mkdir -p ../include/detail_struct_validation/
+mkdir -p ../include/detail_struct_printer/
+mkdir -p ../include/detail_struct_trace/
 
 # Prepare the top-level headers
 cat ../scripts/equality_check_start.txt >../include/vk_equality_checks.hpp
 cat ../scripts/vulkan_string_parsing_start.txt >../include/vk_value_serialization.hpp
 cat ../scripts/error_code_start.txt >../include/vk_error_code.hpp
 cat ../scripts/struct_cleanup_start.txt >../include/vk_struct_cleanup.hpp
+cat ../scripts/struct_intern_start.txt >../include/vk_struct_intern.hpp
+cat ../scripts/struct_reflection_start.txt >../include/vk_struct_reflection.hpp
+cat ../scripts/format_info_start.txt >../include/vk_format_info.hpp
+cat ../scripts/dispatch_table_start.txt >../include/vk_dispatch_table.hpp
+cat ../scripts/enum_validation_start.txt >../include/vk_enum_validation.hpp
+cat ../scripts/struct_validation_start.txt >../include/vk_struct_validation.hpp
+cat ../scripts/struct_printer_start.txt >../include/vk_struct_printer.hpp
+cat ../scripts/struct_trace_start.txt >../include/vk_struct_trace.hpp
 
 # Generate the per-version files
 for TAG in $(git tag | grep -e "^v[0-9]*\.[0-9]*\.[0-9]*$" | sort -t '.' -k3nr); do
@@ -107,6 +139,78 @@ EOL
 #if VK_HEADER_VERSION == ${VER}
     #include "detail_struct_cleanup/vk_struct_cleanup_v${VER}.hpp"
 #endif
+EOL
+
+    # Generate struct interning
+    ../VkStructIntern -i xml/vk.xml -d ../include/detail_struct_intern/ -o vk_struct_intern_v$VER.hpp
+
+    cat >>../include/vk_struct_intern.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_struct_intern/vk_struct_intern_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate struct reflection
+    ../VkStructReflection -i xml/vk.xml -d ../include/detail_struct_reflection/ -o vk_struct_reflection_v$VER.hpp
+
+    cat >>../include/vk_struct_reflection.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_struct_reflection/vk_struct_reflection_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate format info
+    ../VkFormatInfo -i xml/vk.xml -d ../include/detail_format_info/ -o vk_format_info_v$VER.hpp
+
+    cat >>../include/vk_format_info.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_format_info/vk_format_info_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate dispatch tables
+    ../VkDispatchTable -i xml/vk.xml -d ../include/detail_dispatch_table/ -o vk_dispatch_table_v$VER.hpp
+
+    cat >>../include/vk_dispatch_table.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_dispatch_table/vk_dispatch_table_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate enum validation
+    ../VkEnumValidation -i xml/vk.xml -d ../include/detail_enum_validation/ -o vk_enum_validation_v$VER.hpp
+
+    cat >>../include/vk_enum_validation.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_enum_validation/vk_enum_validation_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate struct validation
+    ../VkStructValidation -i xml/vk.xml -d ../include/detail_struct_validation/ -o vk_struct_validation_v$VER.hpp
+
+    cat >>../include/vk_struct_validation.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_struct_validation/vk_struct_validation_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate struct printers
+    ../VkStructPrinter -i xml/vk.xml -d ../include/detail_struct_printer/ -o vk_struct_printer_v$VER.hpp
+
+    cat >>../include/vk_struct_printer.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_struct_printer/vk_struct_printer_v${VER}.hpp"
+#endif
+EOL
+
+    # Generate struct tracing
+    ../VkStructTrace -i xml/vk.xml -d ../include/detail_struct_trace/ -o vk_struct_trace_v$VER.hpp
+
+    cat >>../include/vk_struct_trace.hpp <<EOL
+#if VK_HEADER_VERSION == ${VER}
+    #include "detail_struct_trace/vk_struct_trace_v${VER}.hpp"
+#endif
 EOL
 
 done
@@ -116,3 +220,11 @@ cat ../scripts/equality_check_end.txt >>../include/vk_equality_checks.hpp
 cat ../scripts/vulkan_string_parsing_end.txt >>../include/vk_value_serialization.hpp
 cat ../scripts/error_code_end.txt >>../include/vk_error_code.hpp
 cat ../scripts/error_code_end.txt >>../include/vk_struct_cleanup.hpp
+cat ../scripts/struct_intern_end.txt >>../include/vk_struct_intern.hpp
+cat ../scripts/struct_reflection_end.txt >>../include/vk_struct_reflection.hpp
+cat ../scripts/format_info_end.txt >>../include/vk_format_info.hpp
+cat ../scripts/dispatch_table_end.txt >>../include/vk_dispatch_table.hpp
+cat ../scripts/enum_validation_end.txt >>../include/vk_enum_validation.hpp
+cat ../scripts/struct_validation_end.txt >>../include/vk_struct_validation.hpp
+cat ../scripts/struct_printer_end.txt >>../include/vk_struct_printer.hpp
+cat ../scripts/struct_trace_end.txt >>../include/vk_struct_trace.hpp
@@ -0,0 +1,184 @@
+/*
+    Copyright (C) 2020 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef COMPARE_MEMBERS_HPP
+#define COMPARE_MEMBERS_HPP
+
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "parse_xml.hpp"
+
+enum class CompareType {
+    // A member that is the `len` of another, compared before any of the arrays
+    Count,
+    // Fixed-size array members, such as `float blendConstants[4]`
+    FixedArray,
+    // VkDescriptorSetLayoutBinding::pImmutableSamplers, which may be null despite a count
+    ImmutableSamplers,
+    // `len="null-terminated"` strings, compared by content
+    String,
+    // `void*` data with a byte length, compared by content
+    RawData,
+    // Pointers to a `len`-counted number of elements
+    Array,
+    // Everything else, compared by value
+    Value,
+};
+
+struct CompareMember {
+    CompareType type;
+    MemberData const *member;
+    // For Count, the counting member. For ImmutableSamplers/Array/RawData, the element count
+    // expression, with the struct variable to be inserted at countMemberPos.
+    std::string count = {};
+    std::size_t countMemberPos = std::string::npos;
+};
+
+// The same set of structs is used for all comparison-based functions
+bool skipStruct(StructData const &structData, std::vector<UnionData> const &unions) {
+    // If no members to compare, then no point
+    if (structData.members.empty())
+        return true;
+
+    if (structData.name == "VkDeviceCreateInfo" || structData.name == "VkInstanceCreateInfo")
+        return true;
+
+    if (structHasUnion(structData, unions))
+        return true;
+
+    return false;
+}
+
+// Returns the count expression of an array member, as accessed through the given struct variable
+std::string getCountExpr(CompareMember const &compareMember, std::string_view structVar) {
+    std::string countExpr = compareMember.count;
+    if (compareMember.countMemberPos != std::string::npos) {
+        countExpr.insert(compareMember.countMemberPos, std::string{structVar} + ".");
+    }
+    return countExpr;
+}
+
+// Returns the members of the struct that are compared, in the order they are to be compared.
+// Every comparison function generated works from this same list, so that they all agree on what
+// makes two structs equal.
+std::vector<CompareMember> getCompareMembers(StructData const &structData) {
+    std::vector<CompareMember> compareMembers;
+
+    // Len members
+    for (auto const &member : structData.members) {
+        if (member.len.empty() || member.len == "null-terminated" ||
+            member.len.find("VK_UUID_SIZE") != std::string::npos ||
+            member.len.find("VK\\_UUID\\_SIZE") != std::string::npos)
+            continue;
+
+        compareMembers.push_back({CompareType::Count, &member, member.len});
+    }
+    // Array members
+    for (auto const &member : structData.members) {
+        if (!member.sizeEnum.empty()) {
+            compareMembers.push_back({CompareType::FixedArray, &member});
+        } else if (!member.len.empty()) {
+            if (member.name == "pImmutableSamplers") {
+                compareMembers.push_back(
+                    {CompareType::ImmutableSamplers, &member, "descriptorCount", 0});
+            } else if (member.len == "null-terminated") {
+                compareMembers.push_back({CompareType::String, &member});
+            } else if (member.type == "void" && member.typeSuffix == "*") {
+                compareMembers.push_back({CompareType::RawData, &member, member.altlen, 0});
+            } else {
+                std::size_t countMemberPos = std::string::npos;
+                if (member.altlen != "2*VK_UUID_SIZE") {
+                    countMemberPos = member.altlen.find(member.len);
+                }
+                compareMembers.push_back(
+                    {CompareType::Array, &member, member.altlen, countMemberPos});
+            }
+        }
+    }
+    // Regular members
+    for (auto const &member : structData.members) {
+        // Don't do array members here
+        if (!member.sizeEnum.empty() || !member.len.empty())
+            continue;
+
+        // Don't do one if it's a member length count
+        for (auto const &inMem : structData.members) {
+            if (member.name == inMem.len)
+                goto MEMBER_END;
+        }
+
+        // Don't do 'void' pointer types
+        if (member.name == "pNext" && member.type == "void" && member.typeSuffix == "*")
+            continue;
+
+        compareMembers.push_back({CompareType::Value, &member});
+    MEMBER_END:;
+    }
+
+    return compareMembers;
+}
+
+// Returns the structs for which `operator==` is the same as comparing the bytes of the whole
+// struct, being compared entirely by-value with no pointed-to data and no ignored members. Any
+// padding or floating-point members need to be checked with
+// `std::has_unique_object_representations` where the struct types are known.
+std::set<std::string_view> getBitwiseComparableStructs(std::vector<StructData> const &structs,
+                                                       std::vector<UnionData> const &unions) {
+    std::set<std::string_view> bitwiseStructs;
+    std::set<std::string_view> comparedStructs;
+    for (auto const &it : structs) {
+        if (!skipStruct(it, unions))
+            comparedStructs.insert(it.name);
+    }
+
+    // Repeat until settled, as struct members may be declared in any order
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto const &it : structs) {
+            if (!comparedStructs.contains(it.name) || bitwiseStructs.contains(it.name))
+                continue;
+
+            auto compareMembers = getCompareMembers(it);
+            if (compareMembers.size() != it.members.size())
+                continue;
+
+            bool bitwise = true;
+            for (auto const &compareMember : compareMembers) {
+                auto const &member = *compareMember.member;
+                if (compareMember.type != CompareType::Value &&
+                    compareMember.type != CompareType::FixedArray) {
+                    bitwise = false;
+                } else if (member.typeSuffix.empty() && comparedStructs.contains(member.type) &&
+                           !bitwiseStructs.contains(member.type)) {
+                    bitwise = false;
+                }
+            }
+
+            if (bitwise) {
+                bitwiseStructs.insert(it.name);
+                changed = true;
+            }
+        }
+    }
+
+    return bitwiseStructs;
+}
+
+#endif // COMPARE_MEMBERS_HPP
@@ -0,0 +1,206 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef DENSE_TABLE_HPP
+#define DENSE_TABLE_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Extension enum values start here, with a block of 1000 for each extension number
+constexpr int64_t cExtensionValueBase = 1000000000;
+
+/**
+ * @brief Writes the values of a generated array, a number of them to each line
+ * @param out Stream to write to
+ * @param values Values of the array
+ * @param perLine Number of values on each line
+ * @param indent Indent of each line
+ *
+ * Arrays can't be empty, so an empty one gets a single 0, which lookups treat as nothing.
+ */
+template <typename T>
+void writeTableValues(std::ostream &out,
+                      std::vector<T> const &values,
+                      std::size_t perLine,
+                      std::string_view indent = "    ") {
+    if (values.empty()) {
+        out << indent << "0,\n";
+        return;
+    }
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        out << ((i % perLine == 0) ? indent : " ") << values[i] << ",";
+        if (i % perLine == perLine - 1 || i + 1 == values.size())
+            out << "\n";
+    }
+}
+
+/// The names used for the generated tables and lookup of one enum type
+struct DenseTableNames {
+    /// Used in the table names, such as 'Format' for cCoreFormatIndices and findFormatIndex
+    std::string_view name;
+    /// Name of the enum type, such as 'VkFormat'
+    std::string_view type;
+    /// Array indexed by the lookup, where entry 0 is for unknown values
+    std::string_view infoTable;
+    /// Member of the infoTable entries holding their enum value
+    std::string_view valueMember;
+};
+
+/**
+ * @brief Maps the values of an enum to indices into a generated array, without a switch
+ *
+ * Core values index a table of their own directly, while extension values pick the block of their
+ * extension number, each being a range of a single table of all the extension values, so that
+ * looking up any value takes the same time without leaving gaps for the values in between.
+ *
+ * For signed enums, such as VkResult, each magnitude has a slot for the positive value followed by
+ * one for the negative value.
+ */
+class DenseIndexTable {
+  public:
+    explicit DenseIndexTable(bool signedValues = false) : signedValues{signedValues} {}
+
+    /// Returns the index of a value, 0 until set, adding slots for it as needed
+    uint32_t &at(int64_t value) {
+        std::size_t const negative = (value < 0) ? 1 : 0;
+        uint64_t const magnitude = negative ? -value : value;
+        std::size_t const slotsPerValue = signedValues ? 2 : 1;
+
+        std::vector<uint32_t> *pIndices = &coreIndices;
+        std::size_t slot = magnitude * slotsPerValue + negative;
+        if (magnitude >= cExtensionValueBase) {
+            std::size_t const block = (magnitude - cExtensionValueBase) / 1000;
+            if (extensionIndices.size() <= block)
+                extensionIndices.resize(block + 1);
+            pIndices = &extensionIndices[block];
+            slot = (magnitude % 1000) * slotsPerValue + negative;
+        }
+        if (pIndices->size() <= slot)
+            pIndices->resize(slot + 1);
+        return (*pIndices)[slot];
+    }
+
+    /**
+     * @brief Writes the tables, followed by a constexpr lookup into them and a check of it
+     * @param out Stream to write to, within the namespace the tables are to be in
+     * @param names Names of the tables, and of the array they index
+     *
+     * The lookup, such as `findFormatIndex(int64_t)`, returns the index of a value, or 0 if it's
+     * unknown.
+     */
+    void write(std::ostream &out, DenseTableNames const &names) const {
+        std::vector<std::string> blocks;
+        std::vector<uint32_t> flatExtensionIndices;
+        for (auto const &indices : extensionIndices) {
+            blocks.push_back("{" + std::to_string(flatExtensionIndices.size()) + ", " +
+                             std::to_string(indices.size()) + "}");
+            flatExtensionIndices.insert(flatExtensionIndices.end(), indices.begin(),
+                                        indices.end());
+        }
+
+        std::string const base = "cExtension" + std::string{names.name} + "Base";
+        std::string const blockType = "Vk" + std::string{names.name} + "Block";
+        std::string const coreCount = "cCore" + std::string{names.name} + "Count";
+        std::string const coreTable = "cCore" + std::string{names.name} + "Indices";
+        std::string const blockCount = "cExtension" + std::string{names.name} + "BlockCount";
+        std::string const blockTable = "cExtension" + std::string{names.name} + "Blocks";
+        std::string const extensionTable = "cExtension" + std::string{names.name} + "Indices";
+
+        out << "\n/// Extension " << names.type
+            << " values start here, with a block of 1000 for each extension number\n";
+        out << "constexpr uint32_t " << base << " = " << cExtensionValueBase << ";\n";
+
+        out << "\n/// Range of " << extensionTable << " used for the values of one extension\n";
+        out << "struct " << blockType << " {\n";
+        out << "    uint16_t first;\n";
+        out << "    uint16_t count;\n";
+        out << "};\n";
+
+        out << "\n/// Index into " << names.infoTable << " of each core " << names.type
+            << (signedValues ? " slot" : " value") << ", or 0 for none\n";
+        if (signedValues) {
+            out << "/// Each magnitude has a slot for its positive value, followed by one for its "
+                   "negative value\n";
+        }
+        out << "constexpr uint32_t " << coreCount << " = " << coreIndices.size() << ";\n";
+        out << "inline constexpr uint16_t " << coreTable << "[] = {\n";
+        writeTableValues(out, coreIndices, 16);
+        out << "};\n";
+
+        out << "\n/// The block of each extension, by extension number - 1\n";
+        out << "constexpr uint32_t " << blockCount << " = " << blocks.size() << ";\n";
+        out << "inline constexpr " << blockType << " " << blockTable << "[] = {\n";
+        writeTableValues(out, blocks, 8);
+        out << "};\n";
+
+        out << "\n/// Index into " << names.infoTable << " of each extension " << names.type
+            << (signedValues ? " slot" : " value") << ", or 0 for none\n";
+        out << "inline constexpr uint16_t " << extensionTable << "[] = {\n";
+        writeTableValues(out, flatExtensionIndices, 16);
+        out << "};\n";
+
+        out << "\n/// Index into " << names.infoTable << " of a value, or 0 if it's unknown\n";
+        out << "constexpr uint32_t find" << names.name << "Index(int64_t value) noexcept {\n";
+        if (signedValues) {
+            out << "    uint32_t const negative = (value < 0) ? 1 : 0;\n";
+            out << "    uint64_t const magnitude = negative ? -value : value;\n";
+        } else {
+            out << "    if (value < 0)\n";
+            out << "        return 0;\n";
+            out << "    uint64_t const magnitude = value;\n";
+        }
+        out << "\n";
+        out << "    if (magnitude < " << base << ") {\n";
+        out << "        uint64_t const slot = "
+            << (signedValues ? "magnitude * 2 + negative" : "magnitude") << ";\n";
+        out << "        return (slot < " << coreCount << ") ? " << coreTable << "[slot] : 0;\n";
+        out << "    }\n";
+        out << "\n";
+        out << "    uint64_t const block = (magnitude - " << base << ") / 1000;\n";
+        out << "    uint64_t const slot = "
+            << (signedValues ? "(magnitude % 1000) * 2 + negative" : "magnitude % 1000") << ";\n";
+        out << "    if (block >= " << blockCount << " || slot >= " << blockTable
+            << "[block].count)\n";
+        out << "        return 0;\n";
+        out << "    return " << extensionTable << "[" << blockTable << "[block].first + slot];\n";
+        out << "}\n";
+
+        out << "\n// The indices are built from the values in vk.xml, so check they agree with the "
+               "header's\n";
+        out << "constexpr bool check" << names.name << "Indices() noexcept {\n";
+        out << "    for (uint32_t i = 1; i < sizeof(" << names.infoTable << ") / sizeof("
+            << names.infoTable << "[0]); ++i) {\n";
+        out << "        if (find" << names.name << "Index(" << names.infoTable << "[i]."
+            << names.valueMember << ") != i)\n";
+        out << "            return false;\n";
+        out << "    }\n";
+        out << "    return true;\n";
+        out << "}\n";
+        out << "\nstatic_assert(check" << names.name << "Indices(), \"" << names.type
+            << " values don't match those of vk.xml\");\n";
+    }
+
+  private:
+    bool signedValues;
+    std::vector<uint32_t> coreIndices;
+    std::vector<std::vector<uint32_t>> extensionIndices;
+};
+
+#endif // DENSE_TABLE_HPP
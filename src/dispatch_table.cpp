@@ -0,0 +1,504 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains global, instance and device dispatch
+table structs with a function pointer for each Vulkan command, along with
+loaders that fill them through vkGetInstanceProcAddr and vkGetDeviceProcAddr,
+only loading the extension commands of the enabled extensions. Calling through
+the tables skips the loader's trampolines.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_dispatch_table.hpp`)
+)HELP";
+
+constexpr std::string_view usageStr = R"USAGE(
+/*  USAGE
+    To use, include this header where the declarations for the dispatch tables are required.
+
+    On *ONE* compilation unit, include the definition of `#define VK_DISPATCH_TABLE_CONFIG_MAIN`
+    so that the definitions are compiled somewhere following the one definition rule.
+*/
+)USAGE";
+
+constexpr std::string_view declarationStr = R"DECL(
+/** @brief Fills a table with the global commands, those used before there is an instance
+ * @param pTable Table to fill, with commands that aren't available set to nullptr
+ * @param getInstanceProcAddr Used to get each command, with a VK_NULL_HANDLE instance
+ */
+void vk_load_global_dispatch_table(VkGlobalDispatchTable *pTable,
+                                   PFN_vkGetInstanceProcAddr getInstanceProcAddr);
+
+/** @brief Fills a table with the instance-level commands of an instance
+ * @param pTable Table to fill, with commands that aren't loaded set to nullptr
+ * @param getInstanceProcAddr Used to get each command
+ * @param instance Instance to get the commands of
+ * @param enabledExtensionCount Number of enabled instance extensions
+ * @param ppEnabledExtensionNames Names of the enabled instance extensions, as given to
+ * vkCreateInstance
+ *
+ * Core commands are always loaded, while those of instance extensions are only loaded when the
+ * extension is enabled. Instance-level commands of device extensions are always loaded, as which
+ * device extensions are used isn't known yet.
+ *
+ * When only the extension that a command was promoted from is enabled, the core command is
+ * filled in from the extension's.
+ */
+void vk_load_instance_dispatch_table(VkInstanceDispatchTable *pTable,
+                                     PFN_vkGetInstanceProcAddr getInstanceProcAddr,
+                                     VkInstance instance,
+                                     uint32_t enabledExtensionCount,
+                                     char const *const *ppEnabledExtensionNames);
+
+/** @brief Fills a table with the device-level commands of a device
+ * @param pTable Table to fill, with commands that aren't loaded set to nullptr
+ * @param getDeviceProcAddr Used to get each command, such as from the instance table
+ * @param device Device to get the commands of
+ * @param enabledExtensionCount Number of enabled device extensions
+ * @param ppEnabledExtensionNames Names of the enabled device extensions, as given to
+ * vkCreateDevice
+ *
+ * The commands are those of the device's driver, so calling them skips the loader's
+ * trampolines. Core commands are always loaded, while those of device extensions are only loaded
+ * when the extension is enabled. Device-level commands of instance extensions are always loaded.
+ *
+ * When only the extension that a command was promoted from is enabled, the core command is
+ * filled in from the extension's.
+ */
+void vk_load_device_dispatch_table(VkDeviceDispatchTable *pTable,
+                                   PFN_vkGetDeviceProcAddr getDeviceProcAddr,
+                                   VkDevice device,
+                                   uint32_t enabledExtensionCount,
+                                   char const *const *ppEnabledExtensionNames);
+)DECL";
+
+constexpr std::string_view detailStr = R"DETAIL(
+#include <array>
+#include <cstring>
+
+namespace vk_dispatch_table_detail {
+
+// Which of the known extensions are in the list of enabled ones
+template <std::size_t N>
+std::array<bool, N> getEnabledExtensions(std::array<char const *, N> const &knownExtensions,
+                                         uint32_t enabledExtensionCount,
+                                         char const *const *ppEnabledExtensionNames) {
+    std::array<bool, N> enabled{};
+    for (uint32_t i = 0; i < enabledExtensionCount; ++i) {
+        for (std::size_t j = 0; j < N; ++j) {
+            if (strcmp(ppEnabledExtensionNames[i], knownExtensions[j]) == 0)
+                enabled[j] = true;
+        }
+    }
+    return enabled;
+}
+
+} // namespace vk_dispatch_table_detail
+)DETAIL";
+
+enum class DispatchLevel {
+    Global,
+    Instance,
+    Device,
+};
+
+struct DispatchCommand {
+    CommandData const *command;
+    // The type of the pointer, which for aliases is that of the aliased command
+    std::string_view pfnName;
+    DispatchLevel level;
+    // The platform define to guard it with, if any
+    std::string_view platformDefine;
+};
+
+std::string_view getTableName(DispatchLevel level) {
+    switch (level) {
+    case DispatchLevel::Global:
+        return "VkGlobalDispatchTable";
+    case DispatchLevel::Instance:
+        return "VkInstanceDispatchTable";
+    default:
+        return "VkDeviceDispatchTable";
+    }
+}
+
+// The level of a command is decided by the dispatchable handle it is first given, other than
+// vkGetDeviceProcAddr, which is needed before there is a device table to get it from
+DispatchLevel getDispatchLevel(CommandData const &command) {
+    if (command.name == "vkGetDeviceProcAddr")
+        return DispatchLevel::Instance;
+    if (command.params.empty())
+        return DispatchLevel::Global;
+
+    std::string_view firstType = command.params.front().type;
+    if (firstType == "VkInstance" || firstType == "VkPhysicalDevice")
+        return DispatchLevel::Instance;
+    if (firstType == "VkDevice" || firstType == "VkQueue" || firstType == "VkCommandBuffer")
+        return DispatchLevel::Device;
+    return DispatchLevel::Global;
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_dispatch_table.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    auto *extensionsNode = registryNode->first_node("extensions");
+    if (extensionsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'extensions' node." << std::endl;
+        return 1;
+    }
+
+    auto extensions = getExtensionData(extensionsNode);
+    auto commands = getCommandData(registryNode);
+
+    std::map<std::string_view, ExtensionData const *> extensionLookup;
+    for (auto const &it : extensions)
+        extensionLookup[it.name] = &it;
+    std::map<std::string_view, CommandData const *> commandLookup;
+    for (auto const &it : commands)
+        commandLookup[it.name] = &it;
+
+    // Every command that is required by something, with its level and guard
+    std::vector<DispatchCommand> dispatchCommands;
+    for (auto const &it : commands) {
+        if (!it.core && it.extensions.empty())
+            continue;
+
+        // Aliases take everything but their name from the command they alias
+        CommandData const *pTarget = &it;
+        while (!pTarget->alias.empty()) {
+            auto targetIt = commandLookup.find(pTarget->alias);
+            if (targetIt == commandLookup.end()) {
+                pTarget = nullptr;
+                break;
+            }
+            pTarget = targetIt->second;
+        }
+        if (pTarget == nullptr) {
+            std::cout << "Info: Skipping " << it.name << ", as the command it aliases is unknown"
+                      << std::endl;
+            continue;
+        }
+        // Only guarded if every extension requiring it is for the same platform
+        std::string_view platform;
+        if (!it.core) {
+            platform = extensionLookup.at(it.extensions.front())->platform;
+            for (auto extension : it.extensions) {
+                if (extensionLookup.at(extension)->platform != platform)
+                    platform = {};
+            }
+        }
+        std::string_view platformDefine;
+        for (auto const &platformData : platforms) {
+            if (platform == platformData.name)
+                platformDefine = platformData.define;
+        }
+
+        dispatchCommands.push_back(
+            {&it, pTarget->name, getDispatchLevel(*pTarget), platformDefine});
+    }
+
+    // The extensions that gate the loading of commands, for each level
+    std::map<DispatchLevel, std::vector<std::string_view>> levelExtensions;
+    for (auto level : {DispatchLevel::Global, DispatchLevel::Instance, DispatchLevel::Device}) {
+        std::string_view levelType = (level == DispatchLevel::Device) ? "device" : "instance";
+        auto &names = levelExtensions[level];
+        for (auto const &extension : extensions) {
+            if (extension.type != levelType)
+                continue;
+            for (auto const &it : dispatchCommands) {
+                if (it.level == level && !it.command->core &&
+                    std::find(it.command->extensions.begin(), it.command->extensions.end(),
+                              extension.name) != it.command->extensions.end()) {
+                    names.push_back(extension.name);
+                    break;
+                }
+            }
+        }
+    }
+
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_DISPATCH_TABLE_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_DISPATCH_TABLE_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+
+    outFile << "\n";
+    outFile << "#include <cstdint>\n";
+
+    outFile << usageStr;
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    // Tables
+    std::string_view const tableDocs[] = {
+        "/// Commands used without an instance, such as vkCreateInstance\n",
+        "/// Commands dispatched from a VkInstance or VkPhysicalDevice\n",
+        "/// Commands dispatched from a VkDevice, VkQueue or VkCommandBuffer\n",
+    };
+    for (auto level : {DispatchLevel::Global, DispatchLevel::Instance, DispatchLevel::Device}) {
+        outFile << "\n" << tableDocs[static_cast<int>(level)];
+        outFile << "struct " << getTableName(level) << " {\n";
+        for (auto const &it : dispatchCommands) {
+            if (it.level != level)
+                continue;
+
+            if (!it.platformDefine.empty())
+                outFile << "#ifdef " << it.platformDefine << "\n";
+            outFile << "    PFN_" << it.pfnName << " " << it.command->name << ";\n";
+            if (!it.platformDefine.empty())
+                outFile << "#endif // " << it.platformDefine << "\n";
+        }
+        outFile << "};\n";
+    }
+
+    outFile << declarationStr;
+
+    // Definitions
+    outFile << "\n#ifdef VK_DISPATCH_TABLE_CONFIG_MAIN\n";
+
+    outFile << detailStr;
+
+    for (auto level : {DispatchLevel::Global, DispatchLevel::Instance, DispatchLevel::Device}) {
+        auto const &knownExtensions = levelExtensions[level];
+
+        std::string_view getProcAddr = "getInstanceProcAddr";
+        std::string_view handle = "instance";
+        if (level == DispatchLevel::Global) {
+            outFile << "\nvoid vk_load_global_dispatch_table(VkGlobalDispatchTable *pTable,\n";
+            outFile << "                                   PFN_vkGetInstanceProcAddr "
+                       "getInstanceProcAddr) {\n";
+            outFile << "    VkInstance const instance = VK_NULL_HANDLE;\n";
+        } else if (level == DispatchLevel::Instance) {
+            outFile << "\nvoid vk_load_instance_dispatch_table(VkInstanceDispatchTable *pTable,\n";
+            outFile << "                                     PFN_vkGetInstanceProcAddr "
+                       "getInstanceProcAddr,\n";
+            outFile << "                                     VkInstance instance,\n";
+            outFile << "                                     uint32_t enabledExtensionCount,\n";
+            outFile << "                                     char const *const "
+                       "*ppEnabledExtensionNames) {\n";
+        } else {
+            getProcAddr = "getDeviceProcAddr";
+            handle = "device";
+            outFile << "\nvoid vk_load_device_dispatch_table(VkDeviceDispatchTable *pTable,\n";
+            outFile << "                                   PFN_vkGetDeviceProcAddr "
+                       "getDeviceProcAddr,\n";
+            outFile << "                                   VkDevice device,\n";
+            outFile << "                                   uint32_t enabledExtensionCount,\n";
+            outFile << "                                   char const *const "
+                       "*ppEnabledExtensionNames) {\n";
+        }
+
+        if (level != DispatchLevel::Global) {
+            outFile << "    static constexpr std::array<char const *, " << knownExtensions.size()
+                    << "> cExtensions = {\n";
+            for (auto name : knownExtensions)
+                outFile << "        \"" << name << "\",\n";
+            outFile << "    };\n";
+            outFile << "    [[maybe_unused]] auto const enabled =\n";
+            outFile << "        vk_dispatch_table_detail::getEnabledExtensions(cExtensions, "
+                       "enabledExtensionCount,\n";
+            outFile << "                                                       "
+                       "ppEnabledExtensionNames);\n";
+        }
+        outFile << "    *pTable = {};\n\n";
+
+        for (auto const &it : dispatchCommands) {
+            if (it.level != level)
+                continue;
+
+            // Loaded if core, or if any extension requiring it is enabled. Extensions of the
+            // other level can't be checked, so their commands are always loaded.
+            std::string condition;
+            if (!it.command->core) {
+                for (auto extension : it.command->extensions) {
+                    auto knownIt =
+                        std::find(knownExtensions.begin(), knownExtensions.end(), extension);
+                    if (knownIt == knownExtensions.end()) {
+                        condition.clear();
+                        break;
+                    }
+                    if (!condition.empty())
+                        condition += " || ";
+                    condition +=
+                        "enabled[" + std::to_string(knownIt - knownExtensions.begin()) + "]";
+                }
+            }
+
+            if (!it.platformDefine.empty())
+                outFile << "#ifdef " << it.platformDefine << "\n";
+            if (!condition.empty())
+                outFile << "    if (" << condition << ")\n    ";
+            outFile << "    pTable->" << it.command->name << " = reinterpret_cast<PFN_"
+                    << it.pfnName << ">(\n";
+            outFile << (condition.empty() ? "        " : "            ") << getProcAddr << "("
+                    << handle << ", \"" << it.command->name << "\"));\n";
+            if (!it.platformDefine.empty())
+                outFile << "#endif // " << it.platformDefine << "\n";
+        }
+
+        // Promoted commands fall back to the extension commands they were promoted from
+        bool first = true;
+        for (auto const &it : dispatchCommands) {
+            if (it.level != level || it.command->alias.empty())
+                continue;
+
+            // Only when the aliased command is in the same table, and not guarded separately
+            auto targetIt = std::find_if(
+                dispatchCommands.begin(), dispatchCommands.end(),
+                [&](DispatchCommand const &other) { return other.command->name == it.pfnName; });
+            if (targetIt == dispatchCommands.end() ||
+                (!targetIt->platformDefine.empty() &&
+                 targetIt->platformDefine != it.platformDefine))
+                continue;
+
+            if (first) {
+                outFile << "\n    // Promoted commands, from the extensions they were promoted "
+                           "from\n";
+                first = false;
+            }
+            if (!it.platformDefine.empty())
+                outFile << "#ifdef " << it.platformDefine << "\n";
+            outFile << "    if (pTable->" << it.pfnName << " == nullptr)\n";
+            outFile << "        pTable->" << it.pfnName << " = pTable->" << it.command->name
+                    << ";\n";
+            if (!it.platformDefine.empty())
+                outFile << "#endif // " << it.platformDefine << "\n";
+        }
+
+        outFile << "}\n";
+    }
+
+    outFile << "\n#endif // VK_DISPATCH_TABLE_CONFIG_MAIN\n";
+
+    outFile << "#endif // VK_DISPATCH_TABLE_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
@@ -0,0 +1,416 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dense_table.hpp"
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where enum and flag values need checking. The tables are all
+    constexpr, so there is nothing else to define.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains constexpr checks of whether a value
+is one defined for its Vulkan enum, or whether a set of flags only has bits
+defined for its flag bits type, using a precomputed mask for flags and a bitset
+of the dense values plus a sorted table of the rest for other enums.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_enum_validation.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+namespace vk_enum_validation_detail {
+
+/** The values defined for an enum or flag bits type.
+ *
+ * Flag bits have the union of their single bits in cMask, with the values that aren't a single
+ * bit, such as VK_CULL_MODE_NONE or VK_SHADER_STAGE_ALL, in cComposites. Other enums have a bitset
+ * of their values from 0 to below cDenseCount, which covers the core values of most, with the
+ * rest, such as those added by extensions or negative ones, in the sorted cSparseValues.
+ */
+template <typename T>
+struct VkEnumValues;
+
+/// Whether the flags only have defined bits, or are one of the composite values as a whole
+template <typename Values>
+constexpr bool isValidFlags(VkFlags flags) noexcept {
+    if ((flags & ~Values::cMask) == 0)
+        return true;
+    for (uint32_t i = 0; i < Values::cCompositeCount; ++i) {
+        if (flags == Values::cComposites[i])
+            return true;
+    }
+    return false;
+}
+
+} // namespace vk_enum_validation_detail
+)DECL";
+
+std::string_view functionStr = R"FUNC(
+/// Every single bit defined for a flag bits type, such as vk_valid_mask<VkCullModeFlagBits>
+template <typename FlagBits>
+inline constexpr VkFlags vk_valid_mask = vk_enum_validation_detail::VkEnumValues<FlagBits>::cMask;
+
+/** @brief Returns whether a value is one defined for its type
+ * @param value Value to check
+ * @return True if an enum value is one of those defined for it, or if a flag bits value only has
+ * defined bits set
+ *
+ * Only values from the core, features and extensions that aren't disabled count, regardless of
+ * whether the extension is actually enabled.
+ */
+template <typename T>
+constexpr bool vk_is_valid(T value) noexcept {
+    using Values = vk_enum_validation_detail::VkEnumValues<T>;
+
+    if constexpr (Values::cBitmask) {
+        return vk_enum_validation_detail::isValidFlags<Values>(static_cast<VkFlags>(value));
+    } else {
+        auto const raw = static_cast<int64_t>(value);
+        if (raw >= 0 && raw < Values::cDenseCount)
+            return (Values::cDenseBits[raw / 64] >> (raw % 64)) & 1;
+
+        // Lower bound of the sparse values
+        uint32_t first = 0;
+        uint32_t count = Values::cSparseCount;
+        while (count > 0) {
+            uint32_t const half = count / 2;
+            if (Values::cSparseValues[first + half] < raw) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return first < Values::cSparseCount && Values::cSparseValues[first] == raw;
+    }
+}
+
+/** @brief Returns whether a set of flags only has bits defined for its flag bits type
+ * @tparam FlagBits The flag bits type, such as VkCullModeFlagBits for VkCullModeFlags
+ * @param flags Flags to check
+ */
+template <typename FlagBits>
+constexpr bool vk_is_valid_flags(VkFlags flags) noexcept {
+    return vk_enum_validation_detail::isValidFlags<
+        vk_enum_validation_detail::VkEnumValues<FlagBits>>(flags);
+}
+
+/** @brief Returns whether every value of an array is one defined for its type
+ * @param pValues Values to check
+ * @param count Number of values
+ *
+ * Every value is checked rather than stopping at the first invalid one, so the loop has no early
+ * exit, as most data checked is expected to be valid.
+ */
+template <typename T>
+constexpr bool vk_all_valid(T const *pValues, std::size_t count) noexcept {
+    bool valid = true;
+    for (std::size_t i = 0; i < count; ++i)
+        valid &= vk_is_valid(pValues[i]);
+    return valid;
+}
+
+/** @brief Returns whether every set of flags of an array only has defined bits
+ * @tparam FlagBits The flag bits type, such as VkCullModeFlagBits for VkCullModeFlags
+ * @param pFlags Flags to check
+ * @param count Number of flags
+ */
+template <typename FlagBits>
+constexpr bool vk_all_valid_flags(VkFlags const *pFlags, std::size_t count) noexcept {
+    bool valid = true;
+    for (std::size_t i = 0; i < count; ++i)
+        valid &= vk_is_valid_flags<FlagBits>(pFlags[i]);
+    return valid;
+}
+)FUNC";
+
+// Enum values from 0 up to this go in the bitset of an enum, with any others in the sorted table
+constexpr int64_t cDenseLimit = 1024;
+
+struct ValidationData {
+    std::string_view name;
+    bool bitmask = false;
+    // Empty unless the type is only in the header for a platform
+    std::string_view platformDefine = {};
+    std::vector<int64_t> values = {};
+    // For bitmasks, the values combining several bits, with `values` having the single bits
+    std::vector<int64_t> composites = {};
+};
+
+std::string toHex(uint64_t value, int width) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::uppercase << std::setw(width) << std::setfill('0') << value;
+    return ss.str();
+}
+
+void writeEnumValues(std::ostream &out, ValidationData const &data) {
+    out << "\ntemplate <>\n";
+    out << "struct VkEnumValues<" << data.name << "> {\n";
+
+    if (data.bitmask) {
+        uint64_t mask = 0;
+        for (auto value : data.values)
+            mask |= static_cast<uint64_t>(value);
+
+        std::set<uint64_t> compositeValues;
+        for (auto value : data.composites)
+            compositeValues.insert(static_cast<uint64_t>(value));
+        std::vector<std::string> composites;
+        for (auto value : compositeValues)
+            composites.push_back(toHex(value, 8));
+
+        out << "    static constexpr bool cBitmask = true;\n";
+        out << "    static constexpr VkFlags cMask = " << toHex(mask, 8) << ";\n";
+        out << "    static constexpr uint32_t cCompositeCount = " << composites.size() << ";\n";
+        out << "    static constexpr VkFlags cComposites[] = {\n";
+        writeTableValues(out, composites, 4, "        ");
+        out << "    };\n";
+        out << "};\n";
+        return;
+    }
+
+    std::vector<std::string> denseBits;
+    std::vector<int64_t> sparseValues;
+    int64_t denseCount = 0;
+    for (auto value : data.values) {
+        if (value >= 0 && value < cDenseLimit)
+            denseCount = std::max(denseCount, value + 1);
+        else
+            sparseValues.push_back(value);
+    }
+    std::vector<uint64_t> words((denseCount + 63) / 64);
+    for (auto value : data.values) {
+        if (value >= 0 && value < cDenseLimit)
+            words[value / 64] |= uint64_t{1} << (value % 64);
+    }
+    std::sort(sparseValues.begin(), sparseValues.end());
+    sparseValues.erase(std::unique(sparseValues.begin(), sparseValues.end()), sparseValues.end());
+
+    for (auto word : words)
+        denseBits.push_back(toHex(word, 16) + "ULL");
+
+    out << "    static constexpr bool cBitmask = false;\n";
+    out << "    static constexpr int64_t cDenseCount = " << denseCount << ";\n";
+    out << "    static constexpr uint64_t cDenseBits[] = {\n";
+    writeTableValues(out, denseBits, 4, "        ");
+    out << "    };\n";
+    out << "    static constexpr uint32_t cSparseCount = " << sparseValues.size() << ";\n";
+    out << "    static constexpr int32_t cSparseValues[] = {\n";
+    writeTableValues(out, sparseValues, 6, "        ");
+    out << "    };\n";
+    out << "};\n";
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_enum_validation.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+    auto requiredTypes = getRequiredTypes(registryNode);
+
+    std::vector<ValidationData> enums;
+    for (auto *enumsNode = registryNode->first_node("enums"); enumsNode != nullptr;
+         enumsNode = enumsNode->next_sibling("enums")) {
+        auto *typeAttr = enumsNode->first_attribute("type");
+        if (typeAttr == nullptr)
+            continue;
+
+        std::string_view type = typeAttr->value();
+        if (type != "enum" && type != "bitmask")
+            continue;
+
+        std::string_view name = enumsNode->first_attribute("name")->value();
+        // Those that aren't required, such as from disabled extensions, aren't in the header
+        auto requiredIt = requiredTypes.find(name);
+        if (requiredIt == requiredTypes.end())
+            continue;
+
+        // 64-bit flag bits are just constants of VkFlags64, rather than a type to check with
+        if (auto *bitwidthAttr = enumsNode->first_attribute("bitwidth");
+            bitwidthAttr != nullptr && strcmp(bitwidthAttr->value(), "64") == 0) {
+            std::cout << "Info: Skipping " << name << ", as it is 64-bit" << std::endl;
+            continue;
+        }
+
+        ValidationData data{
+            .name = name,
+            .bitmask = (type == "bitmask"),
+        };
+        for (auto const &platform : platforms) {
+            if (platform.name == requiredIt->second)
+                data.platformDefine = platform.define;
+        }
+        for (auto const &[valueName, value] : getEnumValues(registryNode, name)) {
+            if (data.bitmask && !value.bitpos)
+                data.composites.push_back(value.value);
+            else
+                data.values.push_back(value.value);
+        }
+
+        enums.push_back(std::move(data));
+    }
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_ENUM_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_ENUM_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+    outFile << "#include <cstddef>\n";
+    outFile << "#include <cstdint>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    outFile << declarationStr;
+
+    outFile << "\nnamespace vk_enum_validation_detail {\n";
+    for (auto const &it : enums) {
+        if (!it.platformDefine.empty())
+            outFile << "\n#ifdef " << it.platformDefine;
+        writeEnumValues(outFile, it);
+        if (!it.platformDefine.empty())
+            outFile << "#endif // " << it.platformDefine << "\n";
+    }
+    outFile << "\n} // namespace vk_enum_validation_detail\n";
+
+    outFile << functionStr;
+
+    // Finish Up
+    outFile << "\n#endif // VK_ENUM_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
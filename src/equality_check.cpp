@@ -16,13 +16,17 @@
 
 #include <rapidxml-1.13/rapidxml.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "compare_members.hpp"
 #include "header_str.hpp"
 #include "parse_xml.hpp"
 
@@ -41,13 +45,28 @@ functions for a large set of the available Vulkan struct types, checking
 just the objects for equality. These do *NOT* peroform a deep comparison,
 such as any objects pointed to by `pNext` or any other pointed-to objects.
 
+When compiled as C++20, an `operator<=>` is also available for the same
+structs, ordering the same members lexicographically.
+
+A `vk_diff` function returns a bitset of which members differ between two
+structs, using the same rules as `operator==`.
+
+A `vk_hash` function returns a hash of the same members `operator==`
+compares, so structs that compare equal also hash the same.
+
 Program Arguments:
-    -h, --help  : Help Blurb
-    -i, --input : Input vk.xml file to parse. These can be found from the 
-                    KhronosGroup, often at this repo:
-                    https://github.com/KhronosGroup/Vulkan-Docs
-    -d, --dir   : Output directory
-    -o, --out   : Output file name (Default: `vk_equality_checks.hpp`)
+    -h, --help    : Help Blurb
+    -i, --input   : Input vk.xml file to parse. These can be found from the 
+                      KhronosGroup, often at this repo:
+                      https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir     : Output directory
+    -o, --out     : Output file name (Default: `vk_equality_checks.hpp`)
+    -p, --profile : Member ordering profile, as written by an instrumented
+                      header, so that the members that most often differ
+                      are compared first by `operator==`
+    --instrument  : Generates an instrumented header, where `operator==`
+                      counts which members differ, and
+                      `vk_equality_profile_write` writes the ordering profile
 )HELP";
 
 struct Member {
@@ -55,10 +74,672 @@ struct Member {
     std::string name;
 };
 
+void writeEqualityCheck(std::ostream &out, std::vector<CompareMember> const &compareMembers) {
+    // Only the trailing values are checked as a single chained return
+    std::size_t chainStart = compareMembers.size();
+    while (chainStart > 0 && compareMembers[chainStart - 1].type == CompareType::Value)
+        --chainStart;
+
+    bool isFirst = true;
+    for (std::size_t i = 0; i < compareMembers.size(); ++i) {
+        auto const &it = compareMembers[i];
+        auto const &member = *it.member;
+
+        if (it.type == CompareType::Value && i < chainStart) {
+            out << "  if(lhs." << member.name << " != rhs." << member.name << ")\n";
+            out << "    return false;\n\n";
+            continue;
+        }
+
+        switch (it.type) {
+        case CompareType::Count:
+            out << "  if(lhs." << it.count << " != rhs." << it.count << ")\n";
+            out << "    return false;\n\n";
+            break;
+
+        case CompareType::FixedArray: {
+            std::vector<char> const itName = {'i', 'j', 'k'};
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                    << member.sizeEnum[i] << "; ++" << itName[i] << ") {\n";
+            }
+
+            out << "    if(lhs." << member.name;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+
+            out << " != rhs." << member.name;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+            out << ")\n";
+            out << "      return false;\n";
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  }\n";
+            }
+            out << "\n";
+        } break;
+
+        case CompareType::ImmutableSamplers:
+            out << "  if (lhs.pImmutableSamplers != rhs.pImmutableSamplers) {\n";
+            out << "    if(lhs.pImmutableSamplers == nullptr || rhs.pImmutableSamplers == "
+                   "nullptr)\n";
+            out << "      return false;\n";
+            out << "    if(!arrayEqual(lhs.pImmutableSamplers, rhs.pImmutableSamplers, "
+                << getCountExpr(it, "lhs") << "))\n";
+            out << "      return false;\n";
+            out << "  }\n\n";
+            break;
+
+        case CompareType::String:
+            out << "  if (lhs." << member.name << " != rhs." << member.name << ") {\n";
+            out << "    if(lhs." << member.name << " == nullptr || rhs." << member.name
+                << " == nullptr)\n";
+            out << "      return false;\n";
+            out << "    if(strcmp(lhs." << member.name << ", rhs." << member.name << ") != 0)\n";
+            out << "      return false;\n";
+            out << "  }\n\n";
+            break;
+
+        case CompareType::RawData:
+            out << "  if(memcmp(lhs." << member.name << ", rhs." << member.name << ", "
+                << getCountExpr(it, "lhs") << ") != 0)\n";
+            out << "    return false;\n\n";
+            break;
+
+        case CompareType::Array:
+            out << "  if(!arrayEqual(lhs." << member.name << ", rhs." << member.name << ", "
+                << getCountExpr(it, "lhs") << "))\n";
+            out << "    return false;\n\n";
+            break;
+
+        case CompareType::Value:
+            // If it's the first, then we don't prefix with '&&'
+            if (isFirst) {
+                isFirst = false;
+                out << "  return ";
+            } else {
+                out << " &&\n         ";
+            }
+            out << "(lhs." << member.name << " == rhs." << member.name << ")";
+            break;
+        }
+    }
+    if (isFirst)
+        out << "  return true";
+
+    out << ";\n";
+}
+
+using OrderProfile = std::map<std::string, std::vector<std::string>, std::less<>>;
+
+// Reads an ordering profile, where each line is a struct name followed by its member names in
+// the order they should be compared. Lines starting with '#' are comments.
+bool readOrderProfile(std::string const &profileFile, OrderProfile &profile) {
+    std::ifstream inFile(profileFile);
+    if (!inFile.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(inFile, line)) {
+        std::istringstream lineStream(line);
+        std::string structName;
+        if (!(lineStream >> structName) || structName.starts_with('#'))
+            continue;
+
+        auto &memberOrder = profile[structName];
+        std::string memberName;
+        while (lineStream >> memberName)
+            memberOrder.emplace_back(memberName);
+    }
+
+    return true;
+}
+
+// Reorders the members to be compared so that those in the given order come first. Counts are
+// kept ahead of any arrays that use them, so arrays are never read past the end.
+std::vector<CompareMember> orderCompareMembers(std::vector<CompareMember> const &compareMembers,
+                                               std::vector<std::string> const &memberOrder) {
+    auto rank = [&](CompareMember const &compareMember) {
+        std::string_view name = compareMember.member->name;
+        if (compareMember.type == CompareType::Count)
+            name = compareMember.count;
+
+        for (std::size_t i = 0; i < memberOrder.size(); ++i) {
+            if (memberOrder[i] == name)
+                return i;
+        }
+        return memberOrder.size();
+    };
+
+    std::vector<CompareMember> sorted = compareMembers;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](auto const &lhs, auto const &rhs) { return rank(lhs) < rank(rhs); });
+
+    std::vector<CompareMember> ordered;
+    std::set<std::string_view> checkedCounts;
+    for (auto const &it : sorted) {
+        if (it.type == CompareType::Count) {
+            if (checkedCounts.insert(it.count).second)
+                ordered.push_back(it);
+            continue;
+        }
+
+        if (!it.member->len.empty() && !checkedCounts.contains(it.member->len)) {
+            for (auto const &countIt : sorted) {
+                if (countIt.type == CompareType::Count && countIt.count == it.member->len) {
+                    checkedCounts.insert(countIt.count);
+                    ordered.push_back(countIt);
+                    break;
+                }
+            }
+        }
+        ordered.push_back(it);
+    }
+
+    return ordered;
+}
+
+void writeThreeWayCompare(std::ostream &out, std::vector<CompareMember> const &compareMembers) {
+    for (auto const &it : compareMembers) {
+        auto const &member = *it.member;
+
+        switch (it.type) {
+        case CompareType::Count:
+            out << "  if(auto cmp = compareMember(lhs." << it.count << ", rhs." << it.count
+                << "); cmp != 0)\n";
+            out << "    return cmp;\n\n";
+            break;
+
+        case CompareType::FixedArray: {
+            std::vector<char> const itName = {'i', 'j', 'k'};
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                    << member.sizeEnum[i] << "; ++" << itName[i] << ") {\n";
+            }
+
+            out << "    if(auto cmp = compareMember(lhs." << member.name;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+
+            out << ", rhs." << member.name;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+            out << "); cmp != 0)\n";
+            out << "      return cmp;\n";
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  }\n";
+            }
+            out << "\n";
+        } break;
+
+        case CompareType::ImmutableSamplers:
+        case CompareType::String:
+            // Null pointers order before any data
+            out << "  if(lhs." << member.name << " != rhs." << member.name << ") {\n";
+            out << "    if(lhs." << member.name << " == nullptr)\n";
+            out << "      return std::weak_ordering::less;\n";
+            out << "    if(rhs." << member.name << " == nullptr)\n";
+            out << "      return std::weak_ordering::greater;\n";
+            if (it.type == CompareType::String) {
+                out << "    if(auto cmp = strcmp(lhs." << member.name << ", rhs." << member.name
+                    << ") <=> 0; cmp != 0)\n";
+                out << "      return cmp;\n";
+            } else {
+                out << "    for(uint32_t i = 0; i < " << getCountExpr(it, "lhs") << "; ++i) {\n";
+                out << "      if(auto cmp = compareMember(lhs." << member.name << "[i], rhs."
+                    << member.name << "[i]); cmp != 0)\n";
+                out << "        return cmp;\n";
+                out << "    }\n";
+            }
+            out << "  }\n\n";
+            break;
+
+        case CompareType::RawData:
+            out << "  if(auto cmp = memcmp(lhs." << member.name << ", rhs." << member.name << ", "
+                << getCountExpr(it, "lhs") << ") <=> 0; cmp != 0)\n";
+            out << "    return cmp;\n\n";
+            break;
+
+        case CompareType::Array:
+            out << "  for(uint32_t i = 0; i < " << getCountExpr(it, "lhs") << "; ++i) {\n";
+            out << "    if(auto cmp = compareMember(lhs." << member.name << "[i], rhs."
+                << member.name << "[i]); cmp != 0)\n";
+            out << "      return cmp;\n";
+            out << "  }\n\n";
+            break;
+
+        case CompareType::Value:
+            out << "  if(auto cmp = compareMember(lhs." << member.name << ", rhs." << member.name
+                << "); cmp != 0)\n";
+            out << "    return cmp;\n\n";
+            break;
+        }
+    }
+
+    out << "  return std::weak_ordering::equivalent;\n";
+}
+
+// Determines the structs that hold a union, which only get a vk_diff, comparing the unions by
+// their bytes
+std::set<std::string_view> getUnionStructs(std::vector<StructData> const &structs,
+                                           std::vector<UnionData> const &unions) {
+    std::set<std::string_view> unionStructs;
+    for (auto const &it : structs) {
+        if (structHasUnion(it, unions) && !it.members.empty() &&
+            it.name != "VkDeviceCreateInfo" && it.name != "VkInstanceCreateInfo")
+            unionStructs.insert(it.name);
+    }
+    return unionStructs;
+}
+
+void writeDiff(std::ostream &out,
+               StructData const &structData,
+               std::vector<CompareMember> const &compareMembers,
+               std::vector<UnionData> const &unions,
+               std::set<std::string_view> const &unionStructs) {
+    auto isUnion = [&](std::string_view type) {
+        return std::any_of(unions.begin(), unions.end(),
+                           [&](UnionData const &it) { return it.name == type; });
+    };
+    // Structs holding a union have no operator!=, only a vk_diff of their own
+    auto differs = [&](std::string_view type, std::string const &lhs, std::string const &rhs) {
+        if (unionStructs.contains(type))
+            return "vk_diff(" + lhs + ", " + rhs + ").any()";
+        return lhs + " != " + rhs;
+    };
+
+    // Bits are the index of the member within the struct
+    auto memberIndex = [&](std::string_view name) -> std::string {
+        for (std::size_t i = 0; i < structData.members.size(); ++i) {
+            if (structData.members[i].name == name)
+                return std::to_string(i);
+        }
+        return {};
+    };
+
+    out << "  std::bitset<" << structData.members.size() << "> diff;\n\n";
+
+    for (auto const &it : compareMembers) {
+        auto const &member = *it.member;
+        std::string bit = "diff[" + memberIndex(member.name) + "]";
+        if (it.type == CompareType::Count) {
+            if (auto idx = memberIndex(it.count); !idx.empty())
+                bit = "diff[" + idx + "]";
+        }
+
+        // An array whose count differs is different without looking at the contents
+        std::string countBit;
+        if (it.type != CompareType::Count && !member.len.empty()) {
+            if (auto idx = memberIndex(member.len); !idx.empty())
+                countBit = "diff[" + idx + "]";
+        }
+        if (!countBit.empty()) {
+            out << "  if(" << countBit << ")\n";
+            out << "    " << bit << " = true;\n";
+        }
+
+        // Which member of a union is in use isn't known, so all of its bytes are compared
+        if (it.type != CompareType::Count && isUnion(member.type)) {
+            if (it.type == CompareType::Array) {
+                std::string const count = getCountExpr(it, "lhs");
+                out << "  if(!" << bit << " && " << count << " != 0 && lhs." << member.name
+                    << " != rhs." << member.name << ")\n";
+                out << "    " << bit << " = lhs." << member.name << " == nullptr || rhs."
+                    << member.name << " == nullptr ||\n";
+                out << "             memcmp(lhs." << member.name << ", rhs." << member.name
+                    << ", sizeof(" << member.type << ") * " << count << ") != 0;\n\n";
+            } else if (it.type == CompareType::FixedArray) {
+                out << "  " << bit << " = (memcmp(lhs." << member.name << ", rhs." << member.name
+                    << ", sizeof(lhs." << member.name << ")) != 0);\n";
+            } else {
+                out << "  " << bit << " = (memcmp(&lhs." << member.name << ", &rhs."
+                    << member.name << ", sizeof(lhs." << member.name << ")) != 0);\n";
+            }
+            continue;
+        }
+
+        switch (it.type) {
+        case CompareType::Count:
+            out << "  " << bit << " = (lhs." << it.count << " != rhs." << it.count << ");\n\n";
+            break;
+
+        case CompareType::FixedArray: {
+            std::vector<char> const itName = {'i', 'j', 'k'};
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  for(uint32_t " << itName[i] << " = 0; !" << bit << " && " << itName[i]
+                    << " < " << member.sizeEnum[i] << "; ++" << itName[i] << ") {\n";
+            }
+
+            std::string indices;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                indices += std::string{"["} + itName[i] + "]";
+            }
+            out << "    if("
+                << differs(member.type, "lhs." + std::string{member.name} + indices,
+                           "rhs." + std::string{member.name} + indices)
+                << ")\n";
+            out << "      " << bit << " = true;\n";
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  }\n";
+            }
+            out << "\n";
+        } break;
+
+        case CompareType::ImmutableSamplers:
+            out << "  if(!" << bit << " && lhs.pImmutableSamplers != rhs.pImmutableSamplers) {\n";
+            out << "    if(lhs.pImmutableSamplers == nullptr || rhs.pImmutableSamplers == "
+                   "nullptr)\n";
+            out << "      " << bit << " = true;\n";
+            out << "    for(uint32_t i = 0; !" << bit << " && i < " << getCountExpr(it, "lhs")
+                << "; ++i) {\n";
+            out << "      if(lhs.pImmutableSamplers[i] != rhs.pImmutableSamplers[i])\n";
+            out << "        " << bit << " = true;\n";
+            out << "    }\n";
+            out << "  }\n\n";
+            break;
+
+        case CompareType::String:
+            out << "  if(lhs." << member.name << " != rhs." << member.name << ")\n";
+            out << "    " << bit << " = lhs." << member.name << " == nullptr || rhs."
+                << member.name << " == nullptr ||\n";
+            out << "             strcmp(lhs." << member.name << ", rhs." << member.name
+                << ") != 0;\n\n";
+            break;
+
+        case CompareType::RawData:
+            out << "  if(!" << bit << ")\n";
+            out << "    " << bit << " = (memcmp(lhs." << member.name << ", rhs." << member.name
+                << ", " << getCountExpr(it, "lhs") << ") != 0);\n\n";
+            break;
+
+        case CompareType::Array:
+            out << "  for(uint32_t i = 0; !" << bit << " && i < " << getCountExpr(it, "lhs")
+                << "; ++i) {\n";
+            out << "    if("
+                << differs(member.type, "lhs." + std::string{member.name} + "[i]",
+                           "rhs." + std::string{member.name} + "[i]")
+                << ")\n";
+            out << "      " << bit << " = true;\n";
+            out << "  }\n\n";
+            break;
+
+        case CompareType::Value:
+            out << "  " << bit << " = ("
+                << differs(member.type, "lhs." + std::string{member.name},
+                           "rhs." + std::string{member.name})
+                << ");\n";
+            break;
+        }
+    }
+
+    if (!compareMembers.empty() && compareMembers.back().type == CompareType::Value &&
+        !isUnion(compareMembers.back().member->type))
+        out << "\n";
+    out << "  return diff;\n";
+}
+
+void writeHash(std::ostream &out, std::vector<CompareMember> const &compareMembers) {
+    out << "  std::size_t seed = 0;\n\n";
+
+    for (auto const &it : compareMembers) {
+        auto const &member = *it.member;
+
+        switch (it.type) {
+        case CompareType::Count:
+            out << "  hashMember(seed, value." << it.count << ");\n";
+            break;
+
+        case CompareType::FixedArray: {
+            std::vector<char> const itName = {'i', 'j', 'k'};
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                    << member.sizeEnum[i] << "; ++" << itName[i] << ") {\n";
+            }
+
+            out << "    hashMember(seed, value." << member.name;
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+            out << ");\n";
+
+            for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                out << "  }\n";
+            }
+        } break;
+
+        case CompareType::ImmutableSamplers:
+            out << "  hashMember(seed, value.pImmutableSamplers == nullptr);\n";
+            out << "  if(value.pImmutableSamplers != nullptr) {\n";
+            out << "    for(uint32_t i = 0; i < " << getCountExpr(it, "value") << "; ++i)\n";
+            out << "      hashMember(seed, value.pImmutableSamplers[i]);\n";
+            out << "  }\n";
+            break;
+
+        case CompareType::String:
+            out << "  hashMember(seed, value." << member.name << " == nullptr);\n";
+            out << "  if(value." << member.name << " != nullptr)\n";
+            out << "    hashBytes(seed, value." << member.name << ", strlen(value." << member.name
+                << "));\n";
+            break;
+
+        case CompareType::RawData:
+            out << "  hashBytes(seed, value." << member.name << ", " << getCountExpr(it, "value")
+                << ");\n";
+            break;
+
+        case CompareType::Array:
+            out << "  for(uint32_t i = 0; i < " << getCountExpr(it, "value") << "; ++i)\n";
+            out << "    hashMember(seed, value." << member.name << "[i]);\n";
+            break;
+
+        case CompareType::Value:
+            out << "  hashMember(seed, value." << member.name << ");\n";
+            break;
+        }
+    }
+
+    if (!compareMembers.empty())
+        out << "\n";
+    out << "  return seed;\n";
+}
+
+void writeDiffMemberName(std::ostream &out, StructData const &structData) {
+    out << "  constexpr std::string_view names[] = {";
+    for (auto const &member : structData.members) {
+        if (&member != &structData.members.front())
+            out << ", ";
+        out << '"' << member.name << '"';
+    }
+    out << "};\n\n";
+    out << "  return (index < std::size(names)) ? names[index] : std::string_view{};\n";
+}
+
+std::string_view diffDeclStr = R"DIFF(
+/** @brief Returns the name of the struct member at the given index
+ * @param index Index of the member, as the bit position returned from `vk_diff`
+ * @return Name of the member, or an empty view if out-of-range
+ *
+ * The `vk_diff` functions return a bitset where each bit is the index of a member, in declaration
+ * order, that differs between the two given structs. Members that do not take part in the
+ * `operator==` comparison, such as `pNext`, are never set.
+ *
+ * Structs holding a union, such as `VkRenderPassBeginInfo` with its `VkClearValue` array, only
+ * have a `vk_diff`, without `operator==` or `vk_hash`. As there is no telling which member of the
+ * union is in use, unions are compared by all of their bytes, so can differ in those left unset
+ * by a smaller member.
+ */
+template <typename T>
+std::string_view vk_diff_member_name(std::size_t index) noexcept;
+)DIFF";
+
+std::string_view hashHelperStr = R"HELPER(
+namespace {
+
+void hashCombine(std::size_t &seed, std::size_t value) noexcept {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// FNV-1a, for string and raw data members that are compared by content
+void hashBytes(std::size_t &seed, void const *pData, std::size_t size) noexcept {
+  std::uint64_t hash = 14695981039346656037ull;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char const *>(pData)[i];
+    hash *= 1099511628211ull;
+  }
+  hashCombine(seed, static_cast<std::size_t>(hash));
+}
+
+template <typename T>
+void hashMember(std::size_t &seed, T const &value) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    // Positive and negative zero compare equal, so must hash the same
+    hashCombine(seed, std::hash<T>{}(value == T{} ? T{} : value));
+  } else if constexpr (std::is_pointer_v<T> && std::is_function_v<std::remove_pointer_t<T>>) {
+    hashCombine(seed, std::hash<std::uintptr_t>{}(reinterpret_cast<std::uintptr_t>(value)));
+  } else if constexpr (std::is_class_v<T>) {
+    hashCombine(seed, vk_hash(value));
+  } else {
+    hashCombine(seed, std::hash<T>{}(value));
+  }
+}
+
+} // namespace
+)HELPER";
+
+std::string_view arrayHelperStr = R"HELPER(
+namespace {
+
+// Element types whose `operator==` compares every byte of the struct, with no pointed-to data
+template <typename T>
+constexpr bool cBitwiseComparable = !std::is_class_v<T>;
+)HELPER";
+
+std::string_view arrayKernelStr = R"HELPER(
+// Compares arrays of elements in a single pass over contiguous memory where the element
+// comparison is equivalent to comparing bytes, that is, with no padding, floating-point or
+// pointed-to data, falling back to comparing element-by-element otherwise.
+template <typename T>
+bool arrayEqual(T const *pLhs, T const *pRhs, std::size_t count) noexcept {
+  if constexpr (cBitwiseComparable<std::remove_cv_t<T>> &&
+                std::has_unique_object_representations_v<std::remove_cv_t<T>>) {
+    return count == 0 || memcmp(pLhs, pRhs, sizeof(T) * count) == 0;
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      if (!(pLhs[i] == pRhs[i]))
+        return false;
+    }
+    return true;
+  }
+}
+
+} // namespace
+)HELPER";
+
+std::string_view profileDeclStr = R"PROFILE(
+#include <ostream>
+
+/** @brief Writes the member ordering profile of this instrumented header
+ * @param out Stream to write the profile to
+ *
+ * For each struct where `operator==` has found a difference, writes a line of the struct name
+ * followed by the names of the members that differed, most often first. The profile can then be
+ * given to the header generator to have those members compared first.
+ */
+void vk_equality_profile_write(std::ostream &out);
+)PROFILE";
+
+std::string_view profileHelperStr = R"PROFILE(
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+namespace {
+
+template <typename T, std::size_t N>
+std::array<std::atomic<uint64_t>, N> &mismatchCounts() noexcept {
+  static std::array<std::atomic<uint64_t>, N> counts{};
+  return counts;
+}
+
+template <typename T, std::size_t N>
+bool recordMismatches(std::bitset<N> const &diff) noexcept {
+  auto &counts = mismatchCounts<T, N>();
+  for (std::size_t i = 0; i < N; ++i) {
+    if (diff[i])
+      counts[i].fetch_add(1, std::memory_order_relaxed);
+  }
+  return diff.none();
+}
+
+template <typename T, std::size_t N>
+void writeProfile(std::ostream &out, std::string_view name) {
+  auto &counts = mismatchCounts<T, N>();
+
+  std::vector<std::size_t> order;
+  for (std::size_t i = 0; i < N; ++i) {
+    if (counts[i].load(std::memory_order_relaxed) > 0)
+      order.push_back(i);
+  }
+  if (order.empty())
+    return;
+
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+    return counts[lhs].load(std::memory_order_relaxed) >
+           counts[rhs].load(std::memory_order_relaxed);
+  });
+
+  out << name;
+  for (auto index : order)
+    out << ' ' << vk_diff_member_name<T>(index);
+  out << '\n';
+}
+
+} // namespace
+)PROFILE";
+
+std::string_view threeWayHelperStr = R"HELPER(
+namespace {
+
+template <typename T>
+std::weak_ordering compareMember(T const &lhs, T const &rhs) noexcept {
+  if constexpr (std::is_floating_point_v<T>) {
+    // Unordered values (NaN) are treated as equivalent, keeping this a weak ordering
+    if (lhs < rhs)
+      return std::weak_ordering::less;
+    if (rhs < lhs)
+      return std::weak_ordering::greater;
+    return std::weak_ordering::equivalent;
+  } else if constexpr (std::is_pointer_v<T> && std::is_function_v<std::remove_pointer_t<T>>) {
+    // Function pointers have no built-in ordering
+    return reinterpret_cast<std::uintptr_t>(lhs) <=> reinterpret_cast<std::uintptr_t>(rhs);
+  } else if constexpr (std::is_pointer_v<T>) {
+    return std::compare_three_way{}(lhs, rhs);
+  } else {
+    return lhs <=> rhs;
+  }
+}
+
+} // namespace
+)HELPER";
+
 int main(int argc, char **argv) {
     std::string inputFile;
     std::string outputDir;
     std::string outputFile = "vk_equality_checks.hpp";
+    std::string profileFile;
+    bool instrument = false;
 
     for (int i = 0; i < argc; ++i) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -76,6 +757,12 @@ int main(int argc, char **argv) {
             if (i + 1 <= argc) {
                 outputFile = argv[i + 1];
             }
+        } else if (strcmp(argv[i], "-p") == 0 || strcmp(argv[i], "--profile") == 0) {
+            if (i + 1 <= argc) {
+                profileFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "--instrument") == 0) {
+            instrument = true;
         }
     }
 
@@ -84,6 +771,12 @@ int main(int argc, char **argv) {
         return 1;
     }
 
+    OrderProfile orderProfile;
+    if (!profileFile.empty() && !readOrderProfile(profileFile, orderProfile)) {
+        std::cerr << "Error: Failed to open profile file " << profileFile << std::endl;
+        return 1;
+    }
+
     // In order to parse a file, we need to load the whole thing into memory.
     std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
     if (!inFile.is_open()) {
@@ -152,6 +845,7 @@ int main(int argc, char **argv) {
 
     auto structs = getStructData(typesNode);
     auto unions = getUnionData(typesNode);
+    auto unionStructs = getUnionStructs(structs, unions);
 
     // Extensions for type platforms
     auto *extensionsNode = registryNode->first_node("extensions");
@@ -184,190 +878,226 @@ int main(int argc, char **argv) {
     outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
             << ", \"Incompatible VK_HEADER_VERSION!\" );\n";
 
-    // Declarations
-    for (auto &it : structs) {
-        // If no members to compare, then no point
-        if (it.members.empty())
-            continue;
+    outFile << "#include <bitset>\n";
+    outFile << "#include <cstddef>\n";
+    outFile << "#include <string_view>\n";
 
-        if (it.name == "VkDeviceCreateInfo" || it.name == "VkInstanceCreateInfo")
-            continue;
+    outFile << diffDeclStr;
+    if (instrument)
+        outFile << profileDeclStr;
 
-        if (structHasUnion(it, unions))
+    // Declarations
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
             continue;
 
-        std::string_view platformDefine;
-        if (!it.platform.empty()) {
-            // Find the platform
-            for (auto &platform : platforms) {
-                if (it.platform == platform.name) {
-                    platformDefine = platform.define;
-                    break;
-                }
-            }
-
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
             outFile << "\n#ifdef " << platformDefine;
-        }
 
         outFile << "\nbool operator==(" << it.name << " const &lhs,\n";
         outFile << "                " << it.name << " const &rhs) noexcept;\n";
         outFile << "bool operator!=(" << it.name << " const &lhs,\n";
         outFile << "                " << it.name << " const &rhs) noexcept;\n";
+        std::string const diffStart =
+            "std::bitset<" + std::to_string(it.members.size()) + "> vk_diff(";
+        outFile << diffStart << it.name << " const &lhs,\n";
+        outFile << std::string(diffStart.size(), ' ') << it.name << " const &rhs) noexcept;\n";
+        outFile << "template <>\n";
+        outFile << "std::string_view vk_diff_member_name<" << it.name
+                << ">(std::size_t index) noexcept;\n";
+        outFile << "std::size_t vk_hash(" << it.name << " const &value) noexcept;\n";
 
         if (!platformDefine.empty())
             outFile << "#endif // " << platformDefine << "\n";
     }
 
+    // Structs holding a union only have a diff
+    for (auto &it : structs) {
+        if (!unionStructs.contains(it.name))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        std::string const diffStart =
+            "std::bitset<" + std::to_string(it.members.size()) + "> vk_diff(";
+        outFile << "\n" << diffStart << it.name << " const &lhs,\n";
+        outFile << std::string(diffStart.size(), ' ') << it.name << " const &rhs) noexcept;\n";
+        outFile << "template <>\n";
+        outFile << "std::string_view vk_diff_member_name<" << it.name
+                << ">(std::size_t index) noexcept;\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    // Three-way comparison declarations
+    outFile << "\n#ifdef __cpp_impl_three_way_comparison\n";
+    outFile << "\n#include <compare>\n";
+
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\nstd::weak_ordering operator<=>(" << it.name << " const &lhs,\n";
+        outFile << "                               " << it.name << " const &rhs) noexcept;\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n#endif // __cpp_impl_three_way_comparison\n";
+
     // Definitions
     outFile << "\n#ifdef VK_EQUALITY_CHECK_CONFIG_MAIN\n";
     outFile << "\n#include <cstdint>\n";
     outFile << "#include <cstring>\n";
+    outFile << "#include <functional>\n";
+    outFile << "#include <type_traits>\n";
+    outFile << hashHelperStr;
 
+    auto bitwiseStructs = getBitwiseComparableStructs(structs, unions);
+    outFile << arrayHelperStr;
     for (auto &it : structs) {
-        // If no members to compare, then no point
-        if (it.members.empty())
+        if (!bitwiseStructs.contains(it.name))
             continue;
 
-        if (it.name == "VkDeviceCreateInfo" || it.name == "VkInstanceCreateInfo")
-            continue;
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
 
-        if (structHasUnion(it, unions))
-            continue;
+        outFile << "\ntemplate <>\n";
+        outFile << "constexpr bool cBitwiseComparable<" << it.name << "> = true;\n";
 
-        std::string_view platformDefine;
-        if (!it.platform.empty()) {
-            // Find the platform
-            for (auto &platform : platforms) {
-                if (it.platform == platform.name) {
-                    platformDefine = platform.define;
-                    break;
-                }
-            }
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << arrayKernelStr;
+    if (instrument)
+        outFile << profileHelperStr;
+
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
 
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
             outFile << "\n#ifdef " << platformDefine;
-        }
 
         // == definition
         outFile << "\nbool operator==(" << it.name << " const &lhs,\n";
         outFile << "                " << it.name << " const &rhs) noexcept {\n";
-        // Len members
-        for (auto const &member : it.members) {
-            if (member.len.empty() || member.len == "null-terminated" ||
-                member.len.find("VK_UUID_SIZE") != std::string::npos ||
-                member.len.find("VK\\_UUID\\_SIZE") != std::string::npos)
-                continue;
-
-            outFile << "  if(lhs." << member.len << " != rhs." << member.len << ")\n";
-            outFile << "    return false;\n\n";
+        if (instrument) {
+            outFile << "  return recordMismatches<" << it.name << ">(vk_diff(lhs, rhs));\n";
+        } else if (auto orderIt = orderProfile.find(it.name); orderIt != orderProfile.end()) {
+            auto compareMembers = orderCompareMembers(getCompareMembers(it), orderIt->second);
+            writeEqualityCheck(outFile, compareMembers);
+        } else {
+            writeEqualityCheck(outFile, getCompareMembers(it));
         }
-        // Array members
-        for (auto const &member : it.members) {
-            if (!member.sizeEnum.empty()) {
-                std::vector<char> const itName = {'i', 'j', 'k'};
-
-                for (int i = 0; i < member.sizeEnum.size(); ++i) {
-                    outFile << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
-                            << member.sizeEnum[i] << "; ++" << itName[i] << ") {\n";
-                }
+        outFile << "}\n";
 
-                outFile << "    if(lhs." << member.name;
-                for (int i = 0; i < member.sizeEnum.size(); ++i) {
-                    outFile << "[" << itName[i] << "]";
-                }
+        // != definition
+        outFile << "\nbool operator!=(" << it.name << " const &lhs,\n";
+        outFile << "                " << it.name << " const &rhs) noexcept {\n";
+        outFile << "  return !(lhs == rhs);\n";
+        outFile << "}\n";
 
-                outFile << " != rhs." << member.name;
-                for (int i = 0; i < member.sizeEnum.size(); ++i) {
-                    outFile << "[" << itName[i] << "]";
-                }
-                outFile << ")\n";
-                outFile << "      return false;\n";
+        // Diff definitions
+        std::string const diffStart =
+            "std::bitset<" + std::to_string(it.members.size()) + "> vk_diff(";
+        outFile << "\n" << diffStart << it.name << " const &lhs,\n";
+        outFile << std::string(diffStart.size(), ' ') << it.name << " const &rhs) noexcept {\n";
+        writeDiff(outFile, it, getCompareMembers(it), unions, unionStructs);
+        outFile << "}\n";
 
-                for (int i = 0; i < member.sizeEnum.size(); ++i) {
-                    outFile << "  }\n";
-                }
-                outFile << "\n";
-            } else if (!member.len.empty()) {
-                if (member.name == "pImmutableSamplers") {
-                    outFile << "  if (lhs.pImmutableSamplers != rhs.pImmutableSamplers) {\n";
-                    outFile
-                        << "    if(lhs.pImmutableSamplers == nullptr || rhs.pImmutableSamplers == "
-                           "nullptr)\n";
-                    outFile << "      return false;\n";
-                    outFile << "    for(uint32_t i = 0; i < lhs.descriptorCount; ++i) {\n";
-                    outFile
-                        << "        if(lhs.pImmutableSamplers[i] != rhs.pImmutableSamplers[i])\n";
-                    outFile << "        return false;\n";
-                    outFile << "    }\n";
-                    outFile << "  }\n\n";
-                } else if (member.len == "null-terminated") {
-                    outFile << "  if (lhs." << member.name << " != rhs." << member.name << ") {\n";
-                    outFile << "    if(lhs." << member.name << " == nullptr || rhs." << member.name
-                            << " == nullptr)\n";
-                    outFile << "      return false;\n";
-                    outFile << "    if(strcmp(lhs." << member.name << ", rhs." << member.name
-                            << ") != 0)\n";
-                    outFile << "      return false;\n";
-                    outFile << "  }\n\n";
-                } else if (member.type == "void" && member.typeSuffix == "*") {
-                    outFile << "  if(memcmp(lhs." << member.name << ", rhs." << member.name
-                            << ", lhs." << member.altlen << ") != 0)\n";
-                    outFile << "    return false;\n\n";
-                } else {
-                    auto searchIt = member.altlen.find(member.len);
-                    std::string tempLen = member.altlen;
-                    if (member.altlen != "2*VK_UUID_SIZE") {
-                        tempLen.insert(searchIt, std::string{"lhs."});
-                    }
-                    outFile << "  for(uint32_t i = 0; i < " << tempLen << "; ++i) {\n";
-                    outFile << "    if(lhs." << member.name << "[i] != rhs." << member.name
-                            << "[i])\n";
-                    outFile << "      return false;\n";
-                    outFile << "  }\n\n";
-                }
-            }
-        }
-        // Regular members
-        bool isFirst = true;
-        for (auto const &member : it.members) {
-            // Don't do array members here
-            if (!member.sizeEnum.empty() || !member.len.empty())
-                continue;
+        outFile << "\ntemplate <>\n";
+        outFile << "std::string_view vk_diff_member_name<" << it.name
+                << ">(std::size_t index) noexcept {\n";
+        writeDiffMemberName(outFile, it);
+        outFile << "}\n";
 
-            // Don't do one if it's a member length count
-            for (auto const &inMem : it.members) {
-                if (member.name == inMem.len)
-                    goto MEMBER_END;
-            }
+        // Hash definition
+        outFile << "\nstd::size_t vk_hash(" << it.name << " const &value) noexcept {\n";
+        writeHash(outFile, getCompareMembers(it));
+        outFile << "}\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    for (auto &it : structs) {
+        if (!unionStructs.contains(it.name))
+            continue;
 
-            // Don't do 'void' pointer types
-            if (member.name == "pNext" && member.type == "void" && member.typeSuffix == "*")
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        std::string const diffStart =
+            "std::bitset<" + std::to_string(it.members.size()) + "> vk_diff(";
+        outFile << "\n" << diffStart << it.name << " const &lhs,\n";
+        outFile << std::string(diffStart.size(), ' ') << it.name << " const &rhs) noexcept {\n";
+        writeDiff(outFile, it, getCompareMembers(it), unions, unionStructs);
+        outFile << "}\n";
+
+        outFile << "\ntemplate <>\n";
+        outFile << "std::string_view vk_diff_member_name<" << it.name
+                << ">(std::size_t index) noexcept {\n";
+        writeDiffMemberName(outFile, it);
+        outFile << "}\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    if (instrument) {
+        outFile << "\nvoid vk_equality_profile_write(std::ostream &out) {\n";
+        for (auto &it : structs) {
+            if (skipStruct(it, unions))
                 continue;
 
-            // If it's the first, then we don't prefix with '&&'
-            if (isFirst) {
-                isFirst = false;
-                outFile << "  return ";
-            } else {
-                outFile << " &&\n         ";
-            }
-            outFile << "(lhs." << member.name << " == rhs." << member.name << ")";
-        MEMBER_END:;
-        }
-        if (isFirst)
-            outFile << "  return true";
+            std::string_view platformDefine = getPlatformDefine(it, platforms);
+            if (!platformDefine.empty())
+                outFile << "#ifdef " << platformDefine << "\n";
+
+            outFile << "  writeProfile<" << it.name << ", " << it.members.size() << ">(out, \""
+                    << it.name << "\");\n";
 
-        outFile << ";\n";
+            if (!platformDefine.empty())
+                outFile << "#endif // " << platformDefine << "\n";
+        }
         outFile << "}\n";
+    }
 
-        // != definition
-        outFile << "\nbool operator!=(" << it.name << " const &lhs,\n";
-        outFile << "                " << it.name << " const &rhs) noexcept {\n";
-        outFile << "  return !(lhs == rhs);\n";
+    // Three-way comparison definitions
+    outFile << "\n#ifdef __cpp_impl_three_way_comparison\n";
+    outFile << threeWayHelperStr;
+
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\nstd::weak_ordering operator<=>(" << it.name << " const &lhs,\n";
+        outFile << "                               " << it.name << " const &rhs) noexcept {\n";
+        writeThreeWayCompare(outFile, getCompareMembers(it));
         outFile << "}\n";
 
         if (!platformDefine.empty())
             outFile << "#endif // " << platformDefine << "\n";
     }
+
+    outFile << "\n#endif // __cpp_impl_three_way_comparison\n";
     outFile << "\n#endif // VK_EQUALITY_CHECK_CONFIG_MAIN\n";
 
     outFile << "\n#endif // VK_EQUALITY_CHECK_V" << vkHeaderVersion << "_HPP\n";
@@ -16,19 +16,27 @@
 
 #include <rapidxml-1.13/rapidxml.hpp>
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <string>
 #include <string_view>
+#include <vector>
 
+#include "dense_table.hpp"
 #include "header_str.hpp"
 #include "parse_xml.hpp"
 
 constexpr std::string_view helpStr = R"HELP(
 Generates header files for C++. Contains the implementation details that 
 allow the use of VkResult values with std::error_code and 
-std::error_category.
+std::error_category, along with constexpr lookups of the name and description
+of each VkResult value that never allocate, and vk_expected<T> to return either
+a value or the VkResult error without exceptions. Results checked with
+vk_check are counted per thread, and per call site for anything but VK_SUCCESS.
 
 Program Arguments:
     -h, --help  : Help Blurb
@@ -48,6 +56,505 @@ constexpr std::string_view usageStr = R"USAGE(
 */
 )USAGE";
 
+constexpr std::string_view resultInfoStr = R"INFO(
+namespace vk_error_code_detail {
+
+struct VkResultInfo {
+    VkResult result;
+    std::string_view name;
+    std::string_view description;
+};
+)INFO";
+
+constexpr std::string_view lookupStr = R"LOOKUP(
+} // namespace vk_error_code_detail
+
+/** @brief Returns the name of a VkResult value, such as "VK_ERROR_DEVICE_LOST"
+ * @param result Value to name
+ * @return The name, or an empty string for unknown values
+ *
+ * The name is taken from a static table, so this never allocates.
+ */
+constexpr std::string_view vk_result_name(VkResult result) noexcept {
+    using namespace vk_error_code_detail;
+    return cResultInfos[findResultIndex(result)].name;
+}
+
+/** @brief Returns the description of a VkResult value from the specification, such as "A fence
+ * or query has not yet completed"
+ * @param result Value to describe
+ * @return The description, or an empty string for unknown values or those without one
+ *
+ * The description is taken from a static table, so this never allocates.
+ */
+constexpr std::string_view vk_result_description(VkResult result) noexcept {
+    using namespace vk_error_code_detail;
+    return cResultInfos[findResultIndex(result)].description;
+}
+)LOOKUP";
+
+constexpr std::string_view expectedStr = R"EXPECTED(
+// Conditionally trivial special members and constexpr construction of the value need C++20
+#if defined(__cpp_concepts) && defined(__cpp_lib_constexpr_dynamic_alloc)
+
+/** @brief Either a value, or the VkResult error that prevented it
+ *
+ * Holds the raw VkResult, with the value present for any success code, being any non-negative
+ * result, such as VK_SUCCESS or VK_INCOMPLETE. Nothing else is stored, so when the value is
+ * trivially copyable the whole object is too, and can be returned in registers. A std::error_code
+ * is only made when asked for with `error()`.
+ *
+ * There are no exceptions, so accessing the value when there isn't one is undefined behaviour,
+ * the same as with std::optional.
+ */
+template <typename T>
+class vk_expected {
+  public:
+    using value_type = T;
+
+    /// Holds the value, with VK_SUCCESS
+    constexpr vk_expected(T const &value) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : mResult{VK_SUCCESS}, mValue{value} {}
+    constexpr vk_expected(T &&value) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : mResult{VK_SUCCESS}, mValue{std::move(value)} {}
+    /// Holds only the error. There's no value to go with a success code, so one is held as
+    /// VK_ERROR_UNKNOWN instead, such as from `return VK_INCOMPLETE;`
+    constexpr vk_expected(VkResult error) noexcept
+        : mResult{(error < 0) ? error : VK_ERROR_UNKNOWN} {}
+    /// Holds the value if the result is a success code, otherwise only the error
+    constexpr vk_expected(VkResult result, T value) noexcept(
+        std::is_nothrow_move_constructible_v<T>)
+        : mResult{result} {
+        if (result >= 0) [[likely]]
+            std::construct_at(&mValue, std::move(value));
+    }
+
+    constexpr vk_expected(vk_expected const &)
+        requires std::is_trivially_copy_constructible_v<T>
+    = default;
+    constexpr vk_expected(vk_expected const &other) noexcept(
+        std::is_nothrow_copy_constructible_v<T>)
+        : mResult{other.mResult} {
+        if (other.has_value())
+            std::construct_at(&mValue, other.mValue);
+    }
+    constexpr vk_expected(vk_expected &&)
+        requires std::is_trivially_move_constructible_v<T>
+    = default;
+    constexpr vk_expected(vk_expected &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : mResult{other.mResult} {
+        if (other.has_value())
+            std::construct_at(&mValue, std::move(other.mValue));
+    }
+
+    constexpr vk_expected &operator=(vk_expected const &)
+        requires std::is_trivially_copy_assignable_v<T> && std::is_trivially_destructible_v<T>
+    = default;
+    constexpr vk_expected &operator=(vk_expected const &other) {
+        if (this != &other) {
+            reset();
+            if (other.has_value())
+                std::construct_at(&mValue, other.mValue);
+            mResult = other.mResult;
+        }
+        return *this;
+    }
+    constexpr vk_expected &operator=(vk_expected &&)
+        requires std::is_trivially_move_assignable_v<T> && std::is_trivially_destructible_v<T>
+    = default;
+    constexpr vk_expected &operator=(vk_expected &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            reset();
+            if (other.has_value())
+                std::construct_at(&mValue, std::move(other.mValue));
+            mResult = other.mResult;
+        }
+        return *this;
+    }
+
+    constexpr ~vk_expected()
+        requires std::is_trivially_destructible_v<T>
+    = default;
+    constexpr ~vk_expected() { reset(); }
+
+    constexpr bool has_value() const noexcept { return mResult >= 0; }
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    /// The raw result, which is a success code whenever there is a value
+    constexpr VkResult result() const noexcept { return mResult; }
+    /// The result as a std::error_code, only made when called
+    std::error_code error() const { return make_error_code(mResult); }
+
+    constexpr T &value() & noexcept { return mValue; }
+    constexpr T const &value() const & noexcept { return mValue; }
+    constexpr T &&value() && noexcept { return std::move(mValue); }
+
+    constexpr T &operator*() & noexcept { return mValue; }
+    constexpr T const &operator*() const & noexcept { return mValue; }
+    constexpr T &&operator*() && noexcept { return std::move(mValue); }
+    constexpr T *operator->() noexcept { return &mValue; }
+    constexpr T const *operator->() const noexcept { return &mValue; }
+
+    /// Returns the value, or the given default if there is none
+    template <typename U>
+    constexpr T value_or(U &&defaultValue) const & {
+        if (has_value()) [[likely]]
+            return mValue;
+        return static_cast<T>(std::forward<U>(defaultValue));
+    }
+
+  private:
+    constexpr void reset() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            if (has_value())
+                mValue.~T();
+        }
+    }
+
+    VkResult mResult;
+    union {
+        T mValue;
+    };
+};
+
+/// Only the VkResult, for calls that don't produce a value
+template <>
+class vk_expected<void> {
+  public:
+    using value_type = void;
+
+    constexpr vk_expected() noexcept : mResult{VK_SUCCESS} {}
+    constexpr vk_expected(VkResult result) noexcept : mResult{result} {}
+
+    constexpr bool has_value() const noexcept { return mResult >= 0; }
+    constexpr explicit operator bool() const noexcept { return has_value(); }
+
+    constexpr VkResult result() const noexcept { return mResult; }
+    std::error_code error() const { return make_error_code(mResult); }
+
+  private:
+    VkResult mResult;
+};
+
+namespace vk_error_code_detail {
+
+constexpr VkResult getResult(VkResult result) noexcept { return result; }
+template <typename T>
+constexpr VkResult getResult(vk_expected<T> const &expected) noexcept {
+    return expected.result();
+}
+
+} // namespace vk_error_code_detail
+
+#ifndef VK_TRY
+/// Evaluates a VkResult or vk_expected expression, returning its VkResult from the calling
+/// function if it is an error
+#define VK_TRY(expr)                                                                               \
+    do {                                                                                           \
+        if (VkResult vkTryResult = vk_error_code_detail::getResult(expr); vkTryResult < 0)         \
+            [[unlikely]] return vkTryResult;                                                       \
+    } while (0)
+
+#define VK_TRY_CONCAT_IMPL(a, b) a##b
+#define VK_TRY_CONCAT(a, b) VK_TRY_CONCAT_IMPL(a, b)
+#define VK_TRY_ASSIGN_IMPL(tmp, lhs, expr)                                                         \
+    auto tmp = (expr);                                                                             \
+    if (!tmp.has_value())                                                                          \
+        [[unlikely]] return tmp.result();                                                          \
+    lhs = std::move(*tmp)
+
+/// Evaluates a vk_expected expression, returning its VkResult from the calling function if it is
+/// an error, otherwise assigning the value to lhs, which can be a declaration such as `auto x`
+#define VK_TRY_ASSIGN(lhs, expr)                                                                   \
+    VK_TRY_ASSIGN_IMPL(VK_TRY_CONCAT(vkTryExpected, __LINE__), lhs, expr)
+#endif
+
+#endif // __cpp_concepts && __cpp_lib_constexpr_dynamic_alloc
+)EXPECTED";
+
+constexpr std::string_view counterDeclStr = R"COUNTERS(
+// Call sites are only known from std::source_location, from C++20
+#ifdef __cpp_lib_source_location
+
+/// Number of times a VkResult has been checked
+struct VkResultCount {
+    VkResult result;
+    uint64_t count;
+};
+
+/// Number of times a VkResult has been checked at a particular place
+struct VkResultSiteCount {
+    VkResult result;
+    uint64_t count;
+    char const *file;
+    char const *function;
+    uint32_t line;
+};
+
+/// The counts of all threads, merged, including those that have since exited
+struct VkResultCounterSnapshot {
+    /// Every VkResult in vk.xml that has been checked, in order of value
+    std::vector<VkResultCount> results;
+    /// Number of checked results that aren't in vk.xml, which are only told apart by their sites
+    uint64_t unrecognizedCount;
+    /// Each place that a result other than VK_SUCCESS was checked at, in order of file and line
+    std::vector<VkResultSiteCount> sites;
+};
+
+namespace vk_error_code_detail {
+
+/// The counters of one thread, which only it writes to
+struct VkResultShard {
+    std::atomic<uint64_t> successCount{0};
+};
+
+inline thread_local VkResultShard *tpResultShard = nullptr;
+
+VkResultShard *registerResultShard() noexcept;
+void recordResult(VkResult result, std::source_location const &location) noexcept;
+
+} // namespace vk_error_code_detail
+
+/** @brief Counts a VkResult, along with where it was checked, and returns it unchanged
+ * @param result Result to count
+ * @param location Where the result is counted for, or a default-constructed location to only
+ * count the result
+ * @return The result
+ *
+ * VK_SUCCESS only increments a counter of the calling thread, without any read-modify-write or
+ * other synchronisation. Anything else does the same for a counter of its value, out of line, and
+ * is then counted per call site under a lock of the thread.
+ */
+inline VkResult vk_check(
+    VkResult result,
+    std::source_location const &location = std::source_location::current()) noexcept {
+    using namespace vk_error_code_detail;
+    if (result == VK_SUCCESS) [[likely]] {
+        VkResultShard *pShard = tpResultShard;
+        if (pShard == nullptr) [[unlikely]] {
+            pShard = registerResultShard();
+            if (pShard == nullptr)
+                return result;
+        }
+        pShard->successCount.store(pShard->successCount.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+        return result;
+    }
+
+    recordResult(result, location);
+    return result;
+}
+
+/// Returns the counts of every thread, merged
+VkResultCounterSnapshot vk_result_counter_snapshot();
+
+/// Returns the merged counts as text, with a line for each result followed by each of its sites
+std::string vk_result_counter_report();
+
+#endif // __cpp_lib_source_location
+)COUNTERS";
+
+constexpr std::string_view counterDefStr = R"COUNTERS(
+#ifdef __cpp_lib_source_location
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <tuple>
+
+namespace vk_error_code_detail {
+namespace {
+
+// File, line, function and result
+using VkResultSite = std::tuple<std::string_view, uint32_t, std::string_view, VkResult>;
+
+// A counter for each entry of cResultInfos, where the first is for values not in vk.xml
+constexpr std::size_t cResultCounterCount = sizeof(cResultInfos) / sizeof(cResultInfos[0]);
+
+struct VkResultShardData : VkResultShard {
+    // Indexed by findResultIndex, so counting a result never allocates
+    std::atomic<uint64_t> resultCounts[cResultCounterCount] = {};
+    // Only locked for results with a call site, and when taking a snapshot
+    std::mutex mutex;
+    std::map<VkResultSite, uint64_t> sites;
+};
+
+struct VkResultRegistry {
+    std::mutex mutex;
+    std::vector<VkResultShardData *> shards;
+    // The counts of threads that have exited
+    uint64_t retiredSuccessCount = 0;
+    uint64_t retiredResultCounts[cResultCounterCount] = {};
+    std::map<VkResultSite, uint64_t> retiredSites;
+};
+
+// Never destroyed, as threads may still be counting during static destruction
+VkResultRegistry &getResultRegistry() {
+    static auto *pRegistry = new VkResultRegistry;
+    return *pRegistry;
+}
+
+// Folds the counts of a thread into the retired counts when it exits
+struct VkResultShardOwner {
+    VkResultShardData *pShard = nullptr;
+
+    ~VkResultShardOwner() {
+        if (pShard == nullptr)
+            return;
+
+        auto &registry = getResultRegistry();
+        std::lock_guard lock{registry.mutex};
+        registry.retiredSuccessCount += pShard->successCount.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < cResultCounterCount; ++i)
+            registry.retiredResultCounts[i] +=
+                pShard->resultCounts[i].load(std::memory_order_relaxed);
+        for (auto const &[site, count] : pShard->sites)
+            registry.retiredSites[site] += count;
+        registry.shards.erase(std::find(registry.shards.begin(), registry.shards.end(), pShard));
+
+        tpResultShard = nullptr;
+        delete pShard;
+    }
+};
+
+thread_local VkResultShardOwner tResultShardOwner;
+
+} // namespace
+
+VkResultShard *registerResultShard() noexcept {
+    auto *pShard = new (std::nothrow) VkResultShardData;
+    if (pShard == nullptr)
+        return nullptr;
+
+    try {
+        auto &registry = getResultRegistry();
+        std::lock_guard lock{registry.mutex};
+        registry.shards.push_back(pShard);
+    } catch (...) {
+        delete pShard;
+        return nullptr;
+    }
+
+    tResultShardOwner.pShard = pShard;
+    tpResultShard = pShard;
+    return pShard;
+}
+
+// Kept out of line from vk_check, as only results other than VK_SUCCESS get here
+void recordResult(VkResult result, std::source_location const &location) noexcept {
+    VkResultShard *pShard = tpResultShard;
+    if (pShard == nullptr)
+        pShard = registerResultShard();
+    if (pShard == nullptr)
+        return;
+
+    // Only this thread writes to the counter, so it needs no read-modify-write
+    auto *pData = static_cast<VkResultShardData *>(pShard);
+    auto &count = pData->resultCounts[findResultIndex(result)];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (location.line() == 0)
+        return;
+
+    try {
+        std::lock_guard lock{pData->mutex};
+        ++pData->sites[{location.file_name(), location.line(), location.function_name(), result}];
+    } catch (...) {
+        // Counting is best-effort when out of memory
+    }
+}
+
+} // namespace vk_error_code_detail
+
+VkResultCounterSnapshot vk_result_counter_snapshot() {
+    using namespace vk_error_code_detail;
+    auto &registry = getResultRegistry();
+
+    uint64_t counts[cResultCounterCount];
+    std::map<VkResultSite, uint64_t> sites;
+    {
+        std::lock_guard lock{registry.mutex};
+        std::copy(std::begin(registry.retiredResultCounts), std::end(registry.retiredResultCounts),
+                  counts);
+        counts[findResultIndex(VK_SUCCESS)] += registry.retiredSuccessCount;
+        sites = registry.retiredSites;
+
+        for (auto *pShard : registry.shards) {
+            counts[findResultIndex(VK_SUCCESS)] +=
+                pShard->successCount.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < cResultCounterCount; ++i)
+                counts[i] += pShard->resultCounts[i].load(std::memory_order_relaxed);
+
+            std::lock_guard shardLock{pShard->mutex};
+            for (auto const &[site, count] : pShard->sites)
+                sites[site] += count;
+        }
+    }
+
+    VkResultCounterSnapshot snapshot;
+    snapshot.unrecognizedCount = counts[0];
+    for (std::size_t i = 1; i < cResultCounterCount; ++i) {
+        if (counts[i] != 0)
+            snapshot.results.push_back({cResultInfos[i].result, counts[i]});
+    }
+    std::sort(snapshot.results.begin(), snapshot.results.end(),
+              [](VkResultCount const &lhs, VkResultCount const &rhs) {
+                  return lhs.result < rhs.result;
+              });
+    for (auto const &[site, count] : sites) {
+        auto const &[file, line, function, result] = site;
+        // Both are from std::source_location, so are null-terminated
+        snapshot.sites.push_back({result, count, file.data(), function.data(), line});
+    }
+    return snapshot;
+}
+
+std::string vk_result_counter_report() {
+    VkResultCounterSnapshot const snapshot = vk_result_counter_snapshot();
+
+    std::string report;
+    auto reportSites = [&](auto const &matches) {
+        for (auto const &site : snapshot.sites) {
+            if (!matches(site.result))
+                continue;
+            report += "    ";
+            report += site.file;
+            report += ":" + std::to_string(site.line) + " (" + site.function +
+                      "): " + std::to_string(site.count);
+            if (vk_result_name(site.result).empty())
+                report += " as VkResult " + std::to_string(site.result);
+            report += "\n";
+        }
+    };
+
+    for (auto const &it : snapshot.results) {
+        report += std::string{vk_result_name(it.result)} + ": " + std::to_string(it.count) + "\n";
+        reportSites([&](VkResult result) { return result == it.result; });
+    }
+    if (snapshot.unrecognizedCount != 0) {
+        report += "(unrecognized VkResult): " + std::to_string(snapshot.unrecognizedCount) + "\n";
+        reportSites([](VkResult result) { return vk_result_name(result).empty(); });
+    }
+    return report;
+}
+
+#endif // __cpp_lib_source_location
+)COUNTERS";
+
+// Escapes a string to be placed in a C++ string literal
+std::string escapeString(std::string_view str) {
+    std::string escaped;
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
 int main(int argc, char **argv) {
     std::string inputFile;
     std::string outputDir;
@@ -127,25 +634,35 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    // Need to be in the 'registry' node
-    auto enums = getEnumData(registryNode);
-
-    // Reduce to just the 'VkResult' enum that we're interested in
-    for (auto &it : enums) {
-        if (it.name == "VkResult") {
-            enums = {it};
-            break;
-        }
-    }
-
-    // Extensions for type platforms
-    auto *extensionsNode = registryNode->first_node("extensions");
-    if (extensionsNode == nullptr) {
+    if (registryNode->first_node("extensions") == nullptr) {
         std::cerr << "Error: Could not find the 'extensions' node." << std::endl;
         return 1;
     }
 
-    getEnumExtensions(enums, extensionsNode);
+    // Values of the VkResult enumerants, from the core and all of the enabled extensions
+    auto resultValues = getEnumValues(registryNode, "VkResult");
+
+    // Each value gets two slots per magnitude, for the positive and negative value, where the slot
+    // holds the index in the table of the name and description, or 0 for none
+    DenseIndexTable resultIndices{true};
+    std::vector<std::pair<std::string_view, EnumValue>> resultInfos;
+    // In the order of their slots, positive before negative
+    std::vector<std::pair<std::string_view, EnumValue>> sortedValues{resultValues.begin(),
+                                                                     resultValues.end()};
+    auto slotOrder = [](auto const &lhs, auto const &rhs) {
+        return std::make_pair(std::abs(lhs.second.value), lhs.second.value < 0) <
+               std::make_pair(std::abs(rhs.second.value), rhs.second.value < 0);
+    };
+    std::stable_sort(sortedValues.begin(), sortedValues.end(), slotOrder);
+    for (auto const &[name, value] : sortedValues) {
+        // Aliases share the slot of the value they alias
+        uint32_t &index = resultIndices.at(value.value);
+        if (index != 0)
+            continue;
+
+        resultInfos.emplace_back(name, value);
+        index = resultInfos.size();
+    }
 
     { // Header File
         std::ofstream outFile(outputDir + outputFile);
@@ -163,7 +680,18 @@ int main(int argc, char **argv) {
         outFile << "\n#include <vulkan/vulkan.h>\n";
 
         outFile << "\n";
+        outFile << "#include <atomic>\n";
+        outFile << "#include <cstdint>\n";
+        outFile << "#include <memory>\n";
+        outFile << "#if __has_include(<source_location>)\n";
+        outFile << "#include <source_location>\n";
+        outFile << "#endif\n";
+        outFile << "#include <string>\n";
+        outFile << "#include <string_view>\n";
         outFile << "#include <system_error>\n";
+        outFile << "#include <type_traits>\n";
+        outFile << "#include <utility>\n";
+        outFile << "#include <vector>\n";
 
         outFile << usageStr;
         outFile << "\n";
@@ -182,10 +710,26 @@ struct is_error_code_enum<VkResult> : true_type {};
 std::error_code make_error_code(VkResult);
 )DECL";
 
+        // Name and description lookup tables
+        outFile << resultInfoStr;
+        outFile << "\ninline constexpr VkResultInfo const cResultInfos[] = {\n";
+        outFile << "    {VK_SUCCESS, {}, {}},\n";
+        for (auto const &[name, value] : resultInfos) {
+            outFile << "    {" << name << ", \"" << name << "\", \""
+                    << escapeString(value.comment) << "\"},\n";
+        }
+        outFile << "};\n";
+
+        resultIndices.write(outFile, {"Result", "VkResult", "cResultInfos", "result"});
+
+        outFile << lookupStr;
+        outFile << expectedStr;
+        outFile << counterDeclStr;
+
         // Definitions
         outFile << "\n#ifdef VK_ERROR_CODE_CONFIG_MAIN\n";
 
-        outFile << R"DEFSTART(
+        outFile << R"DEFS(
 namespace {
 
 struct VulkanErrCategory : std::error_category {
@@ -198,21 +742,13 @@ const char *VulkanErrCategory::name() const noexcept {
 }
 
 std::string VulkanErrCategory::message(int ev) const {
-    switch (static_cast<VkResult>(ev)) {
-)DEFSTART";
-
-        for (auto &it : enums[0].values) {
-            outFile << "    case " << it.name << ":\n";
-            outFile << "        return \"" << it.name << "\";\n";
-        }
+    if (auto name = vk_result_name(static_cast<VkResult>(ev)); !name.empty())
+        return std::string{name};
 
-        outFile << R"DEFEND(
-    default:
-        if (ev > 0)
-            return "(unrecognized positive VkResult value)";
-        else
-            return "(unrecognized negative VkResult value)";
-    }
+    if (ev > 0)
+        return "(unrecognized positive VkResult value)";
+    else
+        return "(unrecognized negative VkResult value)";
 }
 
 const VulkanErrCategory vulkanErrCategory{};
@@ -222,7 +758,10 @@ const VulkanErrCategory vulkanErrCategory{};
 std::error_code make_error_code(VkResult e) {
     return {static_cast<int>(e), vulkanErrCategory};
 }
-)DEFEND";
+)DEFS";
+
+        // Result counters
+        outFile << counterDefStr;
 
         outFile << "\n#endif // VK_ERROR_CODE_CONFIG_MAIN\n";
 
@@ -0,0 +1,417 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "dense_table.hpp"
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where the format information is required. The tables are all
+    constexpr, so there is nothing else to define.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains constexpr tables of the properties of
+each VkFormat from the <formats> section of vk.xml, being the texel block size
+and extent, the bits and numeric type of each component, the image aspects and
+the planes, looked up by indexing directly with the format value.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_format_info.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+/// A single component of a format, such as the R of VK_FORMAT_R8G8B8A8_UNORM
+struct VkFormatComponent {
+    /// One of 'R', 'G', 'B', 'A', 'D' or 'S'
+    char name;
+    /// Number of bits, or 0 for compressed formats
+    uint8_t bits;
+    VkFormatNumericType numericType;
+    /// The plane the component is in, for multi-planar formats
+    uint8_t plane;
+};
+
+/// A single plane of a multi-planar format
+struct VkFormatPlane {
+    /// How much smaller the plane is than the image in each dimension
+    uint8_t widthDivisor;
+    uint8_t heightDivisor;
+    /// The single-plane format that the plane is compatible with
+    VkFormat compatible;
+};
+
+struct VkFormatInfo {
+    VkFormat format;
+    std::string_view name;
+    /// The compatibility class, where formats of the same class can be reinterpreted as each other
+    std::string_view formatClass;
+    /// Size in bytes of a texel block, or of a single texel for uncompressed formats
+    uint16_t blockSize;
+    uint16_t texelsPerBlock;
+    /// Width, height and depth of a texel block in texels
+    uint8_t blockExtent[3];
+    /// Number of bits each texel is packed into, or 0 if the components aren't packed
+    uint8_t packed;
+    /// 420, 422 or 444 for formats with subsampled chroma, otherwise 0
+    uint16_t chroma;
+    /// The compression scheme, such as "BC" or "ASTC LDR", or empty if uncompressed
+    std::string_view compression;
+    /// The aspects of an image of the format
+    VkImageAspectFlags aspects;
+    uint8_t componentCount;
+    VkFormatComponent components[4];
+    uint8_t planeCount;
+    VkFormatPlane planes[3];
+};
+)DECL";
+
+std::string_view lookupStr = R"LOOKUP(
+/** @brief Returns the properties of a format
+ * @param format Format to look up
+ * @return Pointer to the properties, or nullptr if the format is unknown or VK_FORMAT_UNDEFINED
+ *
+ * Rather than a switch, the format value indexes directly into a table of the core values or of
+ * those of its extension, so that the lookup takes the same time for any format.
+ */
+constexpr VkFormatInfo const *vk_format_info(VkFormat format) noexcept {
+    using namespace vk_format_info_detail;
+    uint32_t const index = findFormatIndex(format);
+    return (index == 0) ? nullptr : &cFormatInfos[index];
+}
+)LOOKUP";
+
+struct FormatComponent {
+    std::string_view name;
+    // Empty for compressed formats
+    std::string_view bits;
+    std::string_view numericFormat;
+    std::string_view planeIndex;
+};
+
+struct FormatPlane {
+    std::string_view widthDivisor;
+    std::string_view heightDivisor;
+    std::string_view compatible;
+};
+
+struct FormatData {
+    std::string_view name;
+    std::string_view formatClass;
+    std::string_view blockSize;
+    std::string_view texelsPerBlock;
+    std::string blockExtent;
+    std::string_view packed;
+    std::string_view chroma;
+    std::string_view compressed;
+    std::vector<FormatComponent> components = {};
+    std::vector<FormatPlane> planes = {};
+};
+
+std::string_view getAttribute(rapidxml::xml_node<> const *node, char const *name,
+                              std::string_view defaultValue = {}) {
+    auto *attr = node->first_attribute(name);
+    return (attr != nullptr) ? std::string_view{attr->value()} : defaultValue;
+}
+
+// Returns every format of the <formats> section, in the order they are listed
+std::vector<FormatData> getFormatData(rapidxml::xml_node<> *formatsNode) {
+    std::vector<FormatData> formats;
+
+    for (auto *formatNode = formatsNode->first_node("format"); formatNode != nullptr;
+         formatNode = formatNode->next_sibling("format")) {
+        FormatData format{
+            .name = getAttribute(formatNode, "name"),
+            .formatClass = getAttribute(formatNode, "class"),
+            .blockSize = getAttribute(formatNode, "blockSize"),
+            .texelsPerBlock = getAttribute(formatNode, "texelsPerBlock"),
+            .blockExtent = std::string{getAttribute(formatNode, "blockExtent", "1,1,1")},
+            .packed = getAttribute(formatNode, "packed", "0"),
+            .chroma = getAttribute(formatNode, "chroma", "0"),
+            .compressed = getAttribute(formatNode, "compressed"),
+        };
+
+        for (auto *componentNode = formatNode->first_node("component"); componentNode != nullptr;
+             componentNode = componentNode->next_sibling("component")) {
+            std::string_view bits = getAttribute(componentNode, "bits");
+            format.components.push_back({
+                .name = getAttribute(componentNode, "name"),
+                .bits = (bits == "compressed") ? "0" : bits,
+                .numericFormat = getAttribute(componentNode, "numericFormat"),
+                .planeIndex = getAttribute(componentNode, "planeIndex", "0"),
+            });
+        }
+
+        for (auto *planeNode = formatNode->first_node("plane"); planeNode != nullptr;
+             planeNode = planeNode->next_sibling("plane")) {
+            format.planes.push_back({
+                .widthDivisor = getAttribute(planeNode, "widthDivisor"),
+                .heightDivisor = getAttribute(planeNode, "heightDivisor"),
+                .compatible = getAttribute(planeNode, "compatible"),
+            });
+        }
+
+        formats.push_back(std::move(format));
+    }
+
+    return formats;
+}
+
+std::string getAspects(FormatData const &format) {
+    std::string aspects;
+    auto addAspect = [&](std::string_view aspect) {
+        if (!aspects.empty())
+            aspects += " | ";
+        aspects += aspect;
+    };
+
+    bool depthStencil = false;
+    for (auto const &component : format.components) {
+        if (component.name == "D") {
+            addAspect("VK_IMAGE_ASPECT_DEPTH_BIT");
+            depthStencil = true;
+        } else if (component.name == "S") {
+            addAspect("VK_IMAGE_ASPECT_STENCIL_BIT");
+            depthStencil = true;
+        }
+    }
+    if (!depthStencil)
+        addAspect("VK_IMAGE_ASPECT_COLOR_BIT");
+    for (std::size_t i = 0; i < format.planes.size(); ++i)
+        addAspect("VK_IMAGE_ASPECT_PLANE_" + std::to_string(i) + "_BIT");
+
+    return aspects;
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_format_info.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Older versions of vk.xml have no <formats>, which just leaves the tables empty
+    std::vector<FormatData> formats;
+    if (auto *formatsNode = registryNode->first_node("formats"); formatsNode != nullptr)
+        formats = getFormatData(formatsNode);
+
+    auto formatValues = getEnumValues(registryNode, "VkFormat");
+
+    // Formats in the order of the table of them, each with a single value
+    std::vector<std::pair<FormatData const *, int64_t>> tableFormats;
+    std::set<std::string_view> numericFormats;
+    {
+        std::map<int64_t, std::string_view> usedValues;
+        for (auto const &it : formats) {
+            auto valueIt = formatValues.find(it.name);
+            if (valueIt == formatValues.end() || valueIt->second.value < 0) {
+                std::cout << "Info: Skipping " << it.name << ", as its value is unknown"
+                          << std::endl;
+                continue;
+            }
+            if (usedValues.contains(valueIt->second.value)) {
+                std::cout << "Info: Skipping " << it.name << ", as its value is already used by "
+                          << usedValues.at(valueIt->second.value) << std::endl;
+                continue;
+            }
+            if (it.components.size() > 4 || it.planes.size() > 3) {
+                std::cerr << "Error: " << it.name << " has more components or planes than fit"
+                          << std::endl;
+                return 1;
+            }
+
+            usedValues[valueIt->second.value] = it.name;
+            tableFormats.emplace_back(&it, valueIt->second.value);
+            for (auto const &component : it.components)
+                numericFormats.insert(component.numericFormat);
+        }
+    }
+
+    // Runtime format table, where index 0 is for unknown values
+    DenseIndexTable formatIndices;
+    for (std::size_t i = 0; i < tableFormats.size(); ++i)
+        formatIndices.at(tableFormats[i].second) = i + 1;
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_FORMAT_INFO_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_FORMAT_INFO_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+    outFile << "#include <cstdint>\n";
+    outFile << "#include <string_view>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    // Numeric types, as used by this version of vk.xml
+    outFile << "\n/// How the bits of a component are interpreted\n";
+    outFile << "enum class VkFormatNumericType : uint8_t {\n";
+    outFile << "    None,\n";
+    for (auto const &it : numericFormats)
+        outFile << "    " << it << ",\n";
+    outFile << "};\n";
+
+    outFile << declarationStr;
+
+    outFile << "\nnamespace vk_format_info_detail {\n";
+
+    outFile << "\ninline constexpr VkFormatInfo cFormatInfos[] = {\n";
+    outFile << "    {VK_FORMAT_UNDEFINED, {}, {}, 0, 0, {0, 0, 0}, 0, 0, {}, 0, 0, {}, 0, {}},\n";
+    for (auto const &[pFormat, value] : tableFormats) {
+        auto const &format = *pFormat;
+        outFile << "    {" << format.name << ", \"" << format.name << "\", \""
+                << format.formatClass << "\", " << format.blockSize << ", "
+                << format.texelsPerBlock << ", {" << format.blockExtent << "}, " << format.packed
+                << ", " << format.chroma << ", \"" << format.compressed << "\",\n";
+        outFile << "     " << getAspects(format) << ",\n";
+
+        outFile << "     " << format.components.size() << ", {";
+        for (auto const &component : format.components) {
+            if (&component != &format.components.front())
+                outFile << ", ";
+            outFile << "{'" << component.name << "', " << component.bits
+                    << ", VkFormatNumericType::" << component.numericFormat << ", "
+                    << component.planeIndex << "}";
+        }
+        outFile << "},\n";
+
+        outFile << "     " << format.planes.size() << ", {";
+        for (auto const &plane : format.planes) {
+            if (&plane != &format.planes.front())
+                outFile << ", ";
+            outFile << "{" << plane.widthDivisor << ", " << plane.heightDivisor << ", "
+                    << plane.compatible << "}";
+        }
+        outFile << "}},\n";
+    }
+    outFile << "};\n";
+
+    formatIndices.write(outFile, {"Format", "VkFormat", "cFormatInfos", "format"});
+
+    outFile << "\n} // namespace vk_format_info_detail\n";
+
+    outFile << lookupStr;
+
+    // Finish Up
+    outFile << "\n#endif // VK_FORMAT_INFO_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
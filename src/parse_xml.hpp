@@ -14,10 +14,19 @@
     limitations under the License.
 */
 
+#ifndef PARSE_XML_HPP
+#define PARSE_XML_HPP
+
 #include <rapidxml-1.13/rapidxml.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
+#include <map>
 #include <regex>
+#include <set>
 #include <sstream>
 #include <string_view>
 
@@ -55,6 +64,13 @@ struct MemberData {
     std::string altlen;
     std::string values;
     bool optional;
+    // Such as `uint32_t instanceCustomIndex : 24`, which can't have its offset taken
+    bool bitfield = false;
+    // Number of `*`, such as 2 for `const char* const* ppEnabledExtensionNames`
+    int pointerDepth = 0;
+    // Whether the spec leaves the member out of its implicit valid usage, as it's only used
+    // under conditions, such as `pViewports` with dynamic viewports
+    bool noautovalidity = false;
 };
 
 struct StructData {
@@ -64,16 +80,17 @@ struct StructData {
     bool hasUnionType;
 };
 
-std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode) {
+std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode,
+                                      std::string_view category = "struct") {
     std::vector<StructData> structs;
 
     for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
          typeNode = typeNode->next_sibling()) {
         StructData newStruct;
 
-        // Check for category='struct'
+        // Check for category='struct', or the requested category
         auto *categoryAttr = typeNode->first_attribute("category");
-        if (categoryAttr == nullptr || strcmp("struct", categoryAttr->value()) != 0) {
+        if (categoryAttr == nullptr || category != categoryAttr->value()) {
             goto END_OF_TYPE;
         }
 
@@ -89,8 +106,10 @@ std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode) {
                 temp.optional = false;
 
                 std::string sizeEnum = memberNode->value();
-                if (sizeEnum.starts_with(':'))
+                if (sizeEnum.starts_with(':')) {
+                    temp.bitfield = true;
                     sizeEnum = "";
+                }
 
                 std::regex searchRegex("[(0-9)]+");
                 auto words_begin =
@@ -113,9 +132,11 @@ std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode) {
 
                 if (auto nextNode = memberNode->first_node("type")->next_sibling();
                     nextNode != nullptr) {
-                    if (std::string_view{nextNode->value()}.find('*') != std::string::npos) {
+                    std::string_view suffix = nextNode->value();
+                    if (suffix.find('*') != std::string::npos) {
                         temp.typeSuffix = "*";
                     }
+                    temp.pointerDepth = std::count(suffix.begin(), suffix.end(), '*');
                 }
 
                 if (auto lenAttr = memberNode->first_attribute("len"); lenAttr != nullptr) {
@@ -139,6 +160,11 @@ std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode) {
                     }
                 }
 
+                if (auto *autoAttr = memberNode->first_attribute("noautovalidity");
+                    autoAttr != nullptr) {
+                    temp.noautovalidity = std::string_view{autoAttr->value()} == "true";
+                }
+
                 if (auto valuesAttr = memberNode->first_attribute("values");
                     valuesAttr != nullptr) {
                     temp.values = valuesAttr->value();
@@ -162,6 +188,41 @@ std::vector<StructData> getStructData(rapidxml::xml_node<> *typesNode) {
     return structs;
 }
 
+// Returns the category, such as 'struct', 'enum', 'bitmask' or 'handle', of every type given one.
+// Types from external headers, such as platform types, have no category and are not included.
+std::map<std::string_view, std::string_view> getTypeCategories(rapidxml::xml_node<> *typesNode) {
+    std::map<std::string_view, std::string_view> categories;
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *categoryAttr = typeNode->first_attribute("category");
+        if (categoryAttr == nullptr)
+            continue;
+
+        if (auto *nameAttr = typeNode->first_attribute("name"); nameAttr != nullptr)
+            categories[nameAttr->value()] = categoryAttr->value();
+        else if (auto *nameNode = typeNode->first_node("name"); nameNode != nullptr)
+            categories[nameNode->value()] = categoryAttr->value();
+    }
+
+    return categories;
+}
+
+// Returns the type each aliased type name refers to
+std::map<std::string_view, std::string_view> getTypeAliases(rapidxml::xml_node<> *typesNode) {
+    std::map<std::string_view, std::string_view> aliases;
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *nameAttr = typeNode->first_attribute("name");
+        auto *aliasAttr = typeNode->first_attribute("alias");
+        if (nameAttr != nullptr && aliasAttr != nullptr)
+            aliases[nameAttr->value()] = aliasAttr->value();
+    }
+
+    return aliases;
+}
+
 struct UnionData {
     std::string_view name;
     std::vector<MemberData> members;
@@ -265,6 +326,16 @@ void getStructPlatforms(std::vector<StructData> &structs, rapidxml::xml_node<> *
     }
 }
 
+// Returns the preprocessor define that guards the platform-specific struct, if any
+std::string_view getPlatformDefine(StructData const &structData,
+                                   std::vector<PlatformData> const &platforms) {
+    for (auto &platform : platforms) {
+        if (structData.platform == platform.name)
+            return platform.define;
+    }
+    return {};
+}
+
 std::vector<std::string> getVendorTags(rapidxml::xml_node<> const *tagsNode) {
     std::vector<std::string> vendors;
 
@@ -455,4 +526,437 @@ void getEnumExtensions(std::vector<EnumData> &enums, rapidxml::xml_node<> *exten
         if (extension == extensionsNode->last_node("extension"))
             break;
     }
-}
\ No newline at end of file
+}
+
+struct EnumValue {
+    int64_t value;
+    // Whether the value is a single flag bit from a `bitpos`, rather than any `value`, which for
+    // bitmasks can also be a combination of bits, such as VK_SHADER_STAGE_ALL
+    bool bitpos = false;
+    // The `comment` attribute, such as 'Command completed successfully', if it has one
+    std::string_view comment;
+};
+
+namespace detail {
+
+// Whether a comma-separated list of APIs, such as 'vulkan,vulkansc', includes Vulkan itself
+bool listsVulkan(std::string_view apis) {
+    while (!apis.empty()) {
+        auto end = apis.find(',');
+        if (apis.substr(0, end) == "vulkan")
+            return true;
+        if (end == std::string_view::npos)
+            break;
+        apis.remove_prefix(end + 1);
+    }
+    return false;
+}
+
+// Whether a node is for Vulkan itself, rather than only for other APIs such as Vulkan SC
+bool isVulkanApi(rapidxml::xml_node<> const *node) {
+    auto *apiAttr = node->first_attribute("api");
+    return apiAttr == nullptr || listsVulkan(apiAttr->value());
+}
+
+// Whether an extension is supported by Vulkan itself, rather than being disabled or only supported
+// by other APIs such as Vulkan SC
+bool isVulkanExtension(rapidxml::xml_node<> const *extension) {
+    auto *supportedAttr = extension->first_attribute("supported");
+    return supportedAttr != nullptr && listsVulkan(supportedAttr->value());
+}
+
+// Adds the value of an `<enum>` within a feature or extension `<require>` that extends the named
+// enum, where offsets are within the block of extension `extNumber` unless given their own
+void addRequiredEnumValue(std::map<std::string_view, EnumValue> &values,
+                          rapidxml::xml_node<> const *enumNode, std::string_view enumName,
+                          int64_t extNumber) {
+    auto *extendsAttr = enumNode->first_attribute("extends");
+    if (extendsAttr == nullptr || enumName != extendsAttr->value() ||
+        !isVulkanApi(enumNode->parent()) || !isVulkanApi(enumNode))
+        return;
+
+    int64_t value;
+    bool bitpos = false;
+    if (auto *valueAttr = enumNode->first_attribute("value"); valueAttr != nullptr) {
+        value = std::strtoll(valueAttr->value(), nullptr, 0);
+    } else if (auto *bitposAttr = enumNode->first_attribute("bitpos"); bitposAttr != nullptr) {
+        value = int64_t{1} << std::strtoll(bitposAttr->value(), nullptr, 10);
+        bitpos = true;
+    } else if (auto *offsetAttr = enumNode->first_attribute("offset"); offsetAttr != nullptr) {
+        if (auto *extNumberAttr = enumNode->first_attribute("extnumber"); extNumberAttr != nullptr)
+            extNumber = std::strtoll(extNumberAttr->value(), nullptr, 10);
+
+        value = 1000000000 + (extNumber - 1) * 1000 +
+                std::strtoll(offsetAttr->value(), nullptr, 10);
+        if (auto *dirAttr = enumNode->first_attribute("dir");
+            dirAttr != nullptr && strcmp(dirAttr->value(), "-") == 0)
+            value = -value;
+    } else {
+        // Aliases
+        return;
+    }
+
+    // The same enumerant can be required by both a feature and an extension
+    auto &entry = values[enumNode->first_attribute("name")->value()];
+    entry.value = value;
+    entry.bitpos = bitpos;
+    if (auto *commentAttr = enumNode->first_attribute("comment"); commentAttr != nullptr)
+        entry.comment = commentAttr->value();
+}
+
+} // namespace detail
+
+// Returns the numeric value of each non-alias enumerant of the named enum or bitmask (with bitpos
+// values turned into the bit itself), from the core definition along with those added by Vulkan
+// features and by the extensions it supports
+std::map<std::string_view, EnumValue> getEnumValues(rapidxml::xml_node<> *registryNode,
+                                                    std::string_view enumName) {
+    std::map<std::string_view, EnumValue> values;
+
+    for (auto *enumsNode = registryNode->first_node("enums"); enumsNode != nullptr;
+         enumsNode = enumsNode->next_sibling("enums")) {
+        auto *nameAttr = enumsNode->first_attribute("name");
+        if (nameAttr == nullptr || enumName != nameAttr->value())
+            continue;
+
+        for (auto *enumNode = enumsNode->first_node("enum"); enumNode != nullptr;
+             enumNode = enumNode->next_sibling("enum")) {
+            int64_t rawValue;
+            bool bitpos = false;
+            if (auto *valueAttr = enumNode->first_attribute("value"); valueAttr != nullptr) {
+                rawValue = std::strtoll(valueAttr->value(), nullptr, 0);
+            } else if (auto *bitposAttr = enumNode->first_attribute("bitpos");
+                       bitposAttr != nullptr) {
+                rawValue = int64_t{1} << std::strtoll(bitposAttr->value(), nullptr, 10);
+                bitpos = true;
+            } else {
+                // Aliases
+                continue;
+            }
+
+            auto &value = values[enumNode->first_attribute("name")->value()];
+            value.value = rawValue;
+            value.bitpos = bitpos;
+            if (auto *commentAttr = enumNode->first_attribute("comment"); commentAttr != nullptr)
+                value.comment = commentAttr->value();
+        }
+    }
+
+    for (auto *featureNode = registryNode->first_node("feature"); featureNode != nullptr;
+         featureNode = featureNode->next_sibling("feature")) {
+        if (!detail::isVulkanApi(featureNode))
+            continue;
+
+        for (auto *requireNode = featureNode->first_node("require"); requireNode != nullptr;
+             requireNode = requireNode->next_sibling("require")) {
+            for (auto *enumNode = requireNode->first_node("enum"); enumNode != nullptr;
+                 enumNode = enumNode->next_sibling("enum"))
+                detail::addRequiredEnumValue(values, enumNode, enumName, 0);
+        }
+    }
+
+    auto *extensionsNode = registryNode->first_node("extensions");
+    if (extensionsNode == nullptr)
+        return values;
+
+    for (auto *extension = extensionsNode->first_node("extension"); extension != nullptr;
+         extension = extension->next_sibling("extension")) {
+        if (!detail::isVulkanExtension(extension))
+            continue;
+
+        int64_t extNumber =
+            std::strtoll(extension->first_attribute("number")->value(), nullptr, 10);
+        for (auto *requireNode = extension->first_node("require"); requireNode != nullptr;
+             requireNode = requireNode->next_sibling("require")) {
+            for (auto *enumNode = requireNode->first_node("enum"); enumNode != nullptr;
+                 enumNode = enumNode->next_sibling("enum"))
+                detail::addRequiredEnumValue(values, enumNode, enumName, extNumber);
+        }
+    }
+
+    return values;
+}
+
+struct ExtensionData {
+    std::string_view name;
+    // 'instance' or 'device'
+    std::string_view type;
+    // Platform name, if any, matching a PlatformData
+    std::string_view platform;
+};
+
+// Returns every extension that Vulkan supports, leaving out disabled ones and those only for other
+// APIs such as Vulkan SC
+std::vector<ExtensionData> getExtensionData(rapidxml::xml_node<> *extensionsNode) {
+    std::vector<ExtensionData> extensions;
+
+    for (auto *extension = extensionsNode->first_node("extension"); extension != nullptr;
+         extension = extension->next_sibling("extension")) {
+        if (!detail::isVulkanExtension(extension))
+            continue;
+
+        ExtensionData temp;
+        temp.name = extension->first_attribute("name")->value();
+        if (auto *typeAttr = extension->first_attribute("type"); typeAttr != nullptr)
+            temp.type = typeAttr->value();
+        if (auto *platformAttr = extension->first_attribute("platform"); platformAttr != nullptr)
+            temp.platform = platformAttr->value();
+
+        extensions.push_back(temp);
+    }
+
+    return extensions;
+}
+
+struct CommandParam {
+    std::string_view type;
+    std::string_view name;
+    // The whole declaration, such as `const VkInstanceCreateInfo* pCreateInfo`
+    std::string declaration;
+};
+
+struct CommandData {
+    std::string_view name;
+    // For aliases, the command this is an alias of, with no return type or params of its own
+    std::string_view alias;
+    std::string_view returnType;
+    std::vector<CommandParam> params;
+    // Whether a core version requires the command
+    bool core = false;
+    // The extensions that require the command, other than those Vulkan doesn't support
+    std::vector<std::string_view> extensions;
+};
+
+namespace detail {
+
+// Returns the text of a node and all of its children, with whitespace runs collapsed
+std::string getNodeText(rapidxml::xml_node<> const *node) {
+    std::string text;
+    for (auto *child = node->first_node(); child != nullptr; child = child->next_sibling()) {
+        for (char c : std::string_view{child->value(), child->value_size()}) {
+            bool const space = (c == ' ' || c == '\t' || c == '\n');
+            if (!space)
+                text += c;
+            else if (!text.empty() && text.back() != ' ')
+                text += ' ';
+        }
+    }
+    while (!text.empty() && text.back() == ' ')
+        text.pop_back();
+    return text;
+}
+
+// Marks the commands required by the <require> blocks of a feature or extension
+void addCommandRequirements(std::vector<CommandData> &commands,
+                            rapidxml::xml_node<> const *parentNode, std::string_view extension) {
+    for (auto *requireNode = parentNode->first_node("require"); requireNode != nullptr;
+         requireNode = requireNode->next_sibling("require")) {
+        if (!isVulkanApi(requireNode))
+            continue;
+        for (auto *commandNode = requireNode->first_node("command"); commandNode != nullptr;
+             commandNode = commandNode->next_sibling("command")) {
+            if (!isVulkanApi(commandNode))
+                continue;
+            std::string_view name = commandNode->first_attribute("name")->value();
+            for (auto &it : commands) {
+                if (it.name != name)
+                    continue;
+                if (extension.empty())
+                    it.core = true;
+                else if (std::find(it.extensions.begin(), it.extensions.end(), extension) ==
+                         it.extensions.end())
+                    it.extensions.push_back(extension);
+            }
+        }
+    }
+}
+
+} // namespace detail
+
+// Returns every command, in the order they are defined, along with the core versions and the
+// extensions supported by Vulkan that require them
+std::vector<CommandData> getCommandData(rapidxml::xml_node<> *registryNode) {
+    std::vector<CommandData> commands;
+
+    auto *commandsNode = registryNode->first_node("commands");
+    if (commandsNode == nullptr)
+        return commands;
+
+    for (auto *commandNode = commandsNode->first_node("command"); commandNode != nullptr;
+         commandNode = commandNode->next_sibling("command")) {
+        if (!detail::isVulkanApi(commandNode))
+            continue;
+
+        CommandData temp;
+
+        if (auto *aliasAttr = commandNode->first_attribute("alias"); aliasAttr != nullptr) {
+            temp.name = commandNode->first_attribute("name")->value();
+            temp.alias = aliasAttr->value();
+            commands.push_back(temp);
+            continue;
+        }
+
+        auto *protoNode = commandNode->first_node("proto");
+        temp.name = protoNode->first_node("name")->value();
+        temp.returnType = protoNode->first_node("type")->value();
+
+        for (auto *paramNode = commandNode->first_node("param"); paramNode != nullptr;
+             paramNode = paramNode->next_sibling("param")) {
+            if (!detail::isVulkanApi(paramNode))
+                continue;
+
+            CommandParam param;
+            param.type = paramNode->first_node("type")->value();
+            param.name = paramNode->first_node("name")->value();
+            param.declaration = detail::getNodeText(paramNode);
+            temp.params.push_back(std::move(param));
+        }
+
+        commands.push_back(temp);
+    }
+
+    for (auto *featureNode = registryNode->first_node("feature"); featureNode != nullptr;
+         featureNode = featureNode->next_sibling("feature")) {
+        if (detail::isVulkanApi(featureNode))
+            detail::addCommandRequirements(commands, featureNode, {});
+    }
+
+    if (auto *extensionsNode = registryNode->first_node("extensions"); extensionsNode != nullptr) {
+        for (auto *extension = extensionsNode->first_node("extension"); extension != nullptr;
+             extension = extension->next_sibling("extension")) {
+            if (!detail::isVulkanExtension(extension))
+                continue;
+
+            detail::addCommandRequirements(commands, extension,
+                                           extension->first_attribute("name")->value());
+        }
+    }
+
+    return commands;
+}
+
+namespace detail {
+
+// Adds the name of every <type> within a node, including those within its children
+void addNestedTypes(std::vector<std::string_view> &names, rapidxml::xml_node<> const *node) {
+    for (auto *child = node->first_node(); child != nullptr; child = child->next_sibling()) {
+        if (child->type() != rapidxml::node_element || !isVulkanApi(child))
+            continue;
+        if (strcmp(child->name(), "type") == 0)
+            names.emplace_back(child->value());
+        else
+            addNestedTypes(names, child);
+    }
+}
+
+} // namespace detail
+
+// Returns the types that end up in the Vulkan header, being those required by a feature or by an
+// extension supported by Vulkan, along with everything they in turn refer to. Each is mapped to
+// the platform it is limited to, or an empty name if it is available everywhere.
+std::map<std::string_view, std::string_view> getRequiredTypes(rapidxml::xml_node<> *registryNode) {
+    // Types and commands have distinct names, so they can share the one map of what each uses
+    std::map<std::string_view, std::vector<std::string_view>> dependencies;
+
+    for (auto *typesNode = registryNode->first_node("types"); typesNode != nullptr;
+         typesNode = typesNode->next_sibling("types")) {
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+             typeNode = typeNode->next_sibling("type")) {
+            if (!detail::isVulkanApi(typeNode))
+                continue;
+
+            std::string_view name;
+            if (auto *nameAttr = typeNode->first_attribute("name"); nameAttr != nullptr)
+                name = nameAttr->value();
+            else if (auto *nameNode = typeNode->first_node("name"); nameNode != nullptr)
+                name = nameNode->value();
+            else
+                continue;
+
+            auto &uses = dependencies[name];
+            for (char const *attr : {"requires", "bitvalues", "alias"}) {
+                if (auto *usedAttr = typeNode->first_attribute(attr); usedAttr != nullptr)
+                    uses.emplace_back(usedAttr->value());
+            }
+            detail::addNestedTypes(uses, typeNode);
+        }
+    }
+
+    if (auto *commandsNode = registryNode->first_node("commands"); commandsNode != nullptr) {
+        for (auto *commandNode = commandsNode->first_node("command"); commandNode != nullptr;
+             commandNode = commandNode->next_sibling("command")) {
+            if (!detail::isVulkanApi(commandNode))
+                continue;
+
+            if (auto *aliasAttr = commandNode->first_attribute("alias"); aliasAttr != nullptr) {
+                dependencies[commandNode->first_attribute("name")->value()].emplace_back(
+                    aliasAttr->value());
+                continue;
+            }
+
+            auto *protoNode = commandNode->first_node("proto");
+            detail::addNestedTypes(dependencies[protoNode->first_node("name")->value()],
+                                   commandNode);
+        }
+    }
+
+    std::map<std::string_view, std::string_view> requiredTypes;
+    std::set<std::string_view> visited;
+    auto requireAll = [&](rapidxml::xml_node<> const *parentNode, std::string_view platform) {
+        std::vector<std::string_view> pending;
+        for (auto *requireNode = parentNode->first_node("require"); requireNode != nullptr;
+             requireNode = requireNode->next_sibling("require")) {
+            if (!detail::isVulkanApi(requireNode))
+                continue;
+            for (auto *node = requireNode->first_node(); node != nullptr;
+                 node = node->next_sibling()) {
+                if (node->type() == rapidxml::node_element && detail::isVulkanApi(node) &&
+                    (strcmp(node->name(), "type") == 0 || strcmp(node->name(), "command") == 0))
+                    pending.emplace_back(node->first_attribute("name")->value());
+            }
+        }
+
+        // Anything already reached was so by a feature or an earlier extension, which takes
+        // precedence
+        while (!pending.empty()) {
+            std::string_view name = pending.back();
+            pending.pop_back();
+            if (!visited.insert(name).second)
+                continue;
+
+            if (auto it = dependencies.find(name); it != dependencies.end()) {
+                if (!name.starts_with("vk"))
+                    requiredTypes[name] = platform;
+                pending.insert(pending.end(), it->second.begin(), it->second.end());
+            }
+        }
+    };
+
+    for (auto *featureNode = registryNode->first_node("feature"); featureNode != nullptr;
+         featureNode = featureNode->next_sibling("feature")) {
+        if (detail::isVulkanApi(featureNode))
+            requireAll(featureNode, {});
+    }
+
+    // Extensions available everywhere go first, so only what just platform extensions use is
+    // limited to a platform
+    auto *extensionsNode = registryNode->first_node("extensions");
+    for (bool platformPass : {false, true}) {
+        if (extensionsNode == nullptr)
+            break;
+        for (auto *extension = extensionsNode->first_node("extension"); extension != nullptr;
+             extension = extension->next_sibling("extension")) {
+            if (!detail::isVulkanExtension(extension))
+                continue;
+
+            auto *platformAttr = extension->first_attribute("platform");
+            if ((platformAttr != nullptr) != platformPass)
+                continue;
+            requireAll(extension, platformPass ? platformAttr->value() : std::string_view{});
+        }
+    }
+
+    return requiredTypes;
+}
+
+#endif // PARSE_XML_HPP
@@ -19,6 +19,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -45,14 +46,1082 @@ std::string_view functionDoc = R"FUNCDOC(
  *
  * This means any other pointer members, or pointer to pointer members are not cleaned up
  * and would still require manual deletion.
+ *
+ * The pointed-to data is walked without recursion, so long pNext chains can be cleaned up on
+ * threads with small stacks. Cleaning up never throws, even when out of memory, so it is safe to
+ * call from destructors.
+ */
+)FUNCDOC";
+
+std::string_view cleanupAllocatorDoc = R"FUNCDOC(
+/** @brief Cleans up a Vulkan sType-based structure of pointer data, allocated by the given
+ * callbacks
+ * @param pData Pointer to the struct to be cleaned up
+ * @param pAllocator Callbacks that all of the owned data was allocated with, or nullptr for
+ * `malloc`
+ *
+ * The same as `vk_struct_cleanup(pData)`, except that the owned data is released with
+ * `pAllocator->pfnFree`. Should the walk need more memory for a large graph, it is allocated
+ * from the same callbacks, and cleaning up carries on without it if they fail.
+ */
+)FUNCDOC";
+
+std::string_view walkDoc = R"FUNCDOC(
+/** @brief Visits every Vulkan sType-based struct reachable from a root struct
+ * @param pRoot Pointer to the struct to start from, which is visited first
+ * @param pfnVisit Called with each struct, before any of the structs it points to
+ * @param pUserData Passed through to pfnVisit
+ *
+ * Follows the same pointers as `vk_struct_cleanup`, being the pNext chain and the 'p[A-Z]'
+ * members that point to other sType-based structs, or arrays of them. Rather than recursing, the
+ * structs still to be visited are kept on an explicit stack, which long pNext chains and arrays
+ * don't build up on.
+ */
+)FUNCDOC";
+
+std::string_view arenaDecl = R"ARENADECL(
+#include <cstddef>
+
+/** @brief Bump allocator that deep-copied structs are placed into
+ *
+ * Memory is handed out from large blocks, and is only released all at once, either by `reset`,
+ * which keeps the blocks for reuse in constant time, or by destroying the arena.
+ */
+class VkStructArena {
+  public:
+    explicit VkStructArena(std::size_t blockSize = 65536) noexcept : blockSize{blockSize} {}
+    /// Blocks are allocated and freed through the given callbacks, when not null
+    explicit VkStructArena(VkAllocationCallbacks const *pAllocator,
+                           std::size_t blockSize = 65536) noexcept
+        : blockSize{blockSize} {
+        if (pAllocator != nullptr)
+            allocator = *pAllocator;
+    }
+    ~VkStructArena();
+
+    VkStructArena(VkStructArena const &) = delete;
+    VkStructArena &operator=(VkStructArena const &) = delete;
+
+    /// Returns memory of at least the given size, aligned up to alignof(std::max_align_t)
+    void *allocate(std::size_t size, std::size_t alignment) {
+        std::size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (pCurrent == nullptr || offset + size > pCurrent->size)
+            return allocateBlock(size, alignment);
+
+        used = offset + size;
+        return reinterpret_cast<std::byte *>(pCurrent + 1) + offset;
+    }
+
+    /// Releases everything allocated from the arena, keeping the blocks for reuse
+    void reset() noexcept {
+        pCurrent = nullptr;
+        used = 0;
+    }
+
+  private:
+    struct alignas(std::max_align_t) Block {
+        Block *pNext;
+        std::size_t size;
+    };
+
+    void *allocateBlock(std::size_t size, std::size_t alignment);
+
+    std::size_t blockSize;
+    VkAllocationCallbacks allocator{};
+    Block *pFirst = nullptr;
+    Block *pCurrent = nullptr;
+    std::size_t used = 0;
+};
+)ARENADECL";
+
+std::string_view deepCopyDoc = R"FUNCDOC(
+/** @brief Deep-copies a Vulkan sType-based structure into an arena
+ * @param pSrc Pointer to the struct to be copied
+ * @param arena Arena that the struct and all of its data is allocated from
+ * @return Pointer to the copied struct, or nullptr if pSrc is null or of an unknown type
+ *
+ * This function is only to be called on Vulkan structures that *have* a VkStructureType
+ * member 'sType'. The struct is copied along with its pNext chain, and with any pointer members
+ * that start with 'p[A-Z]' that point to counted arrays, null-terminated strings or other structs,
+ * recursively. Other pointer members are copied as-is.
+ *
+ * Nothing needs to be cleaned up for the copy, the whole graph is released by resetting or
+ * destroying the arena.
+ */
+)FUNCDOC";
+
+std::string_view deepSizeDoc = R"FUNCDOC(
+/** @brief Returns the number of bytes needed to clone a struct with `vk_struct_clone_into`
+ * @param pSrc Pointer to the struct to be sized
+ * @return Size in bytes, including alignment padding, or 0 if pSrc is null or of an unknown type
+ *
+ * Follows the same pointed-to data as `vk_struct_deep_copy`.
+ */
+)FUNCDOC";
+
+std::string_view cloneIntoDoc = R"FUNCDOC(
+/** @brief Deep-copies a Vulkan sType-based structure contiguously into a single buffer
+ * @param pSrc Pointer to the struct to be copied
+ * @param pBuffer Buffer of at least `vk_struct_deep_size(pSrc)` bytes, aligned to
+ * alignof(std::max_align_t), such as from `malloc`
+ * @return Pointer to the copied struct, being the start of the buffer, or nullptr if pSrc is null
+ * or of an unknown type
+ *
+ * Copies the same data as `vk_struct_deep_copy`, with everything laid out in the one buffer, so
+ * the whole graph is released by freeing the buffer.
+ */
+)FUNCDOC";
+
+std::string_view blobSizeDoc = R"FUNCDOC(
+/** @brief Returns the number of bytes needed to flatten a struct with `vk_struct_blob_write`
+ * @param pSrc Pointer to the struct to be flattened
+ * @return Size in bytes, or 0 if pSrc is null or of an unknown type
+ */
+)FUNCDOC";
+
+std::string_view blobWriteDoc = R"FUNCDOC(
+/** @brief Flattens a Vulkan sType-based structure into a relocatable blob
+ * @param pSrc Pointer to the struct to be flattened
+ * @param pBlob Buffer to write the blob to, aligned to alignof(std::max_align_t)
+ * @param blobSize Size of the buffer in bytes
+ * @return Number of bytes written, or 0 if pSrc is null or of an unknown type, or if the buffer
+ * is too small
+ *
+ * The struct is deep-copied as with `vk_struct_clone_into`, after a small header, but with every
+ * pointer within the copy stored as an offset from the pointer itself, so that the blob can be
+ * moved or mapped at any address, such as in shared memory or another process. The blob ends with
+ * a table of where each of these pointers is, in order, along with the alignment of what each
+ * points to, so that they can be fixed up and checked without needing to know the struct types.
+ *
+ * Pointers that aren't copied, such as handles, are stored as-is, and are only meaningful to the
+ * same process, or when they are handles of the same device.
+ */
+)FUNCDOC";
+
+std::string_view blobViewDoc = R"FUNCDOC(
+/** @brief Fixes up the pointers of a blob in place, returning the struct within it
+ * @param pBlob Blob written by `vk_struct_blob_write`, aligned to alignof(std::max_align_t)
+ * @param blobSize Size of the blob in bytes
+ * @return Pointer to the struct, or nullptr if the blob is invalid or from a different
+ * VK_HEADER_VERSION or pointer size
+ *
+ * Each stored offset is turned back into a pointer, after checking that each one lies within the
+ * blob, so the returned struct can be given straight to Vulkan without copying. The blob is
+ * marked as viewed, so later calls on it just return the struct. Once viewed, the blob can no
+ * longer be moved.
+ */
+)FUNCDOC";
+
+std::string_view blobDefs = R"BLOB(
+#include <algorithm>
+
+namespace {
+
+struct BlobHeader {
+    uint32_t magic;
+    uint32_t headerVersion;
+    uint32_t pointerSize;
+    uint32_t viewed;
+    uint64_t size;
+    uint64_t relocationOffset;
+    uint64_t relocationCount;
+};
+
+constexpr uint32_t cBlobMagic = 0x4253564B; // 'VKSB'
+constexpr std::size_t cBlobDataOffset =
+    (sizeof(BlobHeader) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+// Each relocation is the offset of a pointer within the blob, with the log2 of the alignment of
+// what it points to in the top bits
+constexpr unsigned cRelocationAlignShift = 56;
+constexpr uint64_t cRelocationSlotMask = (uint64_t{1} << cRelocationAlignShift) - 1;
+
+constexpr uint64_t getAlignLog2(std::size_t alignment) noexcept {
+    uint64_t log2 = 0;
+    while ((std::size_t{1} << log2) < alignment)
+        ++log2;
+    return log2;
+}
+
+// Offset of the relocation table, after the copied data
+std::size_t getRelocationOffset(std::size_t dataSize) noexcept {
+    return (cBlobDataOffset + dataSize + alignof(uint64_t) - 1) & ~(alignof(uint64_t) - 1);
+}
+
+// Records the offset of each followed pointer within the blob, while walking the copy within it
+struct RelocationWriter {
+    std::byte const *pBase;
+    uint64_t *pRelocations;
+    std::size_t count = 0;
+
+    void add(std::size_t, std::size_t) noexcept {}
+    void pointer(void const *pSlot, std::size_t alignment) noexcept {
+        pRelocations[count++] = static_cast<uint64_t>(static_cast<std::byte const *>(pSlot) -
+                                                      pBase) |
+                                (getAlignLog2(alignment) << cRelocationAlignShift);
+    }
+};
+
+} // namespace
+
+std::size_t vk_struct_blob_size(void const *pSrc) {
+    SizeCounter sizer;
+    deepSizeChain(pSrc, nullptr, sizer);
+    if (sizer.size == 0)
+        return 0;
+
+    return getRelocationOffset(sizer.size) + sizer.pointers * sizeof(uint64_t);
+}
+
+std::size_t vk_struct_blob_write(void const *pSrc, void *pBlob, std::size_t blobSize) {
+    SizeCounter sizer;
+    deepSizeChain(pSrc, nullptr, sizer);
+    if (sizer.size == 0)
+        return 0;
+
+    std::size_t const relocationOffset = getRelocationOffset(sizer.size);
+    std::size_t const size = relocationOffset + sizer.pointers * sizeof(uint64_t);
+    if (pBlob == nullptr || blobSize < size)
+        return 0;
+
+    auto *pBytes = static_cast<std::byte *>(pBlob);
+    void *pRoot = vk_struct_clone_into(pSrc, pBytes + cBlobDataOffset);
+
+    // Find each pointer within the copy, then store it relative to itself. Pointers are found
+    // depth-first, so are sorted by where they are for the table to be in order.
+    RelocationWriter writer{pBytes, reinterpret_cast<uint64_t *>(pBytes + relocationOffset)};
+    deepSizeChain(pRoot, nullptr, writer);
+    std::sort(writer.pRelocations, writer.pRelocations + writer.count,
+              [](uint64_t lhs, uint64_t rhs) {
+                  return (lhs & cRelocationSlotMask) < (rhs & cRelocationSlotMask);
+              });
+    for (std::size_t i = 0; i < writer.count; ++i) {
+        std::byte *pSlot = pBytes + (writer.pRelocations[i] & cRelocationSlotMask);
+        std::byte *pTarget;
+        std::memcpy(&pTarget, pSlot, sizeof(void *));
+        std::intptr_t const offset = pTarget - pSlot;
+        std::memcpy(pSlot, &offset, sizeof(void *));
+    }
+
+    BlobHeader header{cBlobMagic,       VK_HEADER_VERSION, sizeof(void *), 0, size,
+                      relocationOffset, writer.count};
+    std::memcpy(pBytes, &header, sizeof(BlobHeader));
+    return size;
+}
+
+void *vk_struct_blob_view(void *pBlob, std::size_t blobSize) {
+    if (pBlob == nullptr || blobSize < cBlobDataOffset)
+        return nullptr;
+
+    auto *pBytes = static_cast<std::byte *>(pBlob);
+    auto *pHeader = static_cast<BlobHeader *>(pBlob);
+    if (pHeader->magic != cBlobMagic || pHeader->headerVersion != VK_HEADER_VERSION ||
+        pHeader->pointerSize != sizeof(void *) || pHeader->size > blobSize ||
+        pHeader->relocationOffset < cBlobDataOffset ||
+        pHeader->relocationOffset % alignof(uint64_t) != 0 ||
+        pHeader->relocationOffset > pHeader->size ||
+        pHeader->relocationCount > (pHeader->size - pHeader->relocationOffset) / sizeof(uint64_t))
+        return nullptr;
+
+    if (pHeader->viewed == 0) {
+        auto const *pRelocations =
+            reinterpret_cast<uint64_t const *>(pBytes + pHeader->relocationOffset);
+        std::intptr_t const dataEnd = pHeader->relocationOffset;
+
+        // Check everything before changing anything, so an invalid blob is left untouched. Slots
+        // must be in order, so that none can be fixed up twice.
+        uint64_t previousSlot = 0;
+        for (uint64_t i = 0; i < pHeader->relocationCount; ++i) {
+            uint64_t const slot = pRelocations[i] & cRelocationSlotMask;
+            uint64_t const alignLog2 = pRelocations[i] >> cRelocationAlignShift;
+            if (slot <= previousSlot || slot < cBlobDataOffset || slot % alignof(void *) != 0 ||
+                slot + sizeof(void *) > pHeader->relocationOffset ||
+                alignLog2 > getAlignLog2(alignof(std::max_align_t)))
+                return nullptr;
+            previousSlot = slot;
+
+            // The blob is aligned to std::max_align_t, so offsets within it are as aligned as
+            // the addresses
+            std::intptr_t offset;
+            std::memcpy(&offset, pBytes + slot, sizeof(void *));
+            std::intptr_t const target = static_cast<std::intptr_t>(slot) + offset;
+            if (target < static_cast<std::intptr_t>(cBlobDataOffset) || target >= dataEnd ||
+                static_cast<uint64_t>(target) % (uint64_t{1} << alignLog2) != 0)
+                return nullptr;
+        }
+
+        for (uint64_t i = 0; i < pHeader->relocationCount; ++i) {
+            std::byte *pSlot = pBytes + (pRelocations[i] & cRelocationSlotMask);
+            std::intptr_t offset;
+            std::memcpy(&offset, pSlot, sizeof(void *));
+            std::byte *pTarget = pSlot + offset;
+            std::memcpy(pSlot, &pTarget, sizeof(void *));
+        }
+        pHeader->viewed = 1;
+    }
+
+    return pBytes + cBlobDataOffset;
+}
+)BLOB";
+
+std::string_view librarySizeDoc = R"FUNCDOC(
+/** @brief Returns the number of bytes needed for a library of structs from
+ * `vk_struct_library_write`
+ * @param ppStructs Pointers to the structs to go in the library
+ * @param count Number of structs
+ * @return Size in bytes, or 0 if any of the structs are null or of an unknown type
+ */
+)FUNCDOC";
+
+std::string_view libraryWriteDoc = R"FUNCDOC(
+/** @brief Writes many Vulkan sType-based structures into one library, each found by a key
+ * @param ppStructs Pointers to the structs to go in the library
+ * @param pKeys Key to find each struct by, such as a hash of it, which must all be different
+ * @param count Number of structs
+ * @param pLibrary Buffer to write the library to, aligned to alignof(std::max_align_t)
+ * @param librarySize Size of the buffer in bytes
+ * @return Number of bytes written, or 0 if any of the structs are null or of an unknown type, if
+ * any keys are the same, or if the buffer is too small
+ *
+ * The library is a versioned header, with the format version, VK_HEADER_VERSION and pointer size
+ * it was written with, followed by an index of the keys, sorted, and then the struct graphs, each
+ * as a relocatable blob from `vk_struct_blob_write`. It can be saved as a file as-is, to be loaded
+ * by mapping it into memory, such as with `mmap`, without any parsing.
+ */
+)FUNCDOC";
+
+std::string_view libraryCountDoc = R"FUNCDOC(
+/** @brief Returns the number of structs in a library
+ * @param pLibrary Library written by `vk_struct_library_write`, aligned to
+ * alignof(std::max_align_t)
+ * @param librarySize Size of the library in bytes
+ * @return Number of structs, or 0 if the library is invalid or from a different format version,
+ * VK_HEADER_VERSION or pointer size
+ */
+)FUNCDOC";
+
+std::string_view libraryFindDoc = R"FUNCDOC(
+/** @brief Finds the struct with the given key in a library, fixing it up in place
+ * @param pLibrary Library written by `vk_struct_library_write`, aligned to
+ * alignof(std::max_align_t), such as a file mapped into memory
+ * @param librarySize Size of the library in bytes
+ * @param key Key the struct was written with
+ * @return Pointer to the struct, or nullptr if there is no struct with the key, or if the library
+ * or the struct is invalid
+ *
+ * The key is binary searched for in the index, and the struct's pointers fixed up with
+ * `vk_struct_blob_view` the first time it is found, so only the parts of the library that are
+ * used are ever read. When the library is mapped from a file, it must be mapped as private and
+ * writable, such as with `MAP_PRIVATE` and `PROT_READ | PROT_WRITE`, so that the fixed-up
+ * pointers are never written back to the file. The same struct must not be found from multiple
+ * threads at once for the first time.
+ */
+)FUNCDOC";
+
+std::string_view libraryAtDoc = R"FUNCDOC(
+/** @brief Returns the struct at the given position in a library, fixing it up in place
+ * @param pLibrary Library written by `vk_struct_library_write`, aligned to
+ * alignof(std::max_align_t), such as a file mapped into memory
+ * @param librarySize Size of the library in bytes
+ * @param index Position of the struct, less than `vk_struct_library_count`, with the structs
+ * sorted by key
+ * @param pKey Set to the key of the struct, if not null
+ * @return Pointer to the struct, or nullptr if the index is out of range, or if the library or
+ * the struct is invalid
+ *
+ * As with `vk_struct_library_find`, for going through every struct in a library.
  */
 )FUNCDOC";
 
+std::string_view libraryDefs = R"LIBRARY(
+namespace {
+
+struct LibraryHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t headerVersion;
+    uint32_t pointerSize;
+    uint64_t count;
+    uint64_t size;
+};
+
+struct LibraryEntry {
+    uint64_t key;
+    uint64_t offset;
+    uint64_t size;
+};
+
+constexpr uint32_t cLibraryMagic = 0x4C53564B; // 'VKSL'
+/// Changed whenever the layout of the library, or of the blobs within it, changes
+constexpr uint32_t cLibraryFormatVersion = 1;
+
+std::size_t alignToBlob(std::size_t size) noexcept {
+    return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+
+// Offset of the first blob, after the index
+std::size_t getBlobsOffset(std::size_t count) noexcept {
+    return alignToBlob(sizeof(LibraryHeader) + count * sizeof(LibraryEntry));
+}
+
+// Returns the index of a valid library, otherwise null
+LibraryEntry const *getLibraryEntries(void const *pLibrary, std::size_t librarySize,
+                                      std::size_t *pCount) noexcept {
+    if (pLibrary == nullptr || librarySize < sizeof(LibraryHeader))
+        return nullptr;
+
+    auto const *pHeader = static_cast<LibraryHeader const *>(pLibrary);
+    if (pHeader->magic != cLibraryMagic || pHeader->formatVersion != cLibraryFormatVersion ||
+        pHeader->headerVersion != VK_HEADER_VERSION || pHeader->pointerSize != sizeof(void *) ||
+        pHeader->size < sizeof(LibraryHeader) || pHeader->size > librarySize ||
+        pHeader->count > (pHeader->size - sizeof(LibraryHeader)) / sizeof(LibraryEntry))
+        return nullptr;
+
+    *pCount = pHeader->count;
+    return reinterpret_cast<LibraryEntry const *>(pHeader + 1);
+}
+
+void *viewLibraryEntry(void *pLibrary, std::size_t count, LibraryEntry const &entry) noexcept {
+    auto const *pHeader = static_cast<LibraryHeader const *>(pLibrary);
+    if (entry.offset < getBlobsOffset(count) || entry.offset % alignof(std::max_align_t) != 0 ||
+        entry.offset > pHeader->size || entry.size > pHeader->size - entry.offset)
+        return nullptr;
+
+    return vk_struct_blob_view(static_cast<std::byte *>(pLibrary) + entry.offset, entry.size);
+}
+
+} // namespace
+
+std::size_t vk_struct_library_size(void const *const *ppStructs, std::size_t count) {
+    if (count > 0 && ppStructs == nullptr)
+        return 0;
+
+    std::size_t size = getBlobsOffset(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t const blobSize = vk_struct_blob_size(ppStructs[i]);
+        if (blobSize == 0)
+            return 0;
+        size += alignToBlob(blobSize);
+    }
+    return size;
+}
+
+std::size_t vk_struct_library_write(void const *const *ppStructs,
+                                    uint64_t const *pKeys,
+                                    std::size_t count,
+                                    void *pLibrary,
+                                    std::size_t librarySize) {
+    if ((count > 0 && (ppStructs == nullptr || pKeys == nullptr)) || pLibrary == nullptr)
+        return 0;
+
+    std::size_t const blobsOffset = getBlobsOffset(count);
+    if (librarySize < blobsOffset)
+        return 0;
+
+    auto *pBytes = static_cast<std::byte *>(pLibrary);
+    auto *pEntries = reinterpret_cast<LibraryEntry *>(pBytes + sizeof(LibraryHeader));
+    std::size_t offset = blobsOffset;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::size_t const blobSize =
+            vk_struct_blob_write(ppStructs[i], pBytes + offset, librarySize - offset);
+        if (blobSize == 0)
+            return 0;
+
+        pEntries[i] = {pKeys[i], offset, blobSize};
+        offset += blobSize;
+        if (librarySize - offset < alignToBlob(offset) - offset)
+            return 0;
+        std::memset(pBytes + offset, 0, alignToBlob(offset) - offset);
+        offset = alignToBlob(offset);
+    }
+
+    // Sorted by key to be binary searched, which also finds any keys that are the same
+    std::sort(pEntries, pEntries + count,
+              [](LibraryEntry const &lhs, LibraryEntry const &rhs) { return lhs.key < rhs.key; });
+    auto const duplicate = std::adjacent_find(
+        pEntries, pEntries + count,
+        [](LibraryEntry const &lhs, LibraryEntry const &rhs) { return lhs.key == rhs.key; });
+    if (duplicate != pEntries + count)
+        return 0;
+
+    std::memset(pBytes + sizeof(LibraryHeader) + count * sizeof(LibraryEntry), 0,
+                blobsOffset - sizeof(LibraryHeader) - count * sizeof(LibraryEntry));
+    LibraryHeader const header{cLibraryMagic,  cLibraryFormatVersion, VK_HEADER_VERSION,
+                               sizeof(void *), count,                 offset};
+    std::memcpy(pBytes, &header, sizeof(LibraryHeader));
+    return offset;
+}
+
+std::size_t vk_struct_library_count(void const *pLibrary, std::size_t librarySize) {
+    std::size_t count = 0;
+    getLibraryEntries(pLibrary, librarySize, &count);
+    return count;
+}
+
+void *vk_struct_library_find(void *pLibrary, std::size_t librarySize, uint64_t key) {
+    std::size_t count;
+    LibraryEntry const *pEntries = getLibraryEntries(pLibrary, librarySize, &count);
+    if (pEntries == nullptr)
+        return nullptr;
+
+    LibraryEntry const *pEntry = std::lower_bound(
+        pEntries, pEntries + count, key,
+        [](LibraryEntry const &entry, uint64_t key) { return entry.key < key; });
+    if (pEntry == pEntries + count || pEntry->key != key)
+        return nullptr;
+
+    return viewLibraryEntry(pLibrary, count, *pEntry);
+}
+
+void *vk_struct_library_at(void *pLibrary,
+                           std::size_t librarySize,
+                           std::size_t index,
+                           uint64_t *pKey) {
+    std::size_t count;
+    LibraryEntry const *pEntries = getLibraryEntries(pLibrary, librarySize, &count);
+    if (pEntries == nullptr || index >= count)
+        return nullptr;
+
+    if (pKey != nullptr)
+        *pKey = pEntries[index].key;
+    return viewLibraryEntry(pLibrary, count, pEntries[index]);
+}
+)LIBRARY";
+
+std::string_view deepCopyAllocatorDoc = R"FUNCDOC(
+/** @brief Deep-copies a Vulkan sType-based structure into a single allocation from the given
+ * callbacks
+ * @param pSrc Pointer to the struct to be copied
+ * @param pAllocator Callbacks to allocate the copy with, or nullptr for `malloc`
+ * @return Pointer to the copied struct, or nullptr if pSrc is null or of an unknown type, or if
+ * the allocation failed
+ *
+ * Copies the same data as `vk_struct_deep_copy`, sized with `vk_struct_deep_size` and laid out
+ * with `vk_struct_clone_into`, so the whole graph is released with the one
+ * `pAllocator->pfnFree`, or `free`, of the returned pointer.
+ */
+)FUNCDOC";
+
+std::string_view ownedTraitsDecl = R"OWNED(
+/// Maps each sType-based struct type that can be held by `vk_owned` to its sType
+template <typename T>
+struct VkOwnedTraits;
+)OWNED";
+
+std::string_view ownedDecl = R"OWNED(
+#include <cstdlib>
+#include <new>
+
+/** @brief Owns a Vulkan sType-based struct along with all of the data it points to
+ *
+ * A struct given to the constructor has the data of its pNext chain and 'p[A-Z]' members adopted,
+ * which when destroyed is released with `vk_struct_cleanup`, the same as it would be if called
+ * manually. That data needs to have been allocated by `malloc`, or by the given callbacks.
+ *
+ * Owners are only moved, which hands over the struct without touching any of the data it points
+ * to. Copies have to be made explicitly with `clone`, which deep-copies the graph into a single
+ * allocation with `vk_struct_deep_copy`.
+ */
+template <typename T>
+class vk_owned {
+  public:
+    /// Holds an empty struct, with only the sType set
+    vk_owned() noexcept { clear(); }
+    /// Takes ownership of the data the struct points to, allocated from the given callbacks or
+    /// `malloc` when null. The callbacks are kept by pointer, and need to outlive the owner.
+    explicit vk_owned(T const &value, VkAllocationCallbacks const *pAllocator = nullptr) noexcept
+        : value{value}, pAllocator{pAllocator} {}
+    ~vk_owned() { reset(); }
+
+    vk_owned(vk_owned const &) = delete;
+    vk_owned &operator=(vk_owned const &) = delete;
+
+    vk_owned(vk_owned &&other) noexcept
+        : value{other.value}, pBlock{other.pBlock}, pAllocator{other.pAllocator} {
+        other.clear();
+    }
+    vk_owned &operator=(vk_owned &&other) noexcept {
+        if (this != &other) {
+            reset();
+            value = other.value;
+            pBlock = other.pBlock;
+            pAllocator = other.pAllocator;
+            other.clear();
+        }
+        return *this;
+    }
+
+    /** @brief Deep-copies the struct and its data, allocated from the same callbacks
+     * @throws std::bad_alloc if the copy could not be allocated
+     */
+    vk_owned clone() const {
+        auto *pCopy = static_cast<T *>(vk_struct_deep_copy(&value, pAllocator));
+        if (pCopy == nullptr)
+            throw std::bad_alloc{};
+
+        vk_owned copy;
+        copy.value = *pCopy;
+        copy.pBlock = pCopy;
+        copy.pAllocator = pAllocator;
+        return copy;
+    }
+
+    /// Releases the owned data, leaving an empty struct
+    void reset() noexcept {
+        if (pBlock != nullptr) {
+            if (pAllocator != nullptr)
+                pAllocator->pfnFree(pAllocator->pUserData, pBlock);
+            else
+                free(pBlock);
+        } else {
+            vk_struct_cleanup(&value, pAllocator);
+        }
+        clear();
+    }
+
+    T *get() noexcept { return &value; }
+    T const *get() const noexcept { return &value; }
+    T *operator->() noexcept { return &value; }
+    T const *operator->() const noexcept { return &value; }
+    T &operator*() noexcept { return value; }
+    T const &operator*() const noexcept { return value; }
+
+  private:
+    void clear() noexcept {
+        value = T{};
+        value.sType = VkOwnedTraits<T>::sType;
+        pBlock = nullptr;
+    }
+
+    T value;
+    /// For clones, the single allocation holding everything the struct points to
+    void *pBlock = nullptr;
+    VkAllocationCallbacks const *pAllocator = nullptr;
+};
+)OWNED";
+
+std::string_view cleanupTableStr = R"TABLE(
+namespace {
+
+/// An owned pointer member of a struct, freed by `vk_struct_cleanup`
+struct VkCleanupMember {
+    /// Offset of the pointer member within the struct
+    uint16_t offset;
+    /// Offset of the uint32_t count of pointed-to structs, or cNoCount for a single one
+    uint16_t countOffset;
+    /// Size of each pointed-to struct, to step through the array
+    uint16_t elementSize;
+    /// Whether the pointed-to data is first cleaned up itself
+    bool recurse;
+};
+
+constexpr uint16_t cNoCount = UINT16_MAX;
+
+/// The range of owned pointer members for one struct type
+struct VkCleanupMembers {
+    VkCleanupMember const *pBegin;
+    VkCleanupMember const *pEnd;
+};
+
+/// A pending step of a walk
+struct VkWalkItem {
+    enum Action : uint8_t {
+        /// Visit a struct that isn't owned on its own, such as the root
+        Visit,
+        /// Visit an owned struct, releasing it once its members have been read
+        VisitOwned,
+        /// Visit each of an array of structs in turn, which is released by a separate step
+        VisitArray,
+        /// Release owned data, after the structs within it have been visited
+        Release,
+    };
+
+    void const *pData;
+    Action action;
+    uint16_t elementSize = 0;
+    uint32_t count = 0;
+};
+
+/// Stack of pending walk steps, kept inline until it outgrows that, then allocated from the
+/// given callbacks, or `malloc` when null
+class VkWalkStack {
+  public:
+    explicit VkWalkStack(VkAllocationCallbacks const *pAllocator) noexcept
+        : pAllocator{pAllocator} {}
+    ~VkWalkStack() { release(pItems); }
+
+    VkWalkStack(VkWalkStack const &) = delete;
+    VkWalkStack &operator=(VkWalkStack const &) = delete;
+
+    bool empty() const noexcept { return count == 0; }
+
+    /// Returns false, with nothing pushed, if the stack couldn't grow
+    bool push(VkWalkItem item) noexcept {
+        if (count == capacity && !grow())
+            return false;
+        pItems[count++] = item;
+        return true;
+    }
+
+    VkWalkItem pop() noexcept { return pItems[--count]; }
+
+  private:
+    bool grow() noexcept {
+        std::size_t const size = 2 * capacity * sizeof(VkWalkItem);
+        void *pNew = (pAllocator != nullptr)
+                         ? pAllocator->pfnAllocation(pAllocator->pUserData, size,
+                                                     alignof(VkWalkItem),
+                                                     VK_SYSTEM_ALLOCATION_SCOPE_COMMAND)
+                         : malloc(size);
+        if (pNew == nullptr)
+            return false;
+
+        std::memcpy(pNew, pItems, count * sizeof(VkWalkItem));
+        release(pItems);
+        pItems = static_cast<VkWalkItem *>(pNew);
+        capacity *= 2;
+        return true;
+    }
+
+    void release(VkWalkItem *pOld) noexcept {
+        if (pOld == inlineItems)
+            return;
+        if (pAllocator != nullptr)
+            pAllocator->pfnFree(pAllocator->pUserData, pOld);
+        else
+            free(pOld);
+    }
+
+    VkAllocationCallbacks const *pAllocator;
+    VkWalkItem inlineItems[32];
+    VkWalkItem *pItems = inlineItems;
+    std::size_t count = 0;
+    std::size_t capacity = 32;
+};
+
+)TABLE";
+
+std::string_view walkerStr = R"WALKER(
+// Walks every struct reachable through the owned pointers in the tables, each visited before
+// anything it points to. Owned data is released as soon as nothing more needs reading from it,
+// being straight away for data without structs to walk, once its members are read for a single
+// struct, and after every element has been walked for an array. Rather than recursing, the
+// pending steps are kept on an explicit stack, which pNext chains and arrays don't build up on.
+//
+// Walking never fails. Should the stack not be able to grow, such as when the allocation callbacks
+// are out of memory, the step is walked right away by a nested walk with its own inline stack
+// instead.
+template <typename Visit, typename Release>
+void walkStructs(VkWalkItem root,
+                 VkAllocationCallbacks const *pAllocator,
+                 Visit &visit,
+                 Release &release) {
+    struct VkTempStruct {
+        VkStructureType sType;
+    };
+
+    VkWalkStack stack{pAllocator};
+    stack.push(root);
+    auto schedule = [&](VkWalkItem item) {
+        if (!stack.push(item))
+            walkStructs(item, pAllocator, visit, release);
+    };
+
+    while (!stack.empty()) {
+        VkWalkItem item = stack.pop();
+        if (item.action == VkWalkItem::Release) {
+            release(item.pData);
+            continue;
+        }
+        if (item.action == VkWalkItem::VisitArray && item.count > 1) {
+            schedule({static_cast<std::byte const *>(item.pData) + item.elementSize,
+                      VkWalkItem::VisitArray, item.elementSize, item.count - 1});
+        }
+
+        visit(item.pData);
+
+        VkCleanupMembers members =
+            getCleanupMembers(static_cast<VkTempStruct const *>(item.pData)->sType);
+        auto const *pBytes = static_cast<std::byte const *>(item.pData);
+
+        // Pushed in reverse, so that members are walked in their declared order
+        for (auto const *pMember = members.pEnd; pMember != members.pBegin;) {
+            --pMember;
+            void const *pOwned;
+            std::memcpy(&pOwned, pBytes + pMember->offset, sizeof(void const *));
+            if (pOwned == nullptr)
+                continue;
+
+            if (!pMember->recurse) {
+                release(pOwned);
+            } else if (pMember->countOffset == cNoCount) {
+                schedule({pOwned, VkWalkItem::VisitOwned});
+            } else {
+                uint32_t count;
+                std::memcpy(&count, pBytes + pMember->countOffset, sizeof(uint32_t));
+                VkWalkItem const elements{pOwned, VkWalkItem::VisitArray,
+                                          pMember->elementSize, count};
+                if (stack.push({pOwned, VkWalkItem::Release})) {
+                    if (count > 0)
+                        schedule(elements);
+                } else {
+                    if (count > 0)
+                        walkStructs(elements, pAllocator, visit, release);
+                    release(pOwned);
+                }
+            }
+        }
+
+        if (item.action == VkWalkItem::VisitOwned)
+            release(item.pData);
+    }
+}
+)WALKER";
+
+std::string_view cleanupInterpreterStr = R"INTERPRETER(
+void vk_struct_cleanup(void const *pData) noexcept {
+    if (pData == nullptr)
+        return;
+
+    auto visit = [](void const *) {};
+    auto release = [](void const *pOwned) { free(const_cast<void *>(pOwned)); };
+    walkStructs({pData, VkWalkItem::Visit}, nullptr, visit, release);
+}
+
+void vk_struct_cleanup(void const *pData, VkAllocationCallbacks const *pAllocator) noexcept {
+    if (pAllocator == nullptr)
+        return vk_struct_cleanup(pData);
+    if (pData == nullptr)
+        return;
+
+    auto visit = [](void const *) {};
+    auto release = [pAllocator](void const *pOwned) {
+        pAllocator->pfnFree(pAllocator->pUserData, const_cast<void *>(pOwned));
+    };
+    walkStructs({pData, VkWalkItem::Visit}, pAllocator, visit, release);
+}
+
+void vk_struct_walk(void const *pRoot,
+                    void (*pfnVisit)(void const *pStruct, void *pUserData),
+                    void *pUserData) {
+    if (pRoot == nullptr)
+        return;
+
+    auto visit = [&](void const *pStruct) { pfnVisit(pStruct, pUserData); };
+    auto release = [](void const *) {};
+    walkStructs({pRoot, VkWalkItem::Visit}, nullptr, visit, release);
+}
+)INTERPRETER";
+
+std::string_view deepCopyHelpers = R"HELPERS(
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+VkStructArena::~VkStructArena() {
+    while (pFirst != nullptr) {
+        Block *pNext = pFirst->pNext;
+        if (allocator.pfnFree != nullptr)
+            allocator.pfnFree(allocator.pUserData, pFirst);
+        else
+            ::operator delete(pFirst);
+        pFirst = pNext;
+    }
+}
+
+void *VkStructArena::allocateBlock(std::size_t size, std::size_t alignment) {
+    // Reuse the next retained block if large enough, otherwise insert a new one
+    Block *pNext = (pCurrent == nullptr) ? pFirst : pCurrent->pNext;
+    if (pNext == nullptr || size + alignment > pNext->size) {
+        std::size_t const newSize = (size + alignment > blockSize) ? size + alignment : blockSize;
+        Block *pNew;
+        if (allocator.pfnAllocation != nullptr) {
+            pNew = static_cast<Block *>(
+                allocator.pfnAllocation(allocator.pUserData, sizeof(Block) + newSize,
+                                        alignof(Block), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+            if (pNew == nullptr)
+                throw std::bad_alloc{};
+        } else {
+            pNew = static_cast<Block *>(::operator new(sizeof(Block) + newSize));
+        }
+        pNew->pNext = pNext;
+        pNew->size = newSize;
+        if (pCurrent == nullptr)
+            pFirst = pNew;
+        else
+            pCurrent->pNext = pNew;
+        pNext = pNew;
+    }
+
+    pCurrent = pNext;
+    used = 0;
+    return allocate(size, alignment);
+}
+
+namespace {
+
+// Bump allocation within a caller-provided buffer already known to be large enough
+class BufferArena {
+  public:
+    explicit BufferArena(void *pBuffer) noexcept : pData{static_cast<std::byte *>(pBuffer)} {}
+
+    void *allocate(std::size_t size, std::size_t alignment) noexcept {
+        used = (used + alignment - 1) & ~(alignment - 1);
+        void *pAllocation = pData + used;
+        used += size;
+        return pAllocation;
+    }
+
+  private:
+    std::byte *pData;
+    std::size_t used = 0;
+};
+
+// Counts the bytes of the same allocations as a BufferArena, including alignment padding, and
+// the number of pointers followed to them
+struct SizeCounter {
+    std::size_t size = 0;
+    std::size_t pointers = 0;
+
+    void add(std::size_t bytes, std::size_t alignment) noexcept {
+        size = (size + alignment - 1) & ~(alignment - 1);
+        size += bytes;
+    }
+
+    void pointer(void const *, std::size_t) noexcept { ++pointers; }
+};
+
+template <typename Arena, typename T>
+std::remove_const_t<T> *deepCopyArray(Arena &arena, T *pSrc, std::size_t count) {
+    if (pSrc == nullptr)
+        return nullptr;
+    auto *pDst = static_cast<std::remove_const_t<T> *>(
+        arena.allocate(sizeof(T) * (count > 0 ? count : 1), alignof(T)));
+    std::memcpy(pDst, pSrc, sizeof(T) * count);
+    return pDst;
+}
+
+template <typename Arena>
+void *deepCopyBytes(Arena &arena, void const *pSrc, std::size_t size) {
+    if (pSrc == nullptr)
+        return nullptr;
+    void *pDst = arena.allocate(size > 0 ? size : 1, alignof(std::max_align_t));
+    std::memcpy(pDst, pSrc, size);
+    return pDst;
+}
+
+template <typename Arena>
+char const *deepCopyString(Arena &arena, char const *pSrc) {
+    if (pSrc == nullptr)
+        return nullptr;
+    return deepCopyArray(arena, pSrc, strlen(pSrc) + 1);
+}
+
+// The sizing functions must match the allocations of the copying functions above exactly. Each
+// takes the pointer by reference, so the sizer is also given where every followed pointer is.
+template <typename Sizer, typename T>
+void deepSizeArray(Sizer &sizer, T *const &pSrc, std::size_t count) noexcept {
+    if (pSrc != nullptr) {
+        sizer.pointer(&pSrc, alignof(T));
+        sizer.add(sizeof(T) * (count > 0 ? count : 1), alignof(T));
+    }
+}
+
+template <typename Sizer, typename T>
+void deepSizeBytes(Sizer &sizer, T *const &pSrc, std::size_t size) noexcept {
+    if (pSrc != nullptr) {
+        sizer.pointer(&pSrc, alignof(std::max_align_t));
+        sizer.add(size > 0 ? size : 1, alignof(std::max_align_t));
+    }
+}
+
+template <typename Sizer, typename T>
+void deepSizeString(Sizer &sizer, T *const &pSrc) noexcept {
+    if (pSrc != nullptr) {
+        sizer.pointer(&pSrc, alignof(char));
+        sizer.add(strlen(pSrc) + 1, alignof(char));
+    }
+}
+
+template <typename Arena>
+void *deepCopyChain(void const *pSrc, Arena &arena);
+template <typename Sizer>
+void deepSizeChain(void const *pSrc, void const *pSlot, Sizer &sizer);
+)HELPERS";
+
+std::string_view chainHelpers = R"HELPERS(
+// A struct is deep-copied along with its pNext chain, which is followed in a loop rather than
+// recursively, so that long chains don't use up the stack
+template <typename T, typename Arena>
+void deepCopyWithChain(T &value, Arena &arena) {
+    deepCopy(value, arena);
+    value.pNext = static_cast<decltype(value.pNext)>(deepCopyChain(value.pNext, arena));
+}
+
+template <typename T, typename Sizer>
+void deepSizeWithChain(T const &value, Sizer &sizer) {
+    deepSize(value, sizer);
+    deepSizeChain(value.pNext, &value.pNext, sizer);
+}
+
+void const *getNextLink(void const *pLink) noexcept {
+    void const *pNext;
+    std::memcpy(&pNext, static_cast<std::byte const *>(pLink) + offsetof(VkBaseInStructure, pNext),
+                sizeof(void const *));
+    return pNext;
+}
+
+void setNextLink(void *pLink, void *pNext) noexcept {
+    std::memcpy(static_cast<std::byte *>(pLink) + offsetof(VkBaseOutStructure, pNext), &pNext,
+                sizeof(void *));
+}
+)HELPERS";
+
+std::string_view chainLoops = R"HELPERS(
+template <typename Arena>
+void *deepCopyChain(void const *pSrc, Arena &arena) {
+    void *pFirst = nullptr;
+    void *pLast = nullptr;
+    // The chain is cut at the first struct of an unknown type
+    for (void const *pLink = pSrc; pLink != nullptr; pLink = getNextLink(pLink)) {
+        void *pCopy = deepCopyLink(pLink, arena);
+        if (pCopy == nullptr)
+            break;
+
+        if (pLast == nullptr)
+            pFirst = pCopy;
+        else
+            setNextLink(pLast, pCopy);
+        pLast = pCopy;
+    }
+
+    if (pLast != nullptr)
+        setNextLink(pLast, nullptr);
+    return pFirst;
+}
+
+// The pointer to each link, at pSlot, is only followed by the copy if the link is of a known type
+template <typename Sizer>
+void deepSizeChain(void const *pSrc, void const *pSlot, Sizer &sizer) {
+    for (void const *pLink = pSrc; pLink != nullptr; pLink = getNextLink(pLink)) {
+        if (!deepSizeLink(pLink, sizer))
+            break;
+
+        if (pSlot != nullptr)
+            sizer.pointer(pSlot, alignof(VkBaseInStructure));
+        pSlot = static_cast<std::byte const *>(pLink) + offsetof(VkBaseInStructure, pNext);
+    }
+}
+)HELPERS";
+
 constexpr std::string_view helpStr = R"HELP(
 Generates header files for C++. The functions deal are used to cleanup any
 data that the struct points to externally, recusrively. This assumes that the
 struct is the *owner* of said data.
 
+Also generates functions to deep-copy the same structs, and any of the data
+that they point to, into an arena, that is all released at once.
+
 Program Arguments:
     -h, --help  : Help Blurb
     -i, --input : Input vk.xml file to parse. These can be found from the 
@@ -85,6 +1154,248 @@ bool nonOwnedMember(MemberData const &memberData) {
     return false;
 }
 
+// Structs that are never cleaned up, despite their pointer members
+bool skipCleanup(StructData const &structData) {
+    return structData.name == "VkBaseOutStructure" || structData.name == "VkBaseInStructure" ||
+           structData.name == "VkCuLaunchInfoNVX";
+}
+
+StructData const *findStruct(std::vector<StructData> const &structs, std::string_view name) {
+    for (auto const &it : structs) {
+        if (it.name == name)
+            return &it;
+    }
+    return nullptr;
+}
+
+bool hasPNext(StructData const &structData) {
+    for (auto const &mem : structData.members) {
+        if (mem.name == "pNext")
+            return true;
+    }
+    return false;
+}
+
+// Splits a 'len' attribute, such as 'enabledLayerCount,null-terminated', into its parts
+std::vector<std::string> splitLen(std::string const &len) {
+    std::vector<std::string> parts;
+    std::istringstream lenStream(len);
+    std::string part;
+    while (std::getline(lenStream, part, ','))
+        parts.emplace_back(part);
+    return parts;
+}
+
+// Returns the element count expression of a counted member, accessed through the given variable
+std::string getLenExpr(StructData const &structData,
+                       MemberData const &memberData,
+                       std::string_view structVar) {
+    std::string countName = splitLen(memberData.len)[0];
+    std::string countExpr = splitLen(memberData.altlen)[0];
+
+    // Only refer to the struct when the count is one of its members, rather than a constant
+    std::string_view countMember = countName;
+    countMember = countMember.substr(0, countMember.find("->"));
+    for (auto const &mem : structData.members) {
+        if (mem.name == countMember) {
+            if (auto pos = countExpr.find(countName); pos != std::string::npos)
+                countExpr.insert(pos, std::string{structVar} + ".");
+            break;
+        }
+    }
+    return countExpr;
+}
+
+// Whether the member is owned, copyable pointed-to data of the struct
+bool deepCopyMember(std::vector<StructData> const &structs, MemberData const &memberData) {
+    if (memberData.typeSuffix != "*" || memberData.name == "pNext")
+        return false;
+    if (nonOwnedMember(memberData) &&
+        !(memberData.name.starts_with("pp") && memberData.name.size() > 2 &&
+          isupper(memberData.name[2])))
+        return false;
+
+    // Without a count, only pointers to single structs can be copied
+    if (memberData.len.empty())
+        return findStruct(structs, memberData.type) != nullptr;
+    return true;
+}
+
+// Determines which structs need more than a plain copy of their bytes to be deep-copied
+std::map<std::string_view, bool> getDeepCopyTypes(std::vector<StructData> const &structs) {
+    std::map<std::string_view, bool> deepTypes;
+    for (auto const &it : structs)
+        deepTypes[it.name] = false;
+
+    // Repeat until settled, as struct members may be declared in any order
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto const &it : structs) {
+            if (deepTypes[it.name])
+                continue;
+
+            bool needsCopy = hasPNext(it);
+            for (auto const &mem : it.members) {
+                if (deepCopyMember(structs, mem))
+                    needsCopy = true;
+                else if (mem.typeSuffix.empty() && deepTypes[mem.type])
+                    needsCopy = true;
+            }
+
+            if (needsCopy) {
+                deepTypes[it.name] = true;
+                changed = true;
+            }
+        }
+    }
+
+    return deepTypes;
+}
+
+enum class DeepMode {
+    // Copies pointed-to data into an arena
+    Copy,
+    // Only counts the bytes the copy would allocate, in the same order
+    Size,
+};
+
+void writeDeepCopy(std::ostream &out,
+                   StructData const &structData,
+                   std::vector<StructData> const &structs,
+                   std::map<std::string_view, bool> &deepTypes,
+                   DeepMode mode) {
+    bool const copy = (mode == DeepMode::Copy);
+    std::string_view const target = copy ? ", arena);\n" : ", sizer);\n";
+    std::string_view const data = copy ? "pCopy" : "pData";
+
+    for (auto const &mem : structData.members) {
+        // The pNext chain is followed iteratively by the caller, see `deepCopyWithChain`
+        if (mem.name == "pNext")
+            continue;
+
+        // Structs that can be chained have their chain followed along with them
+        std::string recurse = copy ? "deepCopy" : "deepSize";
+        if (auto const *pMemberStruct = findStruct(structs, mem.type);
+            pMemberStruct != nullptr && hasPNext(*pMemberStruct))
+            recurse += "WithChain";
+        recurse += "(";
+
+        // By-value members with their own pointed-to data
+        if (mem.typeSuffix.empty()) {
+            if (!deepTypes[mem.type])
+                continue;
+
+            std::vector<char> const itName = {'i', 'j', 'k'};
+            for (std::size_t i = 0; i < mem.sizeEnum.size(); ++i) {
+                out << "    for (uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                    << mem.sizeEnum[i] << "; ++" << itName[i] << ")\n";
+            }
+            out << "    " << recurse << "value." << mem.name;
+            for (std::size_t i = 0; i < mem.sizeEnum.size(); ++i) {
+                out << "[" << itName[i] << "]";
+            }
+            out << target;
+            continue;
+        }
+
+        if (!deepCopyMember(structs, mem))
+            continue;
+
+        out << "\n    // " << mem.type << " - " << mem.name;
+        if (!mem.len.empty()) {
+            out << " / " << mem.len;
+        }
+        out << "\n";
+
+        // Copies, or counts, an array of the member, leaving it in 'pCopy' or 'pData' respectively
+        auto writeArray = [&](std::string_view count) {
+            if (copy) {
+                out << "    if (auto *pCopy = deepCopyArray(arena, value." << mem.name << ", "
+                    << count << "); pCopy != nullptr) {\n";
+            } else {
+                out << "    if (auto *pData = value." << mem.name << "; pData != nullptr) {\n";
+                out << "        deepSizeArray(sizer, value." << mem.name << ", " << count
+                    << ");\n";
+            }
+        };
+        auto writeArrayEnd = [&]() {
+            if (copy)
+                out << "        value." << mem.name << " = pCopy;\n";
+            out << "    }\n";
+        };
+        auto writePlain = [&](std::string_view func, std::string_view count) {
+            if (copy) {
+                out << "    value." << mem.name << " = deepCopy" << func << "(arena, value."
+                    << mem.name;
+            } else {
+                out << "    deepSize" << func << "(sizer, value." << mem.name;
+            }
+            if (!count.empty())
+                out << ", " << count;
+            out << ");\n";
+        };
+
+        if (mem.len.empty()) {
+            // Single struct
+            if (deepTypes[mem.type]) {
+                writeArray("1");
+                out << "        " << recurse << "*" << data << target;
+                writeArrayEnd();
+            } else {
+                writePlain("Array", "1");
+            }
+            continue;
+        }
+
+        auto lenParts = splitLen(mem.len);
+        if (lenParts[0] == "null-terminated") {
+            writePlain("String", "");
+            continue;
+        }
+
+        std::string const count = getLenExpr(structData, mem, "value");
+        if (mem.type == "void" && lenParts.size() == 1) {
+            writePlain("Bytes", count);
+        } else if (lenParts.size() > 1 && lenParts[1] == "null-terminated") {
+            // Array of strings
+            writeArray(count);
+            out << "        for (uint32_t i = 0; i < " << count << "; ++i)\n";
+            if (copy)
+                out << "            pCopy[i] = deepCopyString(arena, pCopy[i]);\n";
+            else
+                out << "            deepSizeString(sizer, pData[i]);\n";
+            writeArrayEnd();
+        } else if (lenParts.size() > 1 && lenParts[1] == "1" &&
+                   findStruct(structs, mem.type) != nullptr) {
+            // Array of pointers to single structs
+            writeArray(count);
+            out << "        for (uint32_t i = 0; i < " << count << "; ++i) {\n";
+            if (copy) {
+                out << "            auto *pElement = deepCopyArray(arena, pCopy[i], 1);\n";
+            } else {
+                out << "            auto *pElement = pData[i];\n";
+                out << "            deepSizeArray(sizer, pData[i], 1);\n";
+            }
+            if (deepTypes[mem.type]) {
+                out << "            if (pElement != nullptr)\n";
+                out << "                " << recurse << "*pElement" << target;
+            }
+            if (copy)
+                out << "            pCopy[i] = pElement;\n";
+            out << "        }\n";
+            writeArrayEnd();
+        } else if (lenParts.size() == 1 && deepTypes[mem.type]) {
+            writeArray(count);
+            out << "        for (uint32_t i = 0; i < " << count << "; ++i)\n";
+            out << "            " << recurse << data << "[i]" << target;
+            writeArrayEnd();
+        } else {
+            writePlain("Array", count);
+        }
+    }
+}
+
 int main(int argc, char **argv) {
     std::string inputFile;
     std::string outputDir;
@@ -215,24 +1526,90 @@ int main(int argc, char **argv) {
 
     // Declarations
     outFile << functionDoc;
-    outFile << "void vk_struct_cleanup(void const* pData);\n";
+    outFile << "void vk_struct_cleanup(void const* pData) noexcept;\n";
+    outFile << cleanupAllocatorDoc;
+    outFile << "void vk_struct_cleanup(void const *pData, VkAllocationCallbacks const "
+               "*pAllocator) noexcept;\n";
+    outFile << walkDoc;
+    outFile << "void vk_struct_walk(void const *pRoot,\n";
+    outFile << "                    void (*pfnVisit)(void const *pStruct, void *pUserData),\n";
+    outFile << "                    void *pUserData);\n";
+
+    outFile << arenaDecl;
+    outFile << deepCopyDoc;
+    outFile << "void *vk_struct_deep_copy(void const *pSrc, VkStructArena &arena);\n";
+    outFile << deepSizeDoc;
+    outFile << "std::size_t vk_struct_deep_size(void const *pSrc);\n";
+    outFile << cloneIntoDoc;
+    outFile << "void *vk_struct_clone_into(void const *pSrc, void *pBuffer);\n";
+    outFile << blobSizeDoc;
+    outFile << "std::size_t vk_struct_blob_size(void const *pSrc);\n";
+    outFile << blobWriteDoc;
+    outFile << "std::size_t vk_struct_blob_write(void const *pSrc, void *pBlob, std::size_t "
+               "blobSize);\n";
+    outFile << blobViewDoc;
+    outFile << "void *vk_struct_blob_view(void *pBlob, std::size_t blobSize);\n";
+    outFile << "\n#include <cstdint>\n";
+    outFile << librarySizeDoc;
+    outFile << "std::size_t vk_struct_library_size(void const *const *ppStructs, std::size_t "
+               "count);\n";
+    outFile << libraryWriteDoc;
+    outFile << "std::size_t vk_struct_library_write(void const *const *ppStructs,\n";
+    outFile << "                                    uint64_t const *pKeys,\n";
+    outFile << "                                    std::size_t count,\n";
+    outFile << "                                    void *pLibrary,\n";
+    outFile << "                                    std::size_t librarySize);\n";
+    outFile << libraryCountDoc;
+    outFile << "std::size_t vk_struct_library_count(void const *pLibrary, std::size_t "
+               "librarySize);\n";
+    outFile << libraryFindDoc;
+    outFile << "void *vk_struct_library_find(void *pLibrary, std::size_t librarySize, uint64_t "
+               "key);\n";
+    outFile << libraryAtDoc;
+    outFile << "void *vk_struct_library_at(void *pLibrary,\n";
+    outFile << "                           std::size_t librarySize,\n";
+    outFile << "                           std::size_t index,\n";
+    outFile << "                           uint64_t *pKey = nullptr);\n";
+    outFile << deepCopyAllocatorDoc;
+    outFile << "void *vk_struct_deep_copy(void const *pSrc, VkAllocationCallbacks const "
+               "*pAllocator);\n";
+
+    // Owning wrappers
+    outFile << ownedTraitsDecl;
+    for (auto const &it : structs) {
+        std::string_view sTypeValue;
+        for (auto const &mem : it.members) {
+            if (mem.type == "VkStructureType")
+                sTypeValue = mem.values;
+        }
+        if (sTypeValue.empty() || skipCleanup(it))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "template <>\n";
+        outFile << "struct VkOwnedTraits<" << it.name << "> {\n";
+        outFile << "    static constexpr VkStructureType sType = " << sTypeValue << ";\n";
+        outFile << "};\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << ownedDecl;
 
     // Definitions
     outFile << "\n#ifdef VK_STRUCT_CLEANUP_CONFIG_MAIN\n";
-    outFile << "\n#include <cstdlib>\n";
-    outFile << "\nvoid vk_struct_cleanup(void const *pData) {\n";
-    outFile << "    if (pData == nullptr)\n";
-    outFile << "        return;\n";
-    outFile << "\n    struct VkTempStruct {\n";
-    outFile << "        VkStructureType sType;\n";
-    outFile << "    };\n";
-    outFile << "    VkTempStruct const *pTemp = static_cast<VkTempStruct const *>(pData);\n";
+    outFile << "\n#include <cstdint>\n";
+    outFile << "#include <cstdlib>\n";
+    outFile << "#include <cstring>\n";
+    outFile << "#include <new>\n";
 
-    outFile << "\n    switch (pTemp->sType) {\n";
+    // Cleanup tables
+    outFile << cleanupTableStr;
 
+    std::ostringstream lookupStr;
     for (auto const &it : structs) {
-        if (it.name == "VkBaseOutStructure" || it.name == "VkBaseInStructure" ||
-            it.name == "VkCuLaunchInfoNVX")
+        if (skipCleanup(it))
             continue;
 
         bool hasType{false};
@@ -252,82 +1629,237 @@ int main(int argc, char **argv) {
             continue;
         }
 
-        std::string_view platformDefine;
-        if (!it.platform.empty()) {
-            // Find the platform
-            for (auto &platform : platforms) {
-                if (it.platform == platform.name) {
-                    platformDefine = platform.define;
-                    break;
+        std::size_t memberCount = 0;
+        std::ostringstream tableStr;
+        tableStr << "constexpr VkCleanupMember c" << it.name << "Members[] = {\n";
+        for (auto const &mem : it.members) {
+            if (mem.typeSuffix != "*" || nonOwnedMember(mem))
+                continue;
+
+            ++memberCount;
+            tableStr << "    {offsetof(" << it.name << ", " << mem.name << "), ";
+            if (mem.name == "pNext") {
+                tableStr << "cNoCount, 0, true},\n";
+                continue;
+            }
+
+            auto const *pElement = findStruct(structs, mem.type);
+            if (pElement == nullptr || !canCleanup(*pElement)) {
+                tableStr << "cNoCount, 0, false},\n";
+            } else if (mem.len.empty()) {
+                tableStr << "cNoCount, 0, true},\n";
+            } else {
+                MemberData const *pCount = nullptr;
+                for (auto const &inMem : it.members) {
+                    if (inMem.name == mem.len && inMem.type == "uint32_t" &&
+                        inMem.typeSuffix.empty())
+                        pCount = &inMem;
+                }
+
+                if (pCount == nullptr) {
+                    std::cout << "Info: Not cleaning up the elements of " << it.name
+                              << "::" << mem.name << ", count is not a uint32_t member"
+                              << std::endl;
+                    tableStr << "cNoCount, 0, false},\n";
+                } else {
+                    tableStr << "offsetof(" << it.name << ", " << pCount->name << "), sizeof("
+                             << mem.type << "), true},\n";
                 }
             }
+        }
+        tableStr << "};\n";
+
+        // An empty table would be an invalid zero-sized array
+        if (memberCount == 0)
+            continue;
 
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty()) {
             outFile << "#ifdef " << platformDefine << "\n";
+            lookupStr << "#ifdef " << platformDefine << "\n";
         }
 
+        outFile << tableStr.str();
         for (auto const &mem : it.members) {
             if (mem.type == "VkStructureType") {
-                outFile << "    case " << mem.values << ":\n";
-                outFile << "        {   // " << it.name << "\n";
-                outFile << "            " << it.name << " const *pStruct = static_cast<" << it.name
-                        << " const *>(pData);\n";
+                lookupStr << "    case " << mem.values << ":\n";
+                lookupStr << "        return {c" << it.name << "Members, c" << it.name
+                          << "Members + " << memberCount << "};\n";
                 break;
             }
         }
 
-        for (auto const &mem : it.members) {
-            if (mem.typeSuffix == "*") {
-                // Determine if we need to recursively cleanup
-                if (nonOwnedMember(mem))
-                    continue;
-
-                outFile << "\n            // " << mem.type << " - " << mem.name;
-                if (!mem.len.empty()) {
-                    outFile << " / " << mem.len;
-                }
-                outFile << "\n";
+        if (!platformDefine.empty()) {
+            outFile << "#endif // " << platformDefine << "\n";
+            lookupStr << "#endif // " << platformDefine << "\n";
+        }
+    }
 
-                if (mem.name == "pNext") {
-                    outFile << "            vk_struct_cleanup(pStruct->pNext);\n";
-                } else {
-                    for (auto const &inIt : structs) {
-                        if (inIt.name == mem.type && canCleanup(inIt)) {
-                            if (mem.len.empty()) {
-                                outFile << "            vk_struct_cleanup(pStruct->" << mem.name
-                                        << ");\n";
-                            } else {
-                                outFile << "            for (uint32_t i = 0; i < pStruct->"
-                                        << mem.len << "; ++i)\n";
-                                outFile << "                vk_struct_cleanup(&pStruct->"
-                                        << mem.name << "[i]);\n";
-                            }
-                        }
-                    }
-                }
+    outFile << "\nVkCleanupMembers getCleanupMembers(VkStructureType sType) noexcept {\n";
+    outFile << "    switch (sType) {\n";
+    outFile << lookupStr.str();
+    outFile << "    default:\n";
+    outFile << "        return {nullptr, nullptr};\n";
+    outFile << "    }\n";
+    outFile << "}\n";
 
-                if (mem.len.empty()) {
-                    outFile << "            free(const_cast<" << mem.type << " *>(pStruct->"
-                            << mem.name << "));\n";
-                } else {
-                    outFile << "            free(const_cast<" << mem.type << " *>(pStruct->"
-                            << mem.name << "));\n";
-                }
-            }
+    outFile << walkerStr;
+    outFile << "\n} // namespace\n";
+    outFile << cleanupInterpreterStr;
+
+    // Deep copy
+    outFile << deepCopyHelpers;
+
+    auto deepTypes = getDeepCopyTypes(structs);
+
+    // Declarations first, as structs may refer to those defined later
+    for (auto const &it : structs) {
+        if (!deepTypes[it.name])
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\ntemplate <typename Arena>\n";
+        outFile << "void deepCopy(" << it.name << " &value, Arena &arena);\n";
+        outFile << "template <typename Sizer>\n";
+        outFile << "void deepSize(" << it.name << " const &value, Sizer &sizer);\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << chainHelpers;
+
+    for (auto const &it : structs) {
+        if (!deepTypes[it.name])
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        // Structs only deep for their pNext chain have nothing else to do
+        std::ostringstream copyStr;
+        std::ostringstream sizeStr;
+        writeDeepCopy(copyStr, it, structs, deepTypes, DeepMode::Copy);
+        writeDeepCopy(sizeStr, it, structs, deepTypes, DeepMode::Size);
+
+        outFile << "\ntemplate <typename Arena>\n";
+        if (copyStr.str().empty()) {
+            outFile << "void deepCopy(" << it.name << " &, Arena &) {}\n";
+            outFile << "\ntemplate <typename Sizer>\n";
+            outFile << "void deepSize(" << it.name << " const &, Sizer &) {}\n";
+        } else {
+            outFile << "void deepCopy(" << it.name << " &value, Arena &arena) {\n";
+            outFile << copyStr.str();
+            outFile << "}\n";
+
+            outFile << "\ntemplate <typename Sizer>\n";
+            outFile << "void deepSize(" << it.name << " const &value, Sizer &sizer) {\n";
+            outFile << sizeStr.str();
+            outFile << "}\n";
         }
 
-        outFile << "        }\n";
-        outFile << "\n        break;\n";
         if (!platformDefine.empty())
-            outFile << "#endif // " << platformDefine << "\n\n";
-        else
-            outFile << "\n";
+            outFile << "#endif // " << platformDefine << "\n";
     }
 
-    outFile << "\n    default:\n";
-    outFile << "        break;\n";
-    outFile << "    }\n";
+    for (auto mode : {DeepMode::Copy, DeepMode::Size}) {
+        bool const copy = (mode == DeepMode::Copy);
+        if (copy) {
+            outFile << "\ntemplate <typename Arena>\n";
+            outFile << "void *deepCopyLink(void const *pSrc, Arena &arena) {\n";
+        } else {
+            outFile << "\ntemplate <typename Sizer>\n";
+            outFile << "bool deepSizeLink(void const *pSrc, Sizer &sizer) {\n";
+        }
+        outFile << "\n    struct VkTempStruct {\n";
+        outFile << "        VkStructureType sType;\n";
+        outFile << "    };\n";
+        outFile << "    VkTempStruct const *pTemp = static_cast<VkTempStruct const *>(pSrc);\n";
+        outFile << "\n    switch (pTemp->sType) {\n";
+
+        for (auto const &it : structs) {
+            std::string_view sTypeValue;
+            for (auto const &mem : it.members) {
+                if (mem.type == "VkStructureType")
+                    sTypeValue = mem.values;
+            }
+            if (sTypeValue.empty())
+                continue;
+
+            std::string_view platformDefine = getPlatformDefine(it, platforms);
+            if (!platformDefine.empty())
+                outFile << "#ifdef " << platformDefine << "\n";
+
+            outFile << "    case " << sTypeValue << ": {\n";
+            if (copy) {
+                outFile << "        auto *pCopy = deepCopyArray(arena, static_cast<" << it.name
+                        << " const *>(pSrc), 1);\n";
+                if (deepTypes[it.name])
+                    outFile << "        deepCopy(*pCopy, arena);\n";
+                outFile << "        return pCopy;\n";
+            } else {
+                outFile << "        auto *pStruct = static_cast<" << it.name
+                        << " const *>(pSrc);\n";
+                outFile << "        sizer.add(sizeof(" << it.name << "), alignof(" << it.name
+                        << "));\n";
+                if (deepTypes[it.name])
+                    outFile << "        deepSize(*pStruct, sizer);\n";
+                outFile << "        return true;\n";
+            }
+            outFile << "    }\n";
+
+            if (!platformDefine.empty())
+                outFile << "#endif // " << platformDefine << "\n";
+        }
+
+        outFile << "\n    default:\n";
+        outFile << (copy ? "        return nullptr;\n" : "        return false;\n");
+        outFile << "    }\n";
+        outFile << "}\n";
+    }
+    outFile << chainLoops;
+
+    outFile << "\n} // namespace\n";
+
+    outFile << "\nvoid *vk_struct_deep_copy(void const *pSrc, VkStructArena &arena) {\n";
+    outFile << "    return deepCopyChain(pSrc, arena);\n";
+    outFile << "}\n";
+
+    outFile << "\nstd::size_t vk_struct_deep_size(void const *pSrc) {\n";
+    outFile << "    SizeCounter sizer;\n";
+    outFile << "    deepSizeChain(pSrc, nullptr, sizer);\n";
+    outFile << "    return sizer.size;\n";
+    outFile << "}\n";
+
+    outFile << "\nvoid *vk_struct_clone_into(void const *pSrc, void *pBuffer) {\n";
+    outFile << "    BufferArena arena{pBuffer};\n";
+    outFile << "    return deepCopyChain(pSrc, arena);\n";
     outFile << "}\n";
 
+    outFile << "\nvoid *vk_struct_deep_copy(void const *pSrc, VkAllocationCallbacks const "
+               "*pAllocator) {\n";
+    outFile << "    std::size_t const size = vk_struct_deep_size(pSrc);\n";
+    outFile << "    if (size == 0)\n";
+    outFile << "        return nullptr;\n";
+    outFile << "\n    void *pBuffer;\n";
+    outFile << "    if (pAllocator != nullptr)\n";
+    outFile << "        pBuffer = pAllocator->pfnAllocation(pAllocator->pUserData, size,\n";
+    outFile << "                                            alignof(std::max_align_t),\n";
+    outFile << "                                            VK_SYSTEM_ALLOCATION_SCOPE_OBJECT);\n";
+    outFile << "    else\n";
+    outFile << "        pBuffer = malloc(size);\n";
+    outFile << "    if (pBuffer == nullptr)\n";
+    outFile << "        return nullptr;\n";
+    outFile << "\n    return vk_struct_clone_into(pSrc, pBuffer);\n";
+    outFile << "}\n";
+
+    // Relocatable blobs, and libraries of them
+    outFile << blobDefs;
+    outFile << libraryDefs;
+
     outFile << "\n#endif // VK_STRUCT_CLEANUP_CONFIG_MAIN\n";
 
     // Finish Up
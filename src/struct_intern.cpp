@@ -0,0 +1,857 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "compare_members.hpp"
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where the declarations for interning are required. This depends
+    on the `vk_equality_checks.hpp` header for the comparison and hashing of structs.
+
+    On *ONE* compilation unit, include the definition of `#define VK_STRUCT_INTERN_CONFIG_MAIN`
+    so that the definitions are compiled somewhere following the one definition rule.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains `vk_intern` functions for the same
+set of Vulkan struct types as the equality checks, which return a pointer to
+a single pooled copy of every distinct struct value, making a deep copy of
+any pointed-to data when the value is first seen.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_struct_intern.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+#include <cstdint>
+
+/// Number of times values were found already in the pool (hits), had to be added (misses), or
+/// couldn't be interned as their pNext chains hold a struct interning doesn't cover (rejections)
+struct VkInternStats {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t rejections;
+};
+
+/** @brief Returns the pooled copy of a struct equal to the given one
+ * @param value Struct to intern
+ * @return Pointer to the pooled copy, valid until program exit, or nullptr if a pNext chain holds
+ * a struct that can't be interned
+ *
+ * Structs are compared and hashed using the `operator==` and `vk_hash` functions from the
+ * equality checks, so equal structs always return the same pointer, and the pointer itself can be
+ * used as an identifier.
+ *
+ * When a value is first seen, it is deep-copied into pooled storage, including strings, data
+ * blobs and counted arrays, recursively. Pointers that are not compared by content, such as those
+ * without a count, are copied as-is.
+ *
+ * The `pNext` chains of the struct, and of any struct it holds or points to, are hashed, compared
+ * and deep-copied along with it, link by link in order. A chain holding a struct that the equality
+ * checks don't cover, such as one with an unknown sType or that holds a union, can't be, so the
+ * struct isn't interned, and is counted as a rejection in the stats.
+ *
+ * Safe to call from multiple threads concurrently.
+ */
+template <typename T>
+T const *vk_intern(T const &value);
+
+/// Returns the hit/miss counts of interning just the given struct type
+template <typename T>
+VkInternStats vk_intern_stats() noexcept;
+
+/// Returns the hit/miss counts of interning all struct types
+VkInternStats vk_intern_stats() noexcept;
+)DECL";
+
+std::string_view internHelperStr = R"HELPER(
+namespace {
+
+std::atomic<uint64_t> totalHits{0};
+std::atomic<uint64_t> totalMisses{0};
+std::atomic<uint64_t> totalRejections{0};
+
+// Bump allocator for pooled data, which is never freed
+class InternArena {
+public:
+  void *allocate(std::size_t size, std::size_t alignment) {
+    void *pData = pCurrent;
+    if (pData == nullptr || std::align(alignment, size, pData, space) == nullptr) {
+      // Requests larger than a regular chunk get their own
+      std::size_t const chunkSize = std::max(size + alignment, cChunkSize);
+      chunks.emplace_back(new std::byte[chunkSize]);
+      pData = chunks.back().get();
+      space = chunkSize;
+      std::align(alignment, size, pData, space);
+    }
+    pCurrent = static_cast<std::byte *>(pData) + size;
+    space -= size;
+    return pData;
+  }
+
+private:
+  static constexpr std::size_t cChunkSize = 16384;
+
+  std::vector<std::unique_ptr<std::byte[]>> chunks;
+  void *pCurrent = nullptr;
+  std::size_t space = 0;
+};
+
+// Pointers that are non-null remain so, even if there is no data to copy
+template <typename T>
+std::remove_const_t<T> *internArray(InternArena &arena, T *pSrc, std::size_t count) {
+  if (pSrc == nullptr)
+    return nullptr;
+  auto *pDst = static_cast<std::remove_const_t<T> *>(
+      arena.allocate(sizeof(T) * std::max<std::size_t>(count, 1), alignof(T)));
+  std::memcpy(pDst, pSrc, sizeof(T) * count);
+  return pDst;
+}
+
+void const *internBytes(InternArena &arena, void const *pSrc, std::size_t size) {
+  if (pSrc == nullptr)
+    return nullptr;
+  void *pDst = arena.allocate(std::max<std::size_t>(size, 1), alignof(std::max_align_t));
+  std::memcpy(pDst, pSrc, size);
+  return pDst;
+}
+
+char const *internString(InternArena &arena, char const *pSrc) {
+  if (pSrc == nullptr)
+    return nullptr;
+  return internArray(arena, pSrc, strlen(pSrc) + 1);
+}
+
+// Types without any pointed-to data are fully copied by assignment
+template <typename T>
+void internCopy(T &, InternArena &) {}
+
+void combineChainHash(std::size_t &seed, std::size_t value) noexcept {
+  seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// Types without a pNext, including through their members, have no chains to hash or compare
+template <typename T>
+bool hashChains(T const &, std::size_t &) noexcept {
+  return true;
+}
+
+template <typename T>
+bool chainsEqual(T const &, T const &) noexcept {
+  return true;
+}
+
+// Adds each link of a pNext chain to the hash, returning false if a link can't be interned
+bool hashChain(void const *pNext, std::size_t &hash) noexcept;
+// Whether two chains have equal links in the same order, where both have been hashed already
+bool chainEqual(void const *pLhs, void const *pRhs) noexcept;
+// Deep-copies a chain that has been hashed already into pooled storage
+void *internChain(void const *pNext, InternArena &arena);
+)HELPER";
+
+std::string_view internPoolStr = R"POOL(
+template <typename T>
+struct InternPool {
+  static constexpr std::size_t cShardCount = 16;
+
+  // Values are spread across independently locked shards to reduce contention between threads
+  struct alignas(64) Shard {
+    std::shared_mutex mutex;
+    std::unordered_multimap<std::size_t, T const *> entries;
+    InternArena arena;
+  };
+
+  Shard shards[cShardCount];
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::atomic<uint64_t> rejections{0};
+};
+
+template <typename T>
+InternPool<T> &getInternPool() {
+  static InternPool<T> pool;
+  return pool;
+}
+
+template <typename T>
+T const *findInterned(typename InternPool<T>::Shard const &shard,
+                      std::size_t hash,
+                      T const &value) noexcept {
+  auto [it, end] = shard.entries.equal_range(hash);
+  for (; it != end; ++it) {
+    if (*it->second == value && chainsEqual(*it->second, value))
+      return it->second;
+  }
+  return nullptr;
+}
+
+template <typename T>
+T const *internValue(T const &value) {
+  auto &pool = getInternPool<T>();
+  // Chains take no part in operator== or vk_hash, so are hashed and compared here
+  std::size_t hash = vk_hash(value);
+  if (!hashChains(value, hash)) {
+    pool.rejections.fetch_add(1, std::memory_order_relaxed);
+    totalRejections.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  auto &shard = pool.shards[hash % InternPool<T>::cShardCount];
+
+  {
+    std::shared_lock lock{shard.mutex};
+    if (auto *pFound = findInterned(shard, hash, value); pFound != nullptr) {
+      pool.hits.fetch_add(1, std::memory_order_relaxed);
+      totalHits.fetch_add(1, std::memory_order_relaxed);
+      return pFound;
+    }
+  }
+
+  std::unique_lock lock{shard.mutex};
+  // Another thread may have added the same value while unlocked
+  if (auto *pFound = findInterned(shard, hash, value); pFound != nullptr) {
+    pool.hits.fetch_add(1, std::memory_order_relaxed);
+    totalHits.fetch_add(1, std::memory_order_relaxed);
+    return pFound;
+  }
+
+  T *pCopy = new (shard.arena.allocate(sizeof(T), alignof(T))) T{value};
+  internCopy(*pCopy, shard.arena);
+  shard.entries.emplace(hash, pCopy);
+
+  pool.misses.fetch_add(1, std::memory_order_relaxed);
+  totalMisses.fetch_add(1, std::memory_order_relaxed);
+  return pCopy;
+}
+
+template <typename T>
+VkInternStats internStats() noexcept {
+  auto &pool = getInternPool<T>();
+  return VkInternStats{pool.hits.load(std::memory_order_relaxed),
+                       pool.misses.load(std::memory_order_relaxed),
+                       pool.rejections.load(std::memory_order_relaxed)};
+}
+
+} // namespace
+
+VkInternStats vk_intern_stats() noexcept {
+  return VkInternStats{totalHits.load(std::memory_order_relaxed),
+                       totalMisses.load(std::memory_order_relaxed),
+                       totalRejections.load(std::memory_order_relaxed)};
+}
+)POOL";
+
+bool hasPNext(StructData const &structData) {
+    for (auto const &member : structData.members) {
+        if (member.name == "pNext")
+            return true;
+    }
+    return false;
+}
+
+// Determines which of the structs need more than a plain assignment to be copied into the pool,
+// for a pNext chain or other pointed-to data, including through their struct members.
+std::map<std::string_view, bool> getInternCopyTypes(std::vector<StructData> const &structs,
+                                                    std::vector<UnionData> const &unions) {
+    std::map<std::string_view, bool> copyTypes;
+    for (auto const &it : structs) {
+        if (!skipStruct(it, unions))
+            copyTypes[it.name] = false;
+    }
+
+    // Repeat until settled, as struct members may be declared in any order
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto const &it : structs) {
+            auto copyIt = copyTypes.find(it.name);
+            if (copyIt == copyTypes.end() || copyIt->second)
+                continue;
+
+            bool needsCopy = hasPNext(it);
+            for (auto const &compareMember : getCompareMembers(it)) {
+                auto const &member = *compareMember.member;
+                switch (compareMember.type) {
+                case CompareType::Count:
+                    break;
+                case CompareType::ImmutableSamplers:
+                case CompareType::String:
+                case CompareType::RawData:
+                case CompareType::Array:
+                    needsCopy = true;
+                    break;
+                case CompareType::FixedArray:
+                case CompareType::Value:
+                    if (member.typeSuffix.empty()) {
+                        if (auto memberIt = copyTypes.find(member.type);
+                            memberIt != copyTypes.end() && memberIt->second)
+                            needsCopy = true;
+                    }
+                    break;
+                }
+            }
+
+            if (needsCopy) {
+                copyIt->second = true;
+                changed = true;
+            }
+        }
+    }
+
+    return copyTypes;
+}
+
+void writeInternCopy(std::ostream &out,
+                     StructData const &structData,
+                     std::map<std::string_view, bool> const &copyTypes) {
+    auto isCopyType = [&](std::string_view type) {
+        auto it = copyTypes.find(type);
+        return it != copyTypes.end() && it->second;
+    };
+
+    if (hasPNext(structData))
+        out << "  value.pNext =\n"
+               "      static_cast<decltype(value.pNext)>(internChain(value.pNext, arena));\n";
+
+    for (auto const &it : getCompareMembers(structData)) {
+        auto const &member = *it.member;
+
+        switch (it.type) {
+        case CompareType::Count:
+            break;
+
+        case CompareType::FixedArray:
+            if (isCopyType(member.type)) {
+                std::vector<char> const itName = {'i', 'j', 'k'};
+
+                for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                    out << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                        << member.sizeEnum[i] << "; ++" << itName[i] << ")\n";
+                }
+                out << "    internCopy(value." << member.name;
+                for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                    out << "[" << itName[i] << "]";
+                }
+                out << ", arena);\n";
+            }
+            break;
+
+        case CompareType::String:
+            out << "  value." << member.name << " = internString(arena, value." << member.name
+                << ");\n";
+            break;
+
+        case CompareType::RawData:
+            out << "  value." << member.name << " = internBytes(arena, value." << member.name
+                << ", " << getCountExpr(it, "value") << ");\n";
+            break;
+
+        case CompareType::ImmutableSamplers:
+        case CompareType::Array:
+            if (isCopyType(member.type) && member.typeSuffix == "*") {
+                out << "  if(auto *pCopy = internArray(arena, value." << member.name << ", "
+                    << getCountExpr(it, "value") << "); pCopy != nullptr) {\n";
+                out << "    for(uint32_t i = 0; i < " << getCountExpr(it, "value") << "; ++i)\n";
+                out << "      internCopy(pCopy[i], arena);\n";
+                out << "    value." << member.name << " = pCopy;\n";
+                out << "  }\n";
+            } else {
+                out << "  value." << member.name << " = internArray(arena, value." << member.name
+                    << ", " << getCountExpr(it, "value") << ");\n";
+            }
+            break;
+
+        case CompareType::Value:
+            if (member.typeSuffix.empty() && isCopyType(member.type))
+                out << "  internCopy(value." << member.name << ", arena);\n";
+            break;
+        }
+    }
+}
+
+// Determines which of the structs can have a pNext chain, either their own or through the structs
+// they hold or point to.
+std::set<std::string_view> getChainTypes(std::vector<StructData> const &structs,
+                                         std::vector<UnionData> const &unions) {
+    std::set<std::string_view> chainTypes;
+
+    // Repeat until settled, as struct members may be declared in any order
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto const &it : structs) {
+            if (skipStruct(it, unions) || chainTypes.contains(it.name))
+                continue;
+
+            bool hasChain = hasPNext(it);
+            for (auto const &compareMember : getCompareMembers(it)) {
+                auto const &member = *compareMember.member;
+                switch (compareMember.type) {
+                case CompareType::ImmutableSamplers:
+                case CompareType::Array:
+                    if (member.typeSuffix == "*" && chainTypes.contains(member.type))
+                        hasChain = true;
+                    break;
+                case CompareType::FixedArray:
+                case CompareType::Value:
+                    if (member.typeSuffix.empty() && chainTypes.contains(member.type))
+                        hasChain = true;
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            if (hasChain) {
+                chainTypes.insert(it.name);
+                changed = true;
+            }
+        }
+    }
+
+    return chainTypes;
+}
+
+// Writes the body of either `hashChains(value, hash)`, or `chainsEqual(lhs, rhs)` when comparing,
+// which go through the chains of the struct itself and then of the structs it holds or points to
+void writeChainWalk(std::ostream &out,
+                    StructData const &structData,
+                    std::set<std::string_view> const &chainTypes,
+                    bool compare) {
+    std::string_view const var = compare ? "lhs" : "value";
+    auto walkCall = [&](std::string_view function, std::string const &member) {
+        if (compare)
+            return std::string{function} + "(lhs." + member + ", rhs." + member + ")";
+        return std::string{function} + "(value." + member + ", hash)";
+    };
+
+    if (hasPNext(structData)) {
+        out << "  if(!" << walkCall(compare ? "chainEqual" : "hashChain", "pNext") << ")\n";
+        out << "    return false;\n";
+    }
+
+    for (auto const &it : getCompareMembers(structData)) {
+        auto const &member = *it.member;
+        if (!chainTypes.contains(member.type))
+            continue;
+
+        std::string_view const function = compare ? "chainsEqual" : "hashChains";
+        switch (it.type) {
+        case CompareType::FixedArray:
+            if (member.typeSuffix.empty()) {
+                std::vector<char> const itName = {'i', 'j', 'k'};
+
+                std::string element{member.name};
+                for (std::size_t i = 0; i < member.sizeEnum.size(); ++i) {
+                    out << "  for(uint32_t " << itName[i] << " = 0; " << itName[i] << " < "
+                        << member.sizeEnum[i] << "; ++" << itName[i] << ")\n";
+                    element += std::string{"["} + itName[i] + "]";
+                }
+                out << "    if(!" << walkCall(function, element) << ")\n";
+                out << "      return false;\n";
+            }
+            break;
+
+        case CompareType::ImmutableSamplers:
+        case CompareType::Array:
+            if (member.typeSuffix == "*") {
+                // Counts are equal, and arrays either both null or not, as operator== held
+                out << "  if(" << var << "." << member.name << " != nullptr) {\n";
+                out << "    for(uint32_t i = 0; i < " << getCountExpr(it, var) << "; ++i)\n";
+                out << "      if(!" << walkCall(function, std::string{member.name} + "[i]")
+                    << ")\n";
+                out << "        return false;\n";
+                out << "  }\n";
+            }
+            break;
+
+        case CompareType::Value:
+            if (member.typeSuffix.empty()) {
+                out << "  if(!" << walkCall(function, std::string{member.name}) << ")\n";
+                out << "    return false;\n";
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    out << "  return true;\n";
+}
+
+// Writes the functions that hash, compare and copy pNext chains, each switching on the sType of a
+// link to the struct it is, for every struct with an sType that the equality checks cover
+void writeChainLinks(std::ostream &out,
+                     std::vector<StructData> const &structs,
+                     std::vector<UnionData> const &unions,
+                     std::vector<PlatformData> const &platforms) {
+    std::vector<std::pair<StructData const *, std::string_view>> links;
+    for (auto const &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
+        for (auto const &member : it.members) {
+            if (member.name == "sType" && !member.values.empty())
+                links.emplace_back(&it, member.values);
+        }
+    }
+
+    auto writeCases = [&](auto const &writeCase) {
+        for (auto const &[pStruct, sType] : links) {
+            std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+            if (!platformDefine.empty())
+                out << "#ifdef " << platformDefine << "\n";
+
+            out << "  case " << sType << ": {\n";
+            writeCase(pStruct->name);
+            out << "  }\n";
+
+            if (!platformDefine.empty())
+                out << "#endif // " << platformDefine << "\n";
+        }
+    };
+
+    out << "\nbool hashChain(void const *pNext, std::size_t &hash) noexcept {\n";
+    out << "  if(pNext == nullptr)\n";
+    out << "    return true;\n";
+    out << "\n";
+    out << "  auto const sType = static_cast<VkBaseInStructure const *>(pNext)->sType;\n";
+    out << "  combineChainHash(hash, static_cast<std::size_t>(sType));\n";
+    out << "  switch(sType) {\n";
+    writeCases([&](std::string_view name) {
+        out << "    auto const &link = *static_cast<" << name << " const *>(pNext);\n";
+        out << "    combineChainHash(hash, vk_hash(link));\n";
+        out << "    return hashChains(link, hash);\n";
+    });
+    out << "  default:\n";
+    out << "    return false;\n";
+    out << "  }\n";
+    out << "}\n";
+
+    out << "\nbool chainEqual(void const *pLhs, void const *pRhs) noexcept {\n";
+    out << "  if(pLhs == nullptr || pRhs == nullptr)\n";
+    out << "    return pLhs == pRhs;\n";
+    out << "\n";
+    out << "  auto const sType = static_cast<VkBaseInStructure const *>(pLhs)->sType;\n";
+    out << "  if(sType != static_cast<VkBaseInStructure const *>(pRhs)->sType)\n";
+    out << "    return false;\n";
+    out << "  switch(sType) {\n";
+    writeCases([&](std::string_view name) {
+        out << "    auto const &lhs = *static_cast<" << name << " const *>(pLhs);\n";
+        out << "    auto const &rhs = *static_cast<" << name << " const *>(pRhs);\n";
+        out << "    return lhs == rhs && chainsEqual(lhs, rhs);\n";
+    });
+    out << "  default:\n";
+    out << "    return false;\n";
+    out << "  }\n";
+    out << "}\n";
+
+    out << "\nvoid *internChain(void const *pNext, InternArena &arena) {\n";
+    out << "  if(pNext == nullptr)\n";
+    out << "    return nullptr;\n";
+    out << "\n";
+    out << "  switch(static_cast<VkBaseInStructure const *>(pNext)->sType) {\n";
+    writeCases([&](std::string_view name) {
+        out << "    auto *pCopy = new (arena.allocate(sizeof(" << name << "), alignof(" << name
+            << "))) " << name << "{*static_cast<" << name << " const *>(pNext)};\n";
+        out << "    internCopy(*pCopy, arena);\n";
+        out << "    return pCopy;\n";
+    });
+    out << "  default:\n";
+    out << "    // Chains are hashed before being copied, which fails for anything else\n";
+    out << "    return nullptr;\n";
+    out << "  }\n";
+    out << "}\n";
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_struct_intern.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    // Need to be in the 'types' node
+    auto *typesNode = registryNode->first_node("types");
+    if (typesNode == nullptr) {
+        std::cerr << "Error: Could not find the 'types' node." << std::endl;
+        return 1;
+    }
+
+    auto structs = getStructData(typesNode);
+    auto unions = getUnionData(typesNode);
+
+    // Extensions for type platforms
+    auto *extensionsNode = registryNode->first_node("extensions");
+    if (extensionsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'extensions' node." << std::endl;
+        return 1;
+    }
+
+    getStructPlatforms(structs, extensionsNode);
+
+    auto copyTypes = getInternCopyTypes(structs, unions);
+    auto chainTypes = getChainTypes(structs, unions);
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_STRUCT_INTERN_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_STRUCT_INTERN_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\" );\n";
+
+    // Declarations
+    outFile << declarationStr;
+
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\ntemplate <>\n";
+        outFile << it.name << " const *vk_intern(" << it.name << " const &value);\n";
+        outFile << "template <>\n";
+        outFile << "VkInternStats vk_intern_stats<" << it.name << ">() noexcept;\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    // Definitions
+    outFile << "\n#ifdef VK_STRUCT_INTERN_CONFIG_MAIN\n";
+    outFile << "\n#include <algorithm>\n";
+    outFile << "#include <atomic>\n";
+    outFile << "#include <cstddef>\n";
+    outFile << "#include <cstring>\n";
+    outFile << "#include <memory>\n";
+    outFile << "#include <mutex>\n";
+    outFile << "#include <new>\n";
+    outFile << "#include <shared_mutex>\n";
+    outFile << "#include <type_traits>\n";
+    outFile << "#include <unordered_map>\n";
+    outFile << "#include <vector>\n";
+    outFile << internHelperStr;
+
+    // Deep-copy and chain walk declarations, as structs may refer to those defined later
+    for (auto &it : structs) {
+        if (!copyTypes[it.name] && !chainTypes.contains(it.name))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        if (copyTypes[it.name])
+            outFile << "\nvoid internCopy(" << it.name << " &value, InternArena &arena);\n";
+        if (chainTypes.contains(it.name)) {
+            outFile << "\nbool hashChains(" << it.name
+                    << " const &value, std::size_t &hash) noexcept;\n";
+            outFile << "bool chainsEqual(" << it.name << " const &lhs, " << it.name
+                    << " const &rhs) noexcept;\n";
+        }
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    // Deep-copy definitions
+    for (auto &it : structs) {
+        if (!copyTypes[it.name])
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\nvoid internCopy(" << it.name << " &value, InternArena &arena) {\n";
+        writeInternCopy(outFile, it, copyTypes);
+        outFile << "}\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    // Chain walk definitions
+    for (auto &it : structs) {
+        if (!chainTypes.contains(it.name))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\nbool hashChains(" << it.name
+                << " const &value, std::size_t &hash) noexcept {\n";
+        writeChainWalk(outFile, it, chainTypes, false);
+        outFile << "}\n";
+        outFile << "\nbool chainsEqual(" << it.name << " const &lhs, " << it.name
+                << " const &rhs) noexcept {\n";
+        writeChainWalk(outFile, it, chainTypes, true);
+        outFile << "}\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    writeChainLinks(outFile, structs, unions, platforms);
+
+    outFile << internPoolStr;
+
+    for (auto &it : structs) {
+        if (skipStruct(it, unions))
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        outFile << "\ntemplate <>\n";
+        outFile << it.name << " const *vk_intern(" << it.name << " const &value) {\n";
+        outFile << "  return internValue(value);\n";
+        outFile << "}\n";
+
+        outFile << "\ntemplate <>\n";
+        outFile << "VkInternStats vk_intern_stats<" << it.name << ">() noexcept {\n";
+        outFile << "  return internStats<" << it.name << ">();\n";
+        outFile << "}\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n#endif // VK_STRUCT_INTERN_CONFIG_MAIN\n";
+
+    outFile << "\n#endif // VK_STRUCT_INTERN_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
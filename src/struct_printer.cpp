@@ -0,0 +1,1132 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+#include "value_names.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where the declarations for the printers are required.
+
+    On *ONE* compilation unit, include the definition of `#define VK_STRUCT_PRINTER_CONFIG_MAIN`
+    so that the definitions are compiled somewhere following the one definition rule.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains printers for every Vulkan struct, which
+write a struct, along with its pNext chain, arrays and the structs it points to,
+as readable text into a caller-supplied sink without allocating, naming enum and
+flag values as the value serialization does.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_struct_printer.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// Destination of printed structs, which is written to a piece at a time
+class VkPrintSink {
+  public:
+    virtual ~VkPrintSink() = default;
+
+    virtual void write(char const *pData, std::size_t size) = 0;
+};
+
+/** @brief Prints into a caller-supplied buffer, dropping whatever doesn't fit
+ *
+ * The buffer is kept null-terminated, so the text printed into it is always usable as a C string.
+ */
+class VkBufferSink final : public VkPrintSink {
+  public:
+    VkBufferSink(char *pBuffer, std::size_t capacity) noexcept;
+
+    void write(char const *pData, std::size_t size) override;
+
+    /// The text printed into the buffer so far
+    std::string_view view() const noexcept { return {pBuffer, used}; }
+    /// Whether any text was dropped for not fitting in the buffer
+    bool truncated() const noexcept { return dropped; }
+    /// Empties the buffer, to be printed into again
+    void reset() noexcept;
+
+  private:
+    char *pBuffer;
+    std::size_t capacity;
+    std::size_t used = 0;
+    bool dropped = false;
+};
+
+/** @brief Keeps the most recently printed text in a caller-supplied buffer
+ *
+ * Once the buffer is full, the oldest text is overwritten, so that it always has the last structs
+ * printed, such as for a crash handler to write out. The text starts partway through the buffer
+ * once it has wrapped, so is read as `older()` followed by `newer()`.
+ */
+class VkRingBufferSink final : public VkPrintSink {
+  public:
+    VkRingBufferSink(char *pBuffer, std::size_t capacity) noexcept
+        : pBuffer{pBuffer}, capacity{capacity} {}
+
+    void write(char const *pData, std::size_t size) override;
+
+    /// The older part of the retained text, which runs to the end of the buffer
+    std::string_view older() const noexcept;
+    /// The newer part of the retained text, from the start of the buffer
+    std::string_view newer() const noexcept;
+    /// Number of bytes ever printed into the sink, including those since overwritten
+    std::uint64_t written() const noexcept { return total; }
+    /// Empties the buffer, to be printed into again
+    void reset() noexcept { total = 0; }
+
+  private:
+    char *pBuffer;
+    std::size_t capacity;
+    std::uint64_t total = 0;
+};
+
+/** @brief Prints a Vulkan sType-based struct, found by its sType, to the sink
+ * @param pStruct Pointer to the struct to print, which must have an sType, or null
+ * @param sink Sink the text is written to
+ *
+ * Prints the same as `vk_print` given the struct itself.
+ */
+void vk_print_struct(void const *pStruct, VkPrintSink &sink);
+)DECL";
+
+std::string_view printDoc = R"DOC(
+/** @brief Prints a Vulkan struct, along with everything it points to, to the sink
+ * @param value Struct to print
+ * @param sink Sink the text is written to
+ *
+ * Each member is printed on its own line, indented by nesting, with enum and flag values named as
+ * the value serialization names them, the pNext chain as a list of the structs in it, and arrays
+ * and pointed-to structs in full. Handles, and pointers that can't be followed, such as to data
+ * given by size, are only printed as whether they are null, so the same struct always prints the
+ * same text, ending with a newline.
+ *
+ * Nothing is allocated, with the text being gathered into a small buffer on the stack and written
+ * to the sink in large pieces.
+ */
+)DOC";
+
+std::string_view sinkStr = R"SINK(
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+VkBufferSink::VkBufferSink(char *pBuffer, std::size_t capacity) noexcept
+    : pBuffer{pBuffer}, capacity{capacity} {
+    if (capacity > 0)
+        pBuffer[0] = '\0';
+}
+
+void VkBufferSink::write(char const *pData, std::size_t size) {
+    // The last byte is kept for the terminator
+    std::size_t const available = (capacity > 0) ? capacity - 1 - used : 0;
+    std::size_t const count = std::min(size, available);
+    if (count < size)
+        dropped = true;
+    if (count == 0)
+        return;
+
+    std::memcpy(pBuffer + used, pData, count);
+    used += count;
+    pBuffer[used] = '\0';
+}
+
+void VkBufferSink::reset() noexcept {
+    used = 0;
+    dropped = false;
+    if (capacity > 0)
+        pBuffer[0] = '\0';
+}
+
+void VkRingBufferSink::write(char const *pData, std::size_t size) {
+    if (capacity == 0) {
+        total += size;
+        return;
+    }
+
+    // Of a write larger than the buffer, only the end would survive
+    if (size > capacity) {
+        total += size - capacity;
+        pData += size - capacity;
+        size = capacity;
+    }
+
+    std::size_t const offset = total % capacity;
+    std::size_t const first = std::min(size, capacity - offset);
+    std::memcpy(pBuffer + offset, pData, first);
+    std::memcpy(pBuffer, pData + first, size - first);
+    total += size;
+}
+
+std::string_view VkRingBufferSink::older() const noexcept {
+    if (total <= capacity)
+        return {pBuffer, static_cast<std::size_t>(total)};
+    std::size_t const offset = total % capacity;
+    return {pBuffer + offset, capacity - offset};
+}
+
+std::string_view VkRingBufferSink::newer() const noexcept {
+    if (total <= capacity)
+        return {};
+    return {pBuffer, static_cast<std::size_t>(total % capacity)};
+}
+)SINK";
+
+std::string_view detailStr = R"DETAIL(
+namespace vk_struct_printer_detail {
+
+// Chains longer than this are assumed to have a cycle
+constexpr uint32_t cMaxChainLength = 256;
+
+/// Gathers printed text into a local buffer, so that the sink is written to in large pieces
+class Printer {
+  public:
+    explicit Printer(VkPrintSink &sink) noexcept : sink{sink} {}
+    ~Printer() { flush(); }
+
+    Printer(Printer const &) = delete;
+    Printer &operator=(Printer const &) = delete;
+
+    void write(std::string_view text) {
+        if (text.size() > sizeof(buffer) - used) {
+            flush();
+            if (text.size() > sizeof(buffer)) {
+                sink.write(text.data(), text.size());
+                return;
+            }
+        }
+        std::memcpy(buffer + used, text.data(), text.size());
+        used += text.size();
+    }
+
+    void flush() {
+        if (used > 0)
+            sink.write(buffer, used);
+        used = 0;
+    }
+
+    /// Starts a new line, indented to the current depth
+    void newLine() {
+        write("\n");
+        for (uint32_t i = 0; i < depth; ++i)
+            write("    ");
+    }
+
+    void beginMember(std::string_view name) {
+        newLine();
+        write(name);
+        write(" = ");
+    }
+
+    void beginStruct(std::string_view name) {
+        write(name);
+        write(" {");
+        ++depth;
+    }
+
+    void endStruct() {
+        --depth;
+        newLine();
+        write("}");
+    }
+
+    uint32_t depth = 0;
+    /// The struct being printed as part of a pNext chain, whose own pNext is the rest of the chain
+    void const *pChained = nullptr;
+
+  private:
+    VkPrintSink &sink;
+    char buffer[512];
+    std::size_t used = 0;
+};
+
+/// Name of an enum or flag bit value, as it is serialized
+struct ValueName {
+    std::string_view name;
+    int64_t value;
+};
+
+template <typename T>
+void printNumber(Printer &printer, T value) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    printer.write({text, static_cast<std::size_t>(result.ptr - text)});
+}
+
+void printHex(Printer &printer, uint64_t value) {
+    char text[24] = "0x";
+    auto result = std::to_chars(text + 2, text + sizeof(text), value, 16);
+    std::transform(text + 2, result.ptr, text + 2, [](char c) { return std::toupper(c); });
+    printer.write({text, static_cast<std::size_t>(result.ptr - text)});
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void printValue(Printer &printer, T value) {
+    printNumber(printer, value);
+}
+
+/// Prints a string, quoted, up to a null terminator or maxSize characters
+void printString(Printer &printer, char const *pString, std::size_t maxSize) {
+    printer.write("\"");
+    char const *pRun = pString;
+    std::size_t i = 0;
+    for (; i < maxSize && pString[i] != '\0'; ++i) {
+        unsigned char const c = static_cast<unsigned char>(pString[i]);
+        if (c >= 0x20 && c != 0x7F && c != '"' && c != '\\')
+            continue;
+
+        printer.write({pRun, static_cast<std::size_t>(pString + i - pRun)});
+        pRun = pString + i + 1;
+        if (c == '"' || c == '\\') {
+            char const escaped[] = {'\\', static_cast<char>(c)};
+            printer.write({escaped, 2});
+        } else {
+            char const digits[] = "0123456789ABCDEF";
+            char const escaped[] = {'\\', 'x', digits[c >> 4], digits[c & 0xF]};
+            printer.write({escaped, 4});
+        }
+    }
+    printer.write({pRun, static_cast<std::size_t>(pString + i - pRun)});
+    printer.write("\"");
+}
+
+void printValue(Printer &printer, char const *pString) {
+    if (pString == nullptr)
+        printer.write("null");
+    else
+        printString(printer, pString, SIZE_MAX);
+}
+
+template <std::size_t N>
+void printFixedString(Printer &printer, char const (&string)[N]) {
+    printString(printer, string, N);
+}
+
+/// Prints the name of an enum value, from names sorted by value, or the number if it has none
+void printEnum(Printer &printer, int64_t value, std::span<ValueName const> names) {
+    auto it = std::lower_bound(
+        names.begin(), names.end(), value,
+        [](ValueName const &name, int64_t value) { return name.value < value; });
+    if (it != names.end() && it->value == value)
+        printer.write(it->name);
+    else
+        printNumber(printer, value);
+}
+
+/** @brief Prints flags as the names of their bits, from names sorted by value
+ *
+ * As with the value serialization, names are matched from the highest value down, so that values
+ * of several bits are matched first, and any bits left without a name are printed as a number.
+ */
+void printFlags(Printer &printer, uint64_t value, std::span<ValueName const> names) {
+    if (value == 0) {
+        if (!names.empty() && names.front().value == 0)
+            printer.write(names.front().name);
+        else
+            printer.write("0");
+        return;
+    }
+
+    bool first = true;
+    for (auto it = names.rbegin(); it != names.rend(); ++it) {
+        uint64_t const bits = static_cast<uint64_t>(it->value);
+        if (bits == 0 || (value & bits) != bits)
+            continue;
+
+        if (!first)
+            printer.write(" | ");
+        printer.write(it->name);
+        first = false;
+        value ^= bits;
+        if (value == 0)
+            return;
+    }
+
+    if (!first)
+        printer.write(" | ");
+    printHex(printer, value);
+}
+
+void printBool(Printer &printer, VkBool32 value) {
+    if (value == VK_TRUE)
+        printer.write("VK_TRUE");
+    else if (value == VK_FALSE)
+        printer.write("VK_FALSE");
+    else
+        printNumber(printer, value);
+}
+
+/// Prints handles only as whether they are null, as their values differ from run to run
+template <typename T>
+void printHandle(Printer &printer, T handle) {
+    printer.write(handle == VK_NULL_HANDLE ? "VK_NULL_HANDLE" : "non-null");
+}
+
+/// Prints what isn't followed, being pointers only as whether they are null
+template <typename T>
+void printOpaque(Printer &printer, T const &value) {
+    if constexpr (std::is_pointer_v<T>)
+        printer.write(value == nullptr ? "null" : "non-null");
+    else if constexpr (std::is_arithmetic_v<T>)
+        printNumber(printer, value);
+    else if constexpr (std::is_enum_v<T>)
+        printNumber(printer, static_cast<int64_t>(value));
+    else
+        printer.write("{...}");
+}
+
+/// Prints data given by a size, such as specialization constants, only as its size
+void printBytes(Printer &printer, void const *pData, std::size_t size) {
+    if (pData == nullptr) {
+        printer.write("null");
+        return;
+    }
+    printer.write("(");
+    printNumber(printer, size);
+    printer.write(" bytes)");
+}
+
+void printNext(Printer &printer, void const *pStruct, void const *pNext);
+
+} // namespace vk_struct_printer_detail
+)DETAIL";
+
+std::string_view helperStr = R"HELPER(
+namespace vk_struct_printer_detail {
+
+template <typename T, typename Count, typename PrintElement>
+void printElements(Printer &printer, T const *pArray, Count count, PrintElement printElement) {
+    if (pArray == nullptr) {
+        printer.write("null");
+        return;
+    }
+
+    // Arrays of plain values are kept on one line, everything else has a line per element
+    constexpr bool cOneLine = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+    printer.write("[");
+    ++printer.depth;
+    for (Count i = 0; i < count; ++i) {
+        if (!cOneLine)
+            printer.newLine();
+        else if (i > 0)
+            printer.write(", ");
+        printElement(printer, pArray[i]);
+    }
+    --printer.depth;
+    if (!cOneLine && count > 0)
+        printer.newLine();
+    printer.write("]");
+}
+
+template <typename T, typename Count>
+void printArray(Printer &printer, T const *pArray, Count count);
+
+/// Prints the struct or value pointed to, if not null
+template <typename T>
+void printValue(Printer &printer, T const *pValue) {
+    if (pValue == nullptr)
+        printer.write("null");
+    else
+        printValue(printer, *pValue);
+}
+
+/// Prints in-place arrays, including those of arrays such as `float matrix[3][4]`
+template <typename T, std::size_t N>
+void printFixedArray(Printer &printer, T const (&array)[N]) {
+    printArray(printer, array, N);
+}
+
+template <typename T, typename Count>
+void printArray(Printer &printer, T const *pArray, Count count) {
+    printElements(printer, pArray, count, [](Printer &printer, T const &element) {
+        if constexpr (std::is_array_v<T>)
+            printFixedArray(printer, element);
+        else
+            printValue(printer, element);
+    });
+}
+
+template <typename T, typename Count>
+void printHandleArray(Printer &printer, T const *pArray, Count count) {
+    printElements(printer, pArray, count,
+                  [](Printer &printer, T element) { printHandle(printer, element); });
+}
+
+template <typename T, std::size_t N>
+void printHandleArray(Printer &printer, T const (&array)[N]) {
+    printHandleArray(printer, array, N);
+}
+
+template <typename T, typename Count>
+void printFlagsArray(Printer &printer, T const *pArray, Count count,
+                     std::span<ValueName const> names) {
+    printElements(printer, pArray, count,
+                  [names](Printer &printer, T element) { printFlags(printer, element, names); });
+}
+
+} // namespace vk_struct_printer_detail
+)HELPER";
+
+std::string_view chainStr = R"CHAIN(
+namespace vk_struct_printer_detail {
+
+void printNext(Printer &printer, void const *pStruct, void const *pNext) {
+    // The rest of a chain is printed in the list of the struct that it starts from
+    if (pStruct == printer.pChained)
+        return;
+
+    printer.beginMember("pNext");
+    if (pNext == nullptr) {
+        printer.write("null");
+        return;
+    }
+
+    void const *pOuterChained = printer.pChained;
+    uint32_t length = 0;
+    printer.write("[");
+    ++printer.depth;
+    for (auto const *pCurrent = static_cast<VkBaseInStructure const *>(pNext);
+         pCurrent != nullptr; pCurrent = pCurrent->pNext) {
+        printer.newLine();
+        if (length++ == cMaxChainLength) {
+            printer.write("...");
+            break;
+        }
+
+        printer.pChained = pCurrent;
+        printChained(printer, pCurrent);
+    }
+    printer.pChained = pOuterChained;
+    --printer.depth;
+    printer.newLine();
+    printer.write("]");
+}
+
+template <typename T>
+void printTo(VkPrintSink &sink, T const &value) {
+    Printer printer{sink};
+    printValue(printer, value);
+    printer.write("\n");
+}
+
+} // namespace vk_struct_printer_detail
+
+void vk_print_struct(void const *pStruct, VkPrintSink &sink) {
+    vk_struct_printer_detail::Printer printer{sink};
+    if (pStruct == nullptr)
+        printer.write("null");
+    else
+        printChained(printer, static_cast<VkBaseInStructure const *>(pStruct));
+    printer.write("\n");
+}
+)CHAIN";
+
+struct FlagsData {
+    // Empty for flags that have no bits defined yet
+    std::string_view flagBits;
+};
+
+// Returns the flag bits type of each bitmask type
+std::map<std::string_view, FlagsData> getFlagsData(rapidxml::xml_node<> *typesNode) {
+    std::map<std::string_view, FlagsData> flags;
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *categoryAttr = typeNode->first_attribute("category");
+        if (categoryAttr == nullptr || strcmp(categoryAttr->value(), "bitmask") != 0 ||
+            typeNode->first_attribute("alias") != nullptr)
+            continue;
+
+        auto *nameNode = typeNode->first_node("name");
+        if (nameNode == nullptr)
+            continue;
+
+        FlagsData data;
+        if (auto *attr = typeNode->first_attribute("requires"); attr != nullptr)
+            data.flagBits = attr->value();
+        else if (auto *attr = typeNode->first_attribute("bitvalues"); attr != nullptr)
+            data.flagBits = attr->value();
+
+        flags[nameNode->value()] = data;
+    }
+
+    return flags;
+}
+
+// Returns the types that are plain numbers, being those of C along with the base types defined
+// as one of them, such as VkDeviceSize
+std::set<std::string_view> getScalarTypes(rapidxml::xml_node<> *typesNode) {
+    std::set<std::string_view> scalars = {"char",     "float",   "double",   "int8_t",  "uint8_t",
+                                          "int16_t",  "uint16_t", "int32_t", "uint32_t", "int64_t",
+                                          "uint64_t", "size_t",   "int"};
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *categoryAttr = typeNode->first_attribute("category");
+        if (categoryAttr == nullptr || strcmp(categoryAttr->value(), "basetype") != 0)
+            continue;
+
+        auto *baseNode = typeNode->first_node("type");
+        auto *nameNode = typeNode->first_node("name");
+        if (baseNode != nullptr && nameNode != nullptr && scalars.contains(baseNode->value()))
+            scalars.insert(nameNode->value());
+    }
+
+    return scalars;
+}
+
+std::string toHex(uint64_t value) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << value;
+    return ss.str();
+}
+
+// Types of the registry, resolved through aliases
+struct TypeInfo {
+    std::map<std::string_view, std::string_view> const &categories;
+    std::map<std::string_view, std::string_view> const &aliases;
+    std::set<std::string_view> const &scalars;
+    // Flag bits of 64 bits, which are constants of VkFlags64 rather than an enum
+    std::set<std::string_view> const &wideEnums;
+
+    std::string_view resolve(std::string_view type) const {
+        auto it = aliases.find(type);
+        return (it != aliases.end()) ? it->second : type;
+    }
+
+    std::string_view category(std::string_view type) const {
+        auto it = categories.find(resolve(type));
+        return (it != categories.end()) ? it->second : std::string_view{};
+    }
+
+    // Whether values of the type can be printed through printValue
+    bool printable(std::string_view type) const {
+        std::string_view const typeCategory = category(type);
+        return typeCategory == "struct" || typeCategory == "union" ||
+               (typeCategory == "enum" && !wideEnums.contains(resolve(type))) ||
+               scalars.contains(resolve(type));
+    }
+};
+
+// The enums and flag bits types that are printed
+struct UsedNames {
+    // Types printed as an enum value, needing a printValue overload
+    std::set<std::string_view> enums;
+    // Types needing a table of the names of their values, including those printed as flags
+    std::set<std::string_view> tables;
+};
+
+// Writes the printing of a single member, adding the enums and flag bits it names to usedNames
+void writeMemberPrint(std::ostream &out, std::vector<MemberData> const &members,
+                      MemberData const &member, TypeInfo const &types,
+                      std::map<std::string_view, FlagsData> const &flags, UsedNames &usedNames) {
+    std::string_view const type = types.resolve(member.type);
+    std::string_view const category = types.category(type);
+    std::string const value = "value." + std::string{member.name};
+
+    if (member.name == "pNext" && member.pointerDepth > 0) {
+        out << "    printNext(printer, &value, value.pNext);\n";
+        return;
+    }
+    out << "    printer.beginMember(\"" << member.name << "\");\n";
+
+    // Values of flags types, or of 64-bit flag bits, are printed as flags
+    bool const isFlags = category == "bitmask" || types.wideEnums.contains(type);
+    auto flagNames = [&]() -> std::string {
+        std::string_view flagBits = type;
+        if (category == "bitmask") {
+            auto flagsIt = flags.find(type);
+            if (flagsIt == flags.end() || flagsIt->second.flagBits.empty())
+                return "{}";
+            flagBits = flagsIt->second.flagBits;
+        }
+        usedNames.tables.insert(flagBits);
+        return "c" + std::string{flagBits} + "Names";
+    };
+    auto useEnum = [&]() {
+        if (category == "enum") {
+            usedNames.enums.insert(type);
+            usedNames.tables.insert(type);
+        }
+    };
+
+    // Plain values, or in-place arrays of them
+    if (member.pointerDepth == 0) {
+        if (!member.sizeEnum.empty()) {
+            if (type == "char") {
+                out << "    printFixedString(printer, " << value << ");\n";
+            } else if (category == "handle") {
+                out << "    printHandleArray(printer, " << value << ");\n";
+            } else if (types.printable(type) || isFlags) {
+                out << "    printFixedArray(printer, " << value << ");\n";
+                useEnum();
+            } else {
+                out << "    printOpaque(printer, " << value << ");\n";
+            }
+        } else if (isFlags) {
+            out << "    printFlags(printer, " << value << ", " << flagNames() << ");\n";
+        } else if (category == "handle") {
+            out << "    printHandle(printer, " << value << ");\n";
+        } else if (type == "VkBool32") {
+            out << "    printBool(printer, " << value << ");\n";
+        } else if (types.printable(type)) {
+            out << "    printValue(printer, " << value << ");\n";
+            useEnum();
+        } else {
+            out << "    printOpaque(printer, " << value << ");\n";
+        }
+        return;
+    }
+
+    // Pointers
+    std::string_view len = member.len;
+    std::string_view lenRest;
+    if (auto comma = len.find(','); comma != std::string_view::npos) {
+        lenRest = len.substr(comma + 1);
+        len = len.substr(0, comma);
+    }
+
+    if (len.empty()) {
+        if (member.pointerDepth == 1 && category != "" && category != "handle" &&
+            types.printable(type)) {
+            out << "    printValue(printer, " << value << ");\n";
+            useEnum();
+        } else {
+            out << "    printOpaque(printer, " << value << ");\n";
+        }
+        return;
+    }
+    if (len == "null-terminated" && type == "char" && member.pointerDepth == 1) {
+        out << "    printValue(printer, " << value << ");\n";
+        return;
+    }
+
+    // Only counts that are a plain member of the same struct are followed, rather than
+    // expressions such as `(rasterizationSamples + 31) / 32`
+    bool hasCount = false;
+    if (member.altlen == member.len) {
+        for (auto const &it : members) {
+            if (it.name == len && it.pointerDepth == 0 && it.sizeEnum.empty())
+                hasCount = true;
+        }
+    }
+    if (!hasCount) {
+        out << "    printOpaque(printer, " << value << ");\n";
+        return;
+    }
+
+    std::string const countArgs = value + ", value." + std::string{len};
+    if (member.pointerDepth == 1) {
+        if (type == "void") {
+            out << "    printBytes(printer, " << countArgs << ");\n";
+        } else if (category == "handle") {
+            out << "    printHandleArray(printer, " << countArgs << ");\n";
+        } else if (isFlags) {
+            out << "    printFlagsArray(printer, " << countArgs << ", " << flagNames() << ");\n";
+        } else if (types.printable(type)) {
+            out << "    printArray(printer, " << countArgs << ");\n";
+            useEnum();
+        } else {
+            out << "    printOpaque(printer, " << value << ");\n";
+        }
+    } else if (member.pointerDepth == 2 &&
+               ((type == "char" && lenRest == "null-terminated") || category == "struct" ||
+                category == "union")) {
+        out << "    printArray(printer, " << countArgs << ");\n";
+    } else {
+        out << "    printOpaque(printer, " << value << ");\n";
+    }
+}
+
+// Returns the flag bits types of 64 bits, which are constants rather than an enum
+std::set<std::string_view> getWideEnums(rapidxml::xml_node<> *registryNode) {
+    std::set<std::string_view> wideEnums;
+
+    for (auto *enumsNode = registryNode->first_node("enums"); enumsNode != nullptr;
+         enumsNode = enumsNode->next_sibling("enums")) {
+        auto *nameAttr = enumsNode->first_attribute("name");
+        auto *bitwidthAttr = enumsNode->first_attribute("bitwidth");
+        if (nameAttr != nullptr && bitwidthAttr != nullptr &&
+            strcmp(bitwidthAttr->value(), "64") == 0)
+            wideEnums.insert(nameAttr->value());
+    }
+
+    return wideEnums;
+}
+
+// Returns the prefix of the values of an enum or flag bits type, such as 'VK_CULL_MODE_'
+std::string getValuePrefix(std::vector<std::string> const &vendors, std::string_view typeName) {
+    typeName = removeVendorTag(vendors, typeName);
+
+    // Values of types such as VkPipelineStageFlagBits2 are named 'VK_PIPELINE_STAGE_2_*'
+    if (typeName.ends_with("FlagBits2")) {
+        typeName.remove_suffix(1);
+        return processEnumPrefix(typeName) + "2_";
+    }
+    return processEnumPrefix(typeName);
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_struct_printer.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    // Vendor tags, stripped from the names of values
+    auto *tagsNode = registryNode->first_node("tags");
+    if (tagsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'tags' node." << std::endl;
+        return 1;
+    }
+
+    auto vendors = getVendorTags(tagsNode);
+
+    // Need to be in the 'types' node
+    auto *typesNode = registryNode->first_node("types");
+    if (typesNode == nullptr) {
+        std::cerr << "Error: Could not find the 'types' node." << std::endl;
+        return 1;
+    }
+
+    auto categories = getTypeCategories(typesNode);
+    auto aliases = getTypeAliases(typesNode);
+    auto flags = getFlagsData(typesNode);
+    auto scalars = getScalarTypes(typesNode);
+    auto wideEnums = getWideEnums(registryNode);
+    auto requiredTypes = getRequiredTypes(registryNode);
+    TypeInfo const types{categories, aliases, scalars, wideEnums};
+
+    // Only the structs and unions that are in the header, being neither aliases nor from disabled
+    // extensions
+    auto getRequired = [&](std::string_view category) {
+        std::vector<StructData> required;
+        for (auto &it : getStructData(typesNode, category)) {
+            auto requiredIt = requiredTypes.find(it.name);
+            if (aliases.contains(it.name) || requiredIt == requiredTypes.end())
+                continue;
+            it.platform = requiredIt->second;
+            required.push_back(std::move(it));
+        }
+        return required;
+    };
+    auto structs = getRequired("struct");
+    auto unions = getRequired("union");
+
+    // The sType value of each struct that has one
+    std::map<std::string_view, std::string_view> sTypes;
+    for (auto const &it : structs) {
+        for (auto const &member : it.members) {
+            if (member.name == "sType" && !member.values.empty())
+                sTypes[it.name] = member.values;
+        }
+    }
+
+    // Member printing, which also decides the enums and flag bits that need names
+    UsedNames usedNames;
+    std::map<std::string_view, std::string> memberPrints;
+    for (auto const *pList : {&structs, &unions}) {
+        for (auto const &it : *pList) {
+            std::ostringstream prints;
+            for (auto const &member : it.members)
+                writeMemberPrint(prints, it.members, member, types, flags, usedNames);
+            memberPrints[it.name] = prints.str();
+        }
+    }
+
+    auto getTypePlatformDefine = [&](std::string_view typeName) -> std::string_view {
+        auto requiredIt = requiredTypes.find(typeName);
+        if (requiredIt == requiredTypes.end() || requiredIt->second.empty())
+            return {};
+        for (auto const &platform : platforms) {
+            if (platform.name == requiredIt->second)
+                return platform.define;
+        }
+        return {};
+    };
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_STRUCT_PRINTER_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_STRUCT_PRINTER_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    outFile << declarationStr;
+
+    outFile << printDoc;
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "void vk_print(" << it.name << " const &value, VkPrintSink &sink);\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n#ifdef VK_STRUCT_PRINTER_CONFIG_MAIN\n";
+
+    outFile << sinkStr;
+    outFile << detailStr;
+
+    // Value names, in the same form as the value serialization
+    outFile << "\nnamespace vk_struct_printer_detail {\n";
+    for (auto const &typeName : usedNames.tables) {
+        std::string_view platformDefine = getTypePlatformDefine(typeName);
+        bool const isWide = wideEnums.contains(typeName);
+        std::string const prefix = getValuePrefix(vendors, typeName);
+
+        // Enumerants with the same value only have the first name, with 64-bit flag bits sorted
+        // as unsigned so that the high bit is last
+        std::map<uint64_t, std::string_view> wideNames;
+        std::map<int64_t, std::string_view> names;
+        for (auto const &[valueName, value] : getEnumValues(registryNode, typeName)) {
+            if (isWide)
+                wideNames.try_emplace(static_cast<uint64_t>(value.value), valueName);
+            else
+                names.try_emplace(value.value, valueName);
+        }
+
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+        if (names.empty() && wideNames.empty()) {
+            outFile << "\nconstexpr std::span<ValueName const> c" << typeName << "Names{};\n";
+        } else {
+            outFile << "\nconstexpr ValueName c" << typeName << "Names[] = {\n";
+            for (auto const &[value, valueName] : names) {
+                outFile << "    {\"" << getValueName(vendors, prefix, valueName) << "\", " << value
+                        << "},\n";
+            }
+            for (auto const &[value, valueName] : wideNames) {
+                outFile << "    {\"" << getValueName(vendors, prefix, valueName)
+                        << "\", static_cast<int64_t>(" << toHex(value) << "ULL)},\n";
+            }
+            outFile << "};\n";
+        }
+        if (usedNames.enums.contains(typeName)) {
+            outFile << "\nvoid printValue(Printer &printer, " << typeName << " value) {\n";
+            outFile << "    printEnum(printer, value, c" << typeName << "Names);\n";
+            outFile << "}\n";
+        }
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    // The printers of each struct and union call each other, so are all declared first
+    outFile << "\n";
+    for (auto const *pList : {&unions, &structs}) {
+        for (auto const &it : *pList) {
+            std::string_view platformDefine = getPlatformDefine(it, platforms);
+            if (!platformDefine.empty())
+                outFile << "#ifdef " << platformDefine << "\n";
+            outFile << "void printValue(Printer &printer, " << it.name << " const &value);\n";
+            if (!platformDefine.empty())
+                outFile << "#endif // " << platformDefine << "\n";
+        }
+    }
+    outFile << "\n} // namespace vk_struct_printer_detail\n";
+
+    outFile << helperStr;
+
+    outFile << "\nnamespace vk_struct_printer_detail {\n";
+    for (auto const *pList : {&unions, &structs}) {
+        for (auto const &it : *pList) {
+            std::string_view platformDefine = getPlatformDefine(it, platforms);
+            if (!platformDefine.empty())
+                outFile << "\n#ifdef " << platformDefine;
+            outFile << "\nvoid printValue(Printer &printer, " << it.name << " const &value) {\n";
+            outFile << "    printer.beginStruct(\"" << it.name << "\");\n";
+            outFile << memberPrints[it.name];
+            outFile << "    printer.endStruct();\n";
+            outFile << "}\n";
+            if (!platformDefine.empty())
+                outFile << "#endif // " << platformDefine << "\n";
+        }
+    }
+
+    // Structs found by their sType, such as in a pNext chain
+    outFile << "\nvoid printChained(Printer &printer, VkBaseInStructure const *pStruct) {\n";
+    outFile << "    switch (pStruct->sType) {\n";
+    for (auto const &it : structs) {
+        auto sTypeIt = sTypes.find(it.name);
+        if (sTypeIt == sTypes.end())
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "    case " << sTypeIt->second << ":\n";
+        outFile << "        printValue(printer, *reinterpret_cast<" << it.name
+                << " const *>(pStruct));\n";
+        outFile << "        return;\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "    default:\n";
+    outFile << "        printer.write(\"unknown sType \");\n";
+    outFile << "        printNumber(printer, static_cast<int64_t>(pStruct->sType));\n";
+    outFile << "    }\n";
+    outFile << "}\n";
+    outFile << "\n} // namespace vk_struct_printer_detail\n";
+
+    outFile << chainStr;
+
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+        outFile << "\nvoid vk_print(" << it.name << " const &value, VkPrintSink &sink) {\n";
+        outFile << "    vk_struct_printer_detail::printTo(sink, value);\n";
+        outFile << "}\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n#endif // VK_STRUCT_PRINTER_CONFIG_MAIN\n";
+
+    // Finish Up
+    outFile << "\n#endif // VK_STRUCT_PRINTER_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
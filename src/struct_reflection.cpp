@@ -0,0 +1,769 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "dense_table.hpp"
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where the reflection tables are required. The tables are all
+    constexpr, so there is nothing else to define.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains constexpr reflection tables for every
+Vulkan struct and union, with the name, offset, size and kind of each member,
+along with the type of its elements and which member counts them, looked up by
+type or by sType. Also maps between struct types and sType values, both at
+compile time and through a dense table at runtime, and builds pNext chains of
+structs held by value.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_struct_reflection.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// How a struct member, or the elements it refers to, is stored
+enum class VkMemberKind : uint8_t {
+    /// Plain value, such as a `uint32_t`, `float` or `VkBool32`, or an externally defined type
+    Scalar,
+    Enum,
+    Flags,
+    Handle,
+    FunctionPointer,
+    /// Struct or union held by value
+    Struct,
+    Union,
+    /// In-place array, such as `float blendConstants[4]`
+    FixedArray,
+    /// The `pNext` chain
+    Next,
+    /// Pointer to a single element, or to data without a count
+    Pointer,
+    /// Pointer to a counted number of elements
+    Array,
+    /// Pointer to a counted number of pointers, each to a single element
+    PointerArray,
+    /// Null-terminated string
+    String,
+    /// Pointer to a counted number of null-terminated strings
+    StringArray,
+};
+
+)DECL";
+
+std::string_view infoStr = R"INFO(
+/// Index of the counting member, for members that aren't counted by another
+constexpr uint32_t cVkNoCountMember = UINT32_MAX;
+
+/// Reflection data of a single struct member
+struct VkMemberInfo {
+    char const *name;
+    uint32_t offset;
+    uint32_t size;
+    VkMemberKind kind;
+    /// Kind of the value, or for arrays and pointers, of each element pointed to
+    VkMemberKind elementKind;
+    /// Type of the value, or for arrays and pointers, of each element pointed to
+    VkTypeId elementType;
+    /// Size of each element of FixedArray, Array and PointerArray members, or of what Pointer
+    /// members point to, where it is known, with `void` data counted in bytes, otherwise 0
+    uint32_t elementSize;
+    /// For Array, PointerArray and StringArray members, the index of the member with the number
+    /// of elements, if it is one
+    uint32_t countMember;
+    /// For FixedArray members, the total number of elements, otherwise 1
+    uint32_t fixedCount;
+    bool optional;
+};
+
+/// Reflection data of a struct or union
+struct VkStructInfo {
+    char const *name;
+    VkTypeId type;
+    /// The value of `sType`, or cVkNoStructureType for types without one
+    VkStructureType sType;
+    uint32_t size;
+    uint32_t alignment;
+    bool isUnion;
+    VkMemberInfo const *pMembers;
+    uint32_t memberCount;
+};
+
+constexpr VkStructureType cVkNoStructureType = static_cast<VkStructureType>(0x7FFFFFFF);
+
+/// Maps a struct type to its VkTypeId, for each type that has reflection data
+template <typename T>
+struct VkTypeIdOf;
+
+/// Maps a struct type to the value of its `sType`, for each struct that has one
+template <typename T>
+struct VkSTypeOf;
+
+/// Maps an sType value to the struct type used with it
+template <VkStructureType S>
+struct VkTypeForSType;
+
+/// Name, size and alignment of the struct used with an sType
+struct VkSTypeInfo {
+    VkStructureType sType;
+    char const *name;
+    /// Zero for platform structs whose platform define isn't enabled
+    uint32_t size;
+    uint32_t alignment;
+};
+
+namespace vk_struct_reflection_detail {
+)INFO";
+
+std::string_view lookupDocStr = R"DOC(
+/** @brief Returns the reflection data of a struct or union type
+ * @param type Type to look up
+ * @return Pointer to the reflection data, or nullptr if the type isn't a struct or union with
+ * reflection data
+ */
+)DOC";
+
+std::string_view sTypeLookupDocStr = R"DOC(
+/** @brief Returns the reflection data of the struct with the given sType
+ * @param sType Structure type to look up
+ * @return Pointer to the reflection data, or nullptr if the sType is unknown
+ */
+)DOC";
+
+std::string_view templateLookupStr = R"DOC(
+/// Returns the reflection data of a struct or union type, known at compile time
+template <typename T>
+constexpr VkStructInfo const &vk_struct_info() noexcept {
+    return *vk_struct_info(VkTypeIdOf<T>::value);
+}
+)DOC";
+
+std::string_view sTypeTraitsStr = R"TRAITS(
+/// The `sType` value of a struct type, known at compile time
+template <typename T>
+inline constexpr VkStructureType vk_stype_v = VkSTypeOf<T>::value;
+
+/// The struct type used with an sType value, known at compile time
+template <VkStructureType S>
+using vk_type_for_stype = typename VkTypeForSType<S>::type;
+)TRAITS";
+
+std::string_view chainStr = R"CHAIN(
+namespace vk_struct_reflection_detail {
+
+template <typename T, typename... Ts>
+constexpr std::size_t cTypeCount = (std::size_t{std::is_same_v<T, Ts>} + ... + 0);
+
+} // namespace vk_struct_reflection_detail
+
+/** @brief A pNext chain of structs held by value in a single object
+ *
+ * The structs are linked in the order given, with the first as the root passed to Vulkan. Each
+ * has its sType set from vk_stype_v, and the pNext of each but the last set to the next struct,
+ * whenever the chain is constructed or copied. The pNext of the last struct is left as given, so
+ * that the chain can be continued elsewhere.
+ *
+ * Structs are accessed with `get<T>(chain)`, resolved at compile time to a fixed offset within the
+ * chain rather than following pNext. Each struct type can be in a chain only once.
+ */
+template <typename... Ts>
+class VkStructChain {
+    static_assert(sizeof...(Ts) > 0, "A chain needs at least one struct");
+    static_assert(((vk_struct_reflection_detail::cTypeCount<Ts, Ts...> == 1) && ...),
+                  "Each struct type can only be in a chain once");
+
+  public:
+    constexpr VkStructChain() noexcept { link(std::index_sequence_for<Ts...>{}); }
+    constexpr explicit VkStructChain(Ts const &...structs) noexcept : mStructs{structs...} {
+        link(std::index_sequence_for<Ts...>{});
+    }
+    constexpr VkStructChain(VkStructChain const &other) noexcept : mStructs{other.mStructs} {
+        link(std::index_sequence_for<Ts...>{});
+    }
+    constexpr VkStructChain &operator=(VkStructChain const &other) noexcept {
+        mStructs = other.mStructs;
+        link(std::index_sequence_for<Ts...>{});
+        return *this;
+    }
+
+    /// Returns the struct of the given type in the chain
+    template <typename T>
+    constexpr T &get() noexcept {
+        static_assert(vk_struct_reflection_detail::cTypeCount<T, Ts...> == 1,
+                      "The struct type is not in the chain");
+        return std::get<T>(mStructs);
+    }
+    template <typename T>
+    constexpr T const &get() const noexcept {
+        static_assert(vk_struct_reflection_detail::cTypeCount<T, Ts...> == 1,
+                      "The struct type is not in the chain");
+        return std::get<T>(mStructs);
+    }
+
+    /// Returns the first struct, at the start of the chain
+    constexpr auto *root() noexcept { return &std::get<0>(mStructs); }
+    constexpr auto const *root() const noexcept { return &std::get<0>(mStructs); }
+
+  private:
+    template <std::size_t... Is>
+    constexpr void link(std::index_sequence<Is...>) noexcept {
+        ((std::get<Is>(mStructs).sType = vk_stype_v<Ts>), ...);
+        ((linkNext<Is>()), ...);
+    }
+
+    template <std::size_t I>
+    constexpr void linkNext() noexcept {
+        if constexpr (I + 1 < sizeof...(Ts))
+            std::get<I>(mStructs).pNext = &std::get<I + 1>(mStructs);
+    }
+
+    std::tuple<Ts...> mStructs{};
+};
+
+/// Returns the struct of the given type in the chain
+template <typename T, typename... Ts>
+constexpr T &get(VkStructChain<Ts...> &chain) noexcept {
+    return chain.template get<T>();
+}
+template <typename T, typename... Ts>
+constexpr T const &get(VkStructChain<Ts...> const &chain) noexcept {
+    return chain.template get<T>();
+}
+
+/** @brief Finds the struct of the given type in any pNext chain, by following it
+ * @param pChain First struct of the chain to search, which may be null
+ * @return Pointer to the first struct of the type in the chain, or nullptr if there is none
+ */
+template <typename T>
+T const *vk_find_in_chain(void const *pChain) noexcept {
+    auto const *pStruct = static_cast<VkBaseOutStructure const *>(pChain);
+    while (pStruct != nullptr) {
+        if (pStruct->sType == vk_stype_v<T>)
+            return reinterpret_cast<T const *>(pStruct);
+        pStruct = pStruct->pNext;
+    }
+    return nullptr;
+}
+template <typename T>
+T *vk_find_in_chain(void *pChain) noexcept {
+    return const_cast<T *>(vk_find_in_chain<T>(static_cast<void const *>(pChain)));
+}
+)CHAIN";
+
+std::string_view sTypeInfoDocStr = R"DOC(
+/** @brief Returns the name, size and alignment of the struct used with an sType
+ * @param sType Structure type to look up
+ * @return Pointer to the struct data, or nullptr if the sType is unknown
+ *
+ * Rather than a switch, the sType value indexes directly into a table of the core values or of
+ * those of its extension, so that the lookup takes the same time for any sType.
+ */
+constexpr VkSTypeInfo const *vk_stype_info(VkStructureType sType) noexcept {
+    using namespace vk_struct_reflection_detail;
+    uint32_t const index = findSTypeIndex(sType);
+    return (index == 0) ? nullptr : &cSTypeInfos[index];
+}
+)DOC";
+
+// Types without a registry category that map to a VkTypeId
+std::map<std::string_view, std::string_view> const cBuiltinTypes = {
+    {"void", "Void"},      {"char", "Char"},      {"float", "Float"},    {"double", "Double"},
+    {"int8_t", "Int8"},    {"uint8_t", "UInt8"},  {"int16_t", "Int16"},  {"uint16_t", "UInt16"},
+    {"int32_t", "Int32"},  {"uint32_t", "UInt32"}, {"int64_t", "Int64"}, {"uint64_t", "UInt64"},
+    {"size_t", "Size"},    {"int", "Int"},
+};
+
+// Registry categories of the types that get a VkTypeId, and the kind of member each makes
+std::map<std::string_view, std::string_view> const cCategoryKinds = {
+    {"basetype", "Scalar"}, {"enum", "Enum"},   {"bitmask", "Flags"},
+    {"handle", "Handle"},   {"funcpointer", "FunctionPointer"},
+    {"struct", "Struct"},   {"union", "Union"},
+};
+
+struct TypeInfo {
+    std::map<std::string_view, std::string_view> const &categories;
+    std::map<std::string_view, std::string_view> const &aliases;
+
+    std::string_view resolve(std::string_view type) const {
+        while (aliases.contains(type))
+            type = aliases.at(type);
+        return type;
+    }
+
+    // The VkTypeId enumerator of a type, where 'Unknown' is for types from external headers
+    std::string_view typeId(std::string_view type) const {
+        type = resolve(type);
+        if (auto it = categories.find(type);
+            it != categories.end() && cCategoryKinds.contains(it->second))
+            return type;
+        if (auto it = cBuiltinTypes.find(type); it != cBuiltinTypes.end())
+            return it->second;
+        return "Unknown";
+    }
+
+    // The kind of a member of the type, held by value
+    std::string_view valueKind(std::string_view type) const {
+        type = resolve(type);
+        if (auto it = categories.find(type); it != categories.end()) {
+            if (auto kindIt = cCategoryKinds.find(it->second); kindIt != cCategoryKinds.end())
+                return kindIt->second;
+        }
+        return "Scalar";
+    }
+};
+
+std::vector<std::string> splitLen(std::string const &len) {
+    std::vector<std::string> parts;
+    std::istringstream lenStream(len);
+    std::string part;
+    while (std::getline(lenStream, part, ','))
+        parts.emplace_back(part);
+    return parts;
+}
+
+void writeMemberInfo(std::ostream &out, StructData const &structData, TypeInfo const &types) {
+    for (auto const &mem : structData.members) {
+        std::string_view kind = types.valueKind(mem.type);
+        std::string_view elementKind = kind;
+        std::string_view elementType = types.typeId(mem.type);
+        std::string countMember = "cVkNoCountMember";
+        std::string fixedCount = "1";
+
+        if (!mem.sizeEnum.empty()) {
+            kind = "FixedArray";
+            fixedCount = "sizeof(" + std::string{structData.name} + "::" +
+                         std::string{mem.name} + ") / sizeof(" + std::string{mem.type} + ")";
+        } else if (mem.name == "pNext") {
+            kind = "Next";
+        } else if (mem.typeSuffix == "*") {
+            auto lenParts = splitLen(mem.len);
+            if (lenParts.empty()) {
+                kind = "Pointer";
+            } else if (lenParts[0] == "null-terminated") {
+                kind = "String";
+            } else if (lenParts.size() > 1 && lenParts[1] == "null-terminated") {
+                kind = "StringArray";
+                elementKind = "String";
+            } else if (lenParts.size() > 1 && lenParts[1] == "1") {
+                kind = "PointerArray";
+            } else {
+                kind = "Array";
+            }
+
+            // Only where the count is another member, rather than an expression
+            if (!lenParts.empty()) {
+                for (std::size_t i = 0; i < structData.members.size(); ++i) {
+                    if (structData.members[i].name == lenParts[0])
+                        countMember = std::to_string(i);
+                }
+            }
+        }
+
+        // Types from external headers may be incomplete, so have no size
+        std::string elementSize = "0";
+        bool const arrayKind = kind == "FixedArray" || kind == "Array" || kind == "PointerArray";
+        if (elementType == "Void") {
+            if (kind == "Array")
+                elementSize = "1";
+        } else if (elementType != "Unknown" && (arrayKind || kind == "Pointer")) {
+            // Pointers without a count may be to opaque basetypes, such as ANativeWindow
+            if (arrayKind || elementKind != "Scalar" || cBuiltinTypes.contains(mem.type))
+                elementSize = "sizeof(" + std::string{mem.type} + ")";
+        }
+
+        out << "    {\"" << mem.name << "\", offsetof(" << structData.name << ", " << mem.name
+            << "), sizeof(" << structData.name << "::" << mem.name << "), VkMemberKind::" << kind
+            << ", VkMemberKind::" << elementKind << ", VkTypeId::" << elementType << ", "
+            << elementSize << ", " << countMember << ", " << fixedCount << ", "
+            << (mem.optional ? "true" : "false") << "},\n";
+    }
+}
+
+// Whether reflection data can be generated for the type
+bool reflectStruct(StructData const &structData) {
+    // Aliases are the same C++ type as what they alias
+    if (structData.members.empty())
+        return false;
+
+    for (auto const &mem : structData.members) {
+        if (mem.bitfield) {
+            std::cout << "Info: Skipping Vk structure " << structData.name
+                      << " that has bitfield members" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
+std::string_view getSType(StructData const &structData) {
+    for (auto const &mem : structData.members) {
+        if (mem.type == "VkStructureType" && mem.name == "sType" && !mem.values.empty())
+            return mem.values;
+    }
+    return {};
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_struct_reflection.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    // Need to be in the 'types' node
+    auto *typesNode = registryNode->first_node("types");
+    if (typesNode == nullptr) {
+        std::cerr << "Error: Could not find the 'types' node." << std::endl;
+        return 1;
+    }
+
+    auto structs = getStructData(typesNode);
+    auto unions = getStructData(typesNode, "union");
+    auto categories = getTypeCategories(typesNode);
+    auto aliases = getTypeAliases(typesNode);
+    auto sTypeValues = getEnumValues(registryNode, "VkStructureType");
+
+    // Extensions for type platforms
+    auto *extensionsNode = registryNode->first_node("extensions");
+    if (extensionsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'extensions' node." << std::endl;
+        return 1;
+    }
+
+    getStructPlatforms(structs, extensionsNode);
+    getStructPlatforms(unions, extensionsNode);
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    TypeInfo const types{categories, aliases};
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_STRUCT_REFLECTION_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_STRUCT_REFLECTION_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\" );\n";
+
+    outFile << declarationStr;
+
+    // Type IDs, for every type that can be a member
+    outFile << "/// Identifies the type of a member, or the elements it refers to\n";
+    outFile << "enum class VkTypeId : uint16_t {\n";
+    outFile << "    /// Types from external headers, such as platform types\n";
+    outFile << "    Unknown,\n";
+    for (auto const &[builtin, id] : cBuiltinTypes)
+        outFile << "    " << id << ",\n";
+    for (auto const &[name, category] : categories) {
+        if (cCategoryKinds.contains(category) && !aliases.contains(name))
+            outFile << "    " << name << ",\n";
+    }
+    outFile << "};\n";
+
+    outFile << infoStr;
+
+    std::vector<std::pair<StructData const *, bool>> reflected;
+    for (auto const &it : structs) {
+        if (reflectStruct(it))
+            reflected.emplace_back(&it, false);
+    }
+    for (auto const &it : unions) {
+        if (reflectStruct(it))
+            reflected.emplace_back(&it, true);
+    }
+
+    for (auto const &[pStruct, isUnion] : reflected) {
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+
+        std::string_view sType = getSType(*pStruct);
+        outFile << "\ninline constexpr VkMemberInfo c" << pStruct->name << "Members[] = {\n";
+        writeMemberInfo(outFile, *pStruct, types);
+        outFile << "};\n";
+        outFile << "inline constexpr VkStructInfo c" << pStruct->name << "Info{\n";
+        outFile << "    \"" << pStruct->name << "\", VkTypeId::" << pStruct->name << ", "
+                << (sType.empty() ? "cVkNoStructureType" : sType) << ",\n";
+        outFile << "    sizeof(" << pStruct->name << "), alignof(" << pStruct->name << "), "
+                << (isUnion ? "true" : "false") << ", c" << pStruct->name << "Members, "
+                << pStruct->members.size() << "};\n";
+
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n} // namespace vk_struct_reflection_detail\n";
+
+    // Lookup by type
+    outFile << lookupDocStr;
+    outFile << "constexpr VkStructInfo const *vk_struct_info(VkTypeId type) noexcept {\n";
+    outFile << "    using namespace vk_struct_reflection_detail;\n";
+    outFile << "    switch (type) {\n";
+    for (auto const &[pStruct, isUnion] : reflected) {
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "    case VkTypeId::" << pStruct->name << ":\n";
+        outFile << "        return &c" << pStruct->name << "Info;\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "    default:\n";
+    outFile << "        return nullptr;\n";
+    outFile << "    }\n";
+    outFile << "}\n";
+
+    // Lookup by sType
+    outFile << sTypeLookupDocStr;
+    outFile << "constexpr VkStructInfo const *vk_struct_info(VkStructureType sType) noexcept {\n";
+    outFile << "    using namespace vk_struct_reflection_detail;\n";
+    outFile << "    switch (sType) {\n";
+    for (auto const &[pStruct, isUnion] : reflected) {
+        std::string_view sType = getSType(*pStruct);
+        if (sType.empty())
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "    case " << sType << ":\n";
+        outFile << "        return &c" << pStruct->name << "Info;\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "    default:\n";
+    outFile << "        return nullptr;\n";
+    outFile << "    }\n";
+    outFile << "}\n";
+
+    // Compile-time mapping of types
+    outFile << "\n";
+    for (auto const &[pStruct, isUnion] : reflected) {
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "template <>\n";
+        outFile << "struct VkTypeIdOf<" << pStruct->name << "> {\n";
+        outFile << "    static constexpr VkTypeId value = VkTypeId::" << pStruct->name << ";\n";
+        outFile << "};\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << templateLookupStr;
+
+    // Structs with an sType, each with a single value, in the order of the table of them
+    std::vector<std::pair<StructData const *, int64_t>> sTypeStructs;
+    {
+        std::map<int64_t, std::string_view> usedValues;
+        for (auto const &it : structs) {
+            std::string_view sType = getSType(it);
+            if (it.members.empty() || sType.empty())
+                continue;
+
+            auto valueIt = sTypeValues.find(sType);
+            if (valueIt == sTypeValues.end() || valueIt->second.value < 0) {
+                std::cout << "Info: Skipping sType traits of " << it.name
+                          << ", as the value of " << sType << " is unknown" << std::endl;
+                continue;
+            }
+            if (usedValues.contains(valueIt->second.value)) {
+                std::cout << "Info: Skipping sType traits of " << it.name << ", as " << sType
+                          << " is already used by " << usedValues.at(valueIt->second.value)
+                          << std::endl;
+                continue;
+            }
+
+            usedValues[valueIt->second.value] = it.name;
+            sTypeStructs.emplace_back(&it, valueIt->second.value);
+        }
+    }
+
+    // Compile-time sType traits
+    outFile << "\n";
+    for (auto const &[pStruct, value] : sTypeStructs) {
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "template <>\n";
+        outFile << "struct VkSTypeOf<" << pStruct->name << "> {\n";
+        outFile << "    static constexpr VkStructureType value = " << getSType(*pStruct)
+                << ";\n";
+        outFile << "};\n";
+        outFile << "template <>\n";
+        outFile << "struct VkTypeForSType<" << getSType(*pStruct) << "> {\n";
+        outFile << "    using type = " << pStruct->name << ";\n";
+        outFile << "};\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << sTypeTraitsStr;
+    outFile << chainStr;
+
+    // Runtime sType table, where index 0 is for unknown values
+    DenseIndexTable sTypeIndices;
+    for (std::size_t i = 0; i < sTypeStructs.size(); ++i)
+        sTypeIndices.at(sTypeStructs[i].second) = i + 1;
+
+    outFile << "\nnamespace vk_struct_reflection_detail {\n";
+
+    outFile << "\ninline constexpr VkSTypeInfo cSTypeInfos[] = {\n";
+    outFile << "    {cVkNoStructureType, nullptr, 0, 0},\n";
+    for (auto const &[pStruct, value] : sTypeStructs) {
+        std::string_view platformDefine = getPlatformDefine(*pStruct, platforms);
+        std::string_view name = pStruct->name;
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "    {" << getSType(*pStruct) << ", \"" << name << "\", sizeof(" << name
+                << "), alignof(" << name << ")},\n";
+        if (!platformDefine.empty()) {
+            outFile << "#else\n";
+            outFile << "    {" << getSType(*pStruct) << ", \"" << name << "\", 0, 0},\n";
+            outFile << "#endif // " << platformDefine << "\n";
+        }
+    }
+    outFile << "};\n";
+
+    sTypeIndices.write(outFile, {"SType", "VkStructureType", "cSTypeInfos", "sType"});
+
+    outFile << "\n} // namespace vk_struct_reflection_detail\n";
+
+    outFile << sTypeInfoDocStr;
+
+    // Finish Up
+    outFile << "\n#endif // VK_STRUCT_REFLECTION_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
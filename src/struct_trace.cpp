@@ -0,0 +1,839 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where structs are to be captured or decoded. This depends on the
+    `vk_struct_reflection.hpp` header, and for capturing, on the `vk_struct_cleanup.hpp` header to
+    copy the structs.
+
+    On *ONE* compilation unit of the program capturing structs, include the definition of
+    `#define VK_STRUCT_TRACE_CONFIG_MAIN`, along with `#define VK_STRUCT_CLEANUP_CONFIG_MAIN`, so
+    that the definitions are compiled somewhere following the one definition rule.
+
+    On *ONE* compilation unit of the program decoding traces, include the definition of
+    `#define VK_STRUCT_TRACE_CONFIG_DECODE` instead, which only needs the reflection tables.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains `vk_trace` functions for every Vulkan
+struct with an sType, which copy the struct, along with its pNext chain and
+everything it points to, as raw bytes into a per-thread ring buffer, to be
+drained out as a binary trace and decoded back into structs later, such as by a
+separate tool that prints them.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_struct_trace.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+#include <cstddef>
+#include <cstdint>
+
+#ifndef VK_STRUCT_TRACE_RING_SIZE
+/// Size in bytes of the ring buffer each thread captures into, which must be a power of two
+#define VK_STRUCT_TRACE_RING_SIZE (1u << 20)
+#endif
+
+/** @brief Captures a Vulkan sType-based struct, found by its sType, into the trace
+ * @param pStruct Pointer to the struct to capture, which must have an sType, or null
+ * @return True if captured, or false if pStruct is null or of an unknown type, or if there
+ * wasn't room for it in the ring buffer of the calling thread
+ *
+ * Captures the same as `vk_trace` given the struct itself.
+ */
+bool vk_trace_struct(void const *pStruct);
+
+/** @brief Writes the header a trace starts with, before anything drained into it
+ * @param pfnWrite Called with the bytes to write out, such as to a file
+ * @param pUserData Passed through to pfnWrite
+ *
+ * The header has the VK_HEADER_VERSION and pointer size the structs were captured with, as they
+ * can only be decoded by a program built with the same.
+ */
+void vk_trace_write_header(void (*pfnWrite)(void const *pData, std::size_t size, void *pUserData),
+                           void *pUserData);
+
+/** @brief Moves everything captured so far, by every thread, out of their ring buffers
+ * @param pfnWrite Called with the bytes to write out, such as to a file
+ * @param pUserData Passed through to pfnWrite
+ * @return Number of captured structs written out
+ *
+ * The captures of each thread are written out in order, as one or two runs of bytes each, and
+ * are removed from the ring buffer once written. Draining can be done on any thread, such as a
+ * background one, at the same time as capturing, but only by one thread at a time.
+ */
+std::size_t vk_trace_drain(void (*pfnWrite)(void const *pData, std::size_t size, void *pUserData),
+                           void *pUserData);
+
+/// Number of captures that were dropped for not fitting in the ring buffer of their thread
+uint64_t vk_trace_dropped();
+
+/// A captured struct, as decoded from a trace
+struct VkTraceRecord {
+    /// Type of the captured struct
+    VkTypeId type;
+    /// Index of the capturing thread, in the order that threads first captured
+    uint16_t thread;
+    /// Number of the capture within its thread, including dropped ones, so gaps are drops
+    uint64_t sequence;
+    /// The decoded struct, which is only valid until the callback returns
+    void const *pStruct;
+};
+
+/** @brief Decodes a trace back into the structs captured into it
+ * @param pData The trace, starting with the header from `vk_trace_write_header`
+ * @param size Size of the trace in bytes
+ * @param pfnRecord Called with each struct, in the order they are in the trace
+ * @param pUserData Passed through to pfnRecord
+ * @return True if the whole trace was decoded, or false if the trace is from a different
+ * VK_HEADER_VERSION or pointer size, or is truncated or invalid, in which case pfnRecord is only
+ * called for the structs before the problem
+ *
+ * Each struct is copied out of the trace, then the pointers within it are fixed up to point into
+ * the copy, going by the reflection tables of each struct type, so the struct can be used as
+ * normal, such as printed with `vk_print_struct`. Pointers to data that wasn't captured are null,
+ * except for those that are never followed, such as `pUserData`, which keep the captured address.
+ */
+bool vk_trace_decode(void const *pData,
+                     std::size_t size,
+                     void (*pfnRecord)(VkTraceRecord const &record, void *pUserData),
+                     void *pUserData);
+)DECL";
+
+std::string_view traceDoc = R"DOC(
+/** @brief Captures a Vulkan struct, along with everything it points to, into the trace
+ * @param value Struct to capture
+ * @return True if captured, or false if there wasn't room for it in the ring buffer of the
+ * calling thread
+ *
+ * The struct, its pNext chain and the arrays, strings and structs it points to are copied as raw
+ * bytes into a ring buffer belonging to the calling thread, after a small header with the type of
+ * the struct, so that nothing is formatted, locked or allocated while capturing, other than
+ * setting up the ring buffer the first time a thread captures. The pointers are left as-is, to be
+ * fixed up when decoded.
+ *
+ * Captures stay in the ring buffer until drained with `vk_trace_drain`. If there isn't room, the
+ * capture is dropped rather than waiting.
+ */
+)DOC";
+
+std::string_view recordStr = R"RECORD(
+#if defined(VK_STRUCT_TRACE_CONFIG_MAIN) || defined(VK_STRUCT_TRACE_CONFIG_DECODE)
+
+namespace vk_struct_trace_detail {
+
+struct StreamHeader {
+    uint32_t magic;
+    uint32_t headerVersion;
+    uint32_t pointerSize;
+    uint32_t reserved;
+};
+
+// Each capture is a header followed by the copied structs, padded to the record alignment
+struct RecordHeader {
+    uint32_t size;
+    /// The VkTypeId of the captured struct
+    uint16_t type;
+    uint16_t thread;
+    uint64_t sequence;
+    /// Address the copied structs were at when captured, to fix up the pointers within them
+    uint64_t base;
+};
+
+constexpr uint32_t cStreamMagic = 0x5254564B; // 'VKTR'
+// Keeps the copied structs aligned for any type, and leaves room for a header at the end of a
+// ring buffer, however full it is
+constexpr std::size_t cRecordAlignment = 32;
+constexpr std::size_t cDataOffset = cRecordAlignment;
+
+static_assert(sizeof(RecordHeader) <= cDataOffset && alignof(std::max_align_t) <= cDataOffset);
+
+} // namespace vk_struct_trace_detail
+
+#endif // VK_STRUCT_TRACE_CONFIG_MAIN || VK_STRUCT_TRACE_CONFIG_DECODE
+)RECORD";
+
+std::string_view captureStr = R"CAPTURE(
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace vk_struct_trace_detail {
+
+constexpr std::size_t cRingSize = VK_STRUCT_TRACE_RING_SIZE;
+/// Type of the records that skip the rest of a ring buffer, rather than splitting a capture
+constexpr uint16_t cPaddingType = UINT16_MAX;
+
+static_assert((cRingSize & (cRingSize - 1)) == 0 && cRingSize >= cRecordAlignment &&
+                  cRingSize <= UINT32_MAX,
+              "VK_STRUCT_TRACE_RING_SIZE must be a power of two");
+
+/// The captures of one thread, waiting to be drained. Only the capturing thread moves the head,
+/// and only the draining thread moves the tail, so neither needs a lock.
+struct Ring {
+    struct alignas(cRecordAlignment) Block {
+        std::byte bytes[cRecordAlignment];
+    };
+
+    explicit Ring(uint16_t thread) : thread{thread} {}
+
+    std::byte *data() noexcept { return pBlocks[0].bytes; }
+
+    std::unique_ptr<Block[]> pBlocks{new Block[cRingSize / cRecordAlignment]};
+    uint16_t const thread;
+    std::atomic<bool> retired{false};
+
+    alignas(64) std::atomic<uint64_t> head{0};
+    /// Only used by the capturing thread, so the tail is only loaded when short of room
+    uint64_t cachedTail = 0;
+    uint64_t sequence = 0;
+    std::atomic<uint64_t> dropped{0};
+
+    alignas(64) std::atomic<uint64_t> tail{0};
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Ring *> rings;
+    uint16_t nextThread = 0;
+    /// Drops of the rings of exited threads, which have since been freed
+    uint64_t retiredDropped = 0;
+};
+
+// Never destroyed, as detached threads may still be capturing during static destruction
+Registry &getRegistry() {
+    static auto *pRegistry = new Registry;
+    return *pRegistry;
+}
+
+// Retires the ring of a thread when it exits, to be freed by the next drain once emptied
+struct ThreadRing {
+    ~ThreadRing() {
+        if (pRing != nullptr)
+            pRing->retired.store(true, std::memory_order_release);
+    }
+
+    Ring *pRing = nullptr;
+};
+
+thread_local ThreadRing tThreadRing;
+
+Ring &getThreadRing() {
+    if (tThreadRing.pRing == nullptr) {
+        Registry &registry = getRegistry();
+        std::lock_guard<std::mutex> lock{registry.mutex};
+        auto pRing = std::make_unique<Ring>(registry.nextThread);
+        registry.rings.push_back(pRing.get());
+        ++registry.nextThread;
+        tThreadRing.pRing = pRing.release();
+    }
+    return *tThreadRing.pRing;
+}
+
+bool capture(void const *pStruct, VkTypeId type) {
+    std::size_t const size = vk_struct_deep_size(pStruct);
+    if (size == 0)
+        return false;
+
+    Ring &ring = getThreadRing();
+    uint64_t const sequence = ring.sequence++;
+    std::size_t const recordSize =
+        (cDataOffset + size + cRecordAlignment - 1) & ~(cRecordAlignment - 1);
+
+    // Captures aren't split across the end of the ring, which is skipped instead
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    std::size_t const index = head & (cRingSize - 1);
+    std::size_t const padding = (cRingSize - index < recordSize) ? cRingSize - index : 0;
+    if (head + padding + recordSize - ring.cachedTail > cRingSize) {
+        ring.cachedTail = ring.tail.load(std::memory_order_acquire);
+        if (head + padding + recordSize - ring.cachedTail > cRingSize) {
+            ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    std::byte *pData = ring.data();
+    if (padding != 0) {
+        RecordHeader const skip{static_cast<uint32_t>(padding), cPaddingType, ring.thread, 0, 0};
+        std::memcpy(pData + index, &skip, sizeof(RecordHeader));
+        head += padding;
+    }
+
+    std::byte *pRecord = pData + (head & (cRingSize - 1));
+    void *pCopy = vk_struct_clone_into(pStruct, pRecord + cDataOffset);
+    RecordHeader const header{static_cast<uint32_t>(recordSize), static_cast<uint16_t>(type),
+                              ring.thread, sequence, reinterpret_cast<uintptr_t>(pCopy)};
+    std::memcpy(pRecord, &header, sizeof(RecordHeader));
+
+    ring.head.store(head + recordSize, std::memory_order_release);
+    return true;
+}
+
+// Writes out the captures of one ring, with those next to each other written together
+std::size_t drainRing(Ring &ring,
+                      void (*pfnWrite)(void const *, std::size_t, void *),
+                      void *pUserData) {
+    uint64_t const head = ring.head.load(std::memory_order_acquire);
+    uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+    std::byte const *pData = ring.data();
+
+    std::size_t count = 0;
+    std::size_t runStart = 0;
+    std::size_t runSize = 0;
+    while (tail != head) {
+        std::size_t const index = tail & (cRingSize - 1);
+        RecordHeader header;
+        std::memcpy(&header, pData + index, sizeof(RecordHeader));
+        tail += header.size;
+
+        if (header.type != cPaddingType) {
+            if (runSize == 0)
+                runStart = index;
+            runSize += header.size;
+            ++count;
+        }
+        if (runSize != 0 && (header.type == cPaddingType || runStart + runSize == cRingSize)) {
+            pfnWrite(pData + runStart, runSize, pUserData);
+            runSize = 0;
+        }
+    }
+    if (runSize != 0)
+        pfnWrite(pData + runStart, runSize, pUserData);
+
+    ring.tail.store(tail, std::memory_order_release);
+    return count;
+}
+
+} // namespace vk_struct_trace_detail
+
+bool vk_trace_struct(void const *pStruct) {
+    if (pStruct == nullptr)
+        return false;
+
+    VkStructInfo const *pInfo =
+        vk_struct_info(static_cast<VkBaseInStructure const *>(pStruct)->sType);
+    if (pInfo == nullptr)
+        return false;
+
+    return vk_struct_trace_detail::capture(pStruct, pInfo->type);
+}
+
+void vk_trace_write_header(void (*pfnWrite)(void const *pData, std::size_t size, void *pUserData),
+                           void *pUserData) {
+    using namespace vk_struct_trace_detail;
+
+    StreamHeader const header{cStreamMagic, VK_HEADER_VERSION, sizeof(void *), 0};
+    pfnWrite(&header, sizeof(StreamHeader), pUserData);
+}
+
+std::size_t vk_trace_drain(void (*pfnWrite)(void const *pData, std::size_t size, void *pUserData),
+                           void *pUserData) {
+    using namespace vk_struct_trace_detail;
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    std::size_t count = 0;
+    for (auto it = registry.rings.begin(); it != registry.rings.end();) {
+        Ring *pRing = *it;
+        // Checked before draining, so a retired ring has nothing captured after the drain
+        bool const retired = pRing->retired.load(std::memory_order_acquire);
+        count += drainRing(*pRing, pfnWrite, pUserData);
+
+        if (retired) {
+            registry.retiredDropped += pRing->dropped.load(std::memory_order_relaxed);
+            delete pRing;
+            it = registry.rings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    return count;
+}
+
+uint64_t vk_trace_dropped() {
+    using namespace vk_struct_trace_detail;
+
+    Registry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock{registry.mutex};
+
+    uint64_t dropped = registry.retiredDropped;
+    for (Ring const *pRing : registry.rings)
+        dropped += pRing->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+)CAPTURE";
+
+std::string_view decodeStr = R"DECODE(
+#ifdef VK_STRUCT_TRACE_CONFIG_DECODE
+
+#include <cstring>
+#include <vector>
+
+namespace vk_struct_trace_detail {
+
+// The copied structs of one capture, with the pointers within them being fixed up
+class Payload {
+  public:
+    Payload(std::byte *pData, std::size_t size, uint64_t base) noexcept
+        : pData{pData}, size{size}, base{base} {}
+
+    bool failed() const noexcept { return invalid; }
+
+    /// Checks that the given bytes are all within the payload
+    bool check(std::byte const *pBegin, uint64_t bytes) noexcept {
+        if (pBegin < pData || bytes > size ||
+            pBegin - pData > static_cast<std::ptrdiff_t>(size - bytes))
+            invalid = true;
+        return !invalid;
+    }
+
+    /// Points the captured pointer in the slot into the payload, returning it, or null if it was
+    /// null or to something not captured. As everything is copied after whatever points to it,
+    /// only pointers forward are valid, which also rules out cycles.
+    std::byte *fix(std::byte *pSlot, bool followed) noexcept {
+        uintptr_t address;
+        std::memcpy(&address, pSlot, sizeof(void *));
+        if (address == 0)
+            return nullptr;
+
+        if (address - base >= size) {
+            // Only pointers that are never followed, and so never read through, are kept
+            if (followed) {
+                void *pNull = nullptr;
+                std::memcpy(pSlot, &pNull, sizeof(void *));
+            }
+            return nullptr;
+        }
+
+        std::byte *pTarget = pData + (address - base);
+        if (pTarget <= pSlot) {
+            invalid = true;
+            return nullptr;
+        }
+        std::memcpy(pSlot, &pTarget, sizeof(void *));
+        return pTarget;
+    }
+
+    /// Fixes up a pointer to a string, which must end within the payload
+    void fixString(std::byte *pSlot) noexcept {
+        std::byte *pString = fix(pSlot, true);
+        if (pString != nullptr && std::memchr(pString, 0, pData + size - pString) == nullptr)
+            invalid = true;
+    }
+
+    /// Checks that the array of elements of the given size lies within the payload
+    bool checkElements(std::byte const *pBegin, uint64_t elementSize, uint64_t count) noexcept {
+        if (elementSize != 0 && count > size / elementSize)
+            invalid = true;
+        return check(pBegin, count * elementSize);
+    }
+
+    /// Checks that the array of structs lies within the payload, and is aligned for them
+    bool checkStructs(std::byte const *pBegin, VkStructInfo const &info, uint64_t count) noexcept {
+        if (count > size / info.size || (pBegin - pData) % info.alignment != 0)
+            invalid = true;
+        return check(pBegin, count * info.size);
+    }
+
+  private:
+    std::byte *pData;
+    std::size_t size;
+    uint64_t base;
+    bool invalid = false;
+};
+
+struct PendingStruct {
+    std::byte *pStruct;
+    VkStructInfo const *pInfo;
+};
+
+uint64_t getCount(std::byte const *pStruct, VkStructInfo const &info, uint32_t countMember) {
+    if (countMember >= info.memberCount)
+        return 0;
+
+    VkMemberInfo const &member = info.pMembers[countMember];
+    if (member.size == sizeof(uint64_t)) {
+        uint64_t count;
+        std::memcpy(&count, pStruct + member.offset, sizeof(uint64_t));
+        return count;
+    }
+    uint32_t count;
+    std::memcpy(&count, pStruct + member.offset, sizeof(uint32_t));
+    return count;
+}
+
+// Fixes up the pointers of every struct reachable from the root, going by the reflection tables,
+// with the structs still to be visited kept on a stack rather than recursing
+bool fixPointers(Payload &payload, std::byte *pRoot, VkStructInfo const &rootInfo) {
+    std::vector<PendingStruct> stack{{pRoot, &rootInfo}};
+    auto pushStructs = [&](std::byte *pBegin, VkTypeId type, uint64_t count) {
+        VkStructInfo const *pInfo = vk_struct_info(type);
+        if (pBegin == nullptr || pInfo == nullptr || !payload.checkStructs(pBegin, *pInfo, count))
+            return;
+        // The members of unions overlap, so which pointers within them are in use is unknown
+        if (pInfo->isUnion)
+            return;
+        for (uint64_t i = count; i > 0; --i)
+            stack.push_back({pBegin + (i - 1) * pInfo->size, pInfo});
+    };
+
+    while (!stack.empty() && !payload.failed()) {
+        PendingStruct const item = stack.back();
+        stack.pop_back();
+
+        for (uint32_t i = 0; i < item.pInfo->memberCount; ++i) {
+            VkMemberInfo const &member = item.pInfo->pMembers[i];
+            std::byte *pMember = item.pStruct + member.offset;
+            bool const structElements = member.elementKind == VkMemberKind::Struct ||
+                                        member.elementKind == VkMemberKind::Union;
+
+            switch (member.kind) {
+            case VkMemberKind::Struct:
+                pushStructs(pMember, member.elementType, 1);
+                break;
+            case VkMemberKind::FixedArray:
+                if (structElements)
+                    pushStructs(pMember, member.elementType, member.fixedCount);
+                break;
+            case VkMemberKind::Next:
+                // The chain is cut at the first struct of an unknown type, as when captured
+                if (std::byte *pLink = payload.fix(pMember, true); pLink != nullptr) {
+                    if (!payload.check(pLink, sizeof(VkBaseInStructure)))
+                        return false;
+                    VkStructInfo const *pInfo =
+                        vk_struct_info(reinterpret_cast<VkBaseInStructure const *>(pLink)->sType);
+                    if (pInfo != nullptr) {
+                        pushStructs(pLink, pInfo->type, 1);
+                    } else {
+                        void *pNull = nullptr;
+                        std::memcpy(pMember, &pNull, sizeof(void *));
+                    }
+                }
+                break;
+            case VkMemberKind::Pointer: {
+                bool const followed = member.elementType != VkTypeId::Void &&
+                                      member.elementType != VkTypeId::Unknown;
+                std::byte *pTarget = payload.fix(pMember, followed);
+                if (structElements)
+                    pushStructs(pTarget, member.elementType, 1);
+                else if (pTarget != nullptr &&
+                         !payload.checkElements(pTarget, member.elementSize, 1))
+                    return false;
+                break;
+            }
+            case VkMemberKind::Array: {
+                // Those counted by an expression rather than a member can't be checked
+                std::byte *pTarget = payload.fix(pMember, true);
+                if (pTarget == nullptr || member.countMember == cVkNoCountMember)
+                    break;
+                uint64_t const count = getCount(item.pStruct, *item.pInfo, member.countMember);
+                if (structElements)
+                    pushStructs(pTarget, member.elementType, count);
+                else if (!payload.checkElements(pTarget, member.elementSize, count))
+                    return false;
+                break;
+            }
+            case VkMemberKind::PointerArray:
+            case VkMemberKind::StringArray: {
+                std::byte *pArray = payload.fix(pMember, true);
+                uint64_t const count = getCount(item.pStruct, *item.pInfo, member.countMember);
+                if (pArray == nullptr)
+                    break;
+                if (count > UINT64_MAX / sizeof(void *) ||
+                    !payload.check(pArray, count * sizeof(void *)))
+                    return false;
+
+                for (uint64_t element = 0; element < count; ++element) {
+                    std::byte *pSlot = pArray + element * sizeof(void *);
+                    if (member.kind == VkMemberKind::StringArray)
+                        payload.fixString(pSlot);
+                    else if (structElements)
+                        pushStructs(payload.fix(pSlot, true), member.elementType, 1);
+                    else if (std::byte *pElement = payload.fix(pSlot, true); pElement != nullptr)
+                        payload.checkElements(pElement, member.elementSize, 1);
+                }
+                break;
+            }
+            case VkMemberKind::String:
+                payload.fixString(pMember);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    return !payload.failed();
+}
+
+} // namespace vk_struct_trace_detail
+
+bool vk_trace_decode(void const *pData,
+                     std::size_t size,
+                     void (*pfnRecord)(VkTraceRecord const &record, void *pUserData),
+                     void *pUserData) {
+    using namespace vk_struct_trace_detail;
+
+    StreamHeader streamHeader;
+    if (pData == nullptr || size < sizeof(StreamHeader))
+        return false;
+    std::memcpy(&streamHeader, pData, sizeof(StreamHeader));
+    if (streamHeader.magic != cStreamMagic || streamHeader.headerVersion != VK_HEADER_VERSION ||
+        streamHeader.pointerSize != sizeof(void *))
+        return false;
+
+    // Each capture is copied out to be fixed up, as the trace itself may be read-only or
+    // unaligned
+    auto const *pBytes = static_cast<std::byte const *>(pData);
+    std::vector<std::max_align_t> buffer;
+    for (std::size_t offset = sizeof(StreamHeader); offset != size;) {
+        RecordHeader header;
+        if (size - offset < sizeof(RecordHeader))
+            return false;
+        std::memcpy(&header, pBytes + offset, sizeof(RecordHeader));
+        if (header.size < cDataOffset || header.size % cRecordAlignment != 0 ||
+            header.size > size - offset)
+            return false;
+
+        std::size_t const payloadSize = header.size - cDataOffset;
+        VkStructInfo const *pInfo = vk_struct_info(static_cast<VkTypeId>(header.type));
+        if (pInfo == nullptr || pInfo->sType == cVkNoStructureType || pInfo->size > payloadSize)
+            return false;
+
+        buffer.resize((payloadSize + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+        auto *pStruct = reinterpret_cast<std::byte *>(buffer.data());
+        std::memcpy(pStruct, pBytes + offset + cDataOffset, payloadSize);
+        if (reinterpret_cast<VkBaseInStructure const *>(pStruct)->sType != pInfo->sType)
+            return false;
+
+        Payload payload{pStruct, payloadSize, header.base};
+        if (!fixPointers(payload, pStruct, *pInfo))
+            return false;
+
+        pfnRecord(VkTraceRecord{pInfo->type, header.thread, header.sequence, pStruct}, pUserData);
+        offset += header.size;
+    }
+
+    return true;
+}
+
+#endif // VK_STRUCT_TRACE_CONFIG_DECODE
+)DECODE";
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_struct_trace.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    // Need to be in the 'types' node
+    auto *typesNode = registryNode->first_node("types");
+    if (typesNode == nullptr) {
+        std::cerr << "Error: Could not find the 'types' node." << std::endl;
+        return 1;
+    }
+
+    auto aliases = getTypeAliases(typesNode);
+    auto requiredTypes = getRequiredTypes(registryNode);
+
+    // Only the structs with an sType that are in the header, being neither aliases nor from
+    // disabled extensions, as only those can be copied with their pNext chain
+    std::vector<StructData> structs;
+    for (auto &it : getStructData(typesNode)) {
+        auto requiredIt = requiredTypes.find(it.name);
+        if (aliases.contains(it.name) || requiredIt == requiredTypes.end())
+            continue;
+
+        bool hasSType = false;
+        for (auto const &member : it.members) {
+            if (member.name == "sType" && !member.values.empty())
+                hasSType = true;
+        }
+        if (!hasSType)
+            continue;
+
+        it.platform = requiredIt->second;
+        structs.push_back(std::move(it));
+    }
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_STRUCT_TRACE_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_STRUCT_TRACE_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    outFile << declarationStr;
+
+    outFile << traceDoc;
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "bool vk_trace(" << it.name << " const &value);\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << recordStr;
+
+    outFile << "\n#ifdef VK_STRUCT_TRACE_CONFIG_MAIN\n";
+
+    outFile << captureStr;
+
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+        outFile << "\nbool vk_trace(" << it.name << " const &value) {\n";
+        outFile << "    return vk_struct_trace_detail::capture(&value, VkTypeId::" << it.name
+                << ");\n";
+        outFile << "}\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+
+    outFile << "\n#endif // VK_STRUCT_TRACE_CONFIG_MAIN\n";
+
+    outFile << decodeStr;
+
+    // Finish Up
+    outFile << "\n#endif // VK_STRUCT_TRACE_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
@@ -0,0 +1,907 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <rapidxml-1.13/rapidxml.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "header_str.hpp"
+#include "parse_xml.hpp"
+
+std::string_view headerUsageStr = R"USE(
+/*  USAGE:
+    To use, include this header where the declarations for the validation are required. This
+    depends on the `vk_enum_validation.hpp` header for checking enum and flag values.
+
+    On *ONE* compilation unit, include the definition of `#define VK_STRUCT_VALIDATION_CONFIG_MAIN`
+    so that the definitions are compiled somewhere following the one definition rule.
+*/
+)USE";
+
+constexpr std::string_view helpStr = R"HELP(
+Generates header files for C++. Contains a structural validator for Vulkan
+sType-based structs, driven by the len, optional, noautovalidity, values and
+structextends attributes of vk.xml, that checks the sType, enum and flag values,
+booleans, counts and array pointers of a struct and everything it points to,
+along with its pNext chain, reporting each error with the path of the member.
+
+Program Arguments:
+    -h, --help  : Help Blurb
+    -i, --input : Input vk.xml file to parse. These can be found from the
+                    KhronosGroup, often at this repo:
+                    https://github.com/KhronosGroup/Vulkan-Docs
+    -d, --dir   : Output directory
+    -o, --out   : Output file name (Default: `vk_struct_validation.hpp`)
+)HELP";
+
+std::string_view declarationStr = R"DECL(
+#include <string>
+#include <vector>
+
+struct VkValidationError {
+    /// Path of the member from the struct that was checked, such as
+    /// `pStages[1].stage` or `pNext<VkPhysicalDeviceVulkan12Features>.drawIndirectCount`
+    std::string path;
+    std::string message;
+};
+
+/** @brief Checks a Vulkan sType-based struct, and everything it points to, for structural errors
+ * @param pStruct Pointer to the struct to check, which must have an sType
+ * @return Every error found, or nothing if the struct is fine
+ *
+ * Only the implicit rules that can be checked from the struct alone are covered, being:
+ * - the sType of each struct reached through a typed pointer or array
+ * - enum values, and flags with bits not defined for their type
+ * - VkBool32 values that are neither VK_TRUE nor VK_FALSE
+ * - counts of zero where the array isn't optional, and null arrays with a count above zero
+ * - null pointers to single structs or strings that aren't optional
+ * - pNext chains with unknown structs, structs that can't extend the one being chained onto,
+ *   the same struct more than once, or that are too long or have a cycle
+ *
+ * Members the spec leaves out of its implicit rules (noautovalidity) are skipped, as are handles,
+ * as checking those needs state. Structs only returned by Vulkan only have their sType and pNext
+ * chain checked. Values from any extension that isn't disabled count, whether or not it is
+ * enabled.
+ *
+ * Strings for errors are only built when an error is found, so checking a valid struct doesn't
+ * allocate.
+ */
+std::vector<VkValidationError> vk_validate_struct(void const *pStruct);
+)DECL";
+
+std::string_view detailStr = R"DETAIL(
+namespace vk_struct_validation_detail {
+
+// Chains longer than this are assumed to have a cycle
+constexpr uint32_t cMaxChainLength = 256;
+
+/// A member on the way to the one being checked, only turned into text when there is an error
+struct PathNode {
+    PathNode const *pParent;
+    std::string_view name;
+    /// For pNext chain elements, the type of the struct
+    std::string_view typeName = {};
+    /// Index within an array member, or -1
+    int64_t index = -1;
+    /// Whether members of the node follow a `->`, rather than a `.`
+    bool pointer = false;
+};
+
+class Validator {
+  public:
+    std::vector<VkValidationError> errors;
+
+    /// Adds an error for a member of pPath, or for pPath itself when the member is empty
+    void report(PathNode const *pPath, std::string_view member, std::string message);
+};
+
+void validateNext(VkStructureType rootType, void const *pNext, Validator &validator,
+                  PathNode const *pPath);
+
+} // namespace vk_struct_validation_detail
+)DETAIL";
+
+std::string_view helperStr = R"HELPER(
+namespace vk_struct_validation_detail {
+
+template <typename T>
+void validateStruct(T const &value, Validator &validator, PathNode const *pPath) {
+    validateMembers(value, validator, pPath);
+    if constexpr (requires { value.pNext; })
+        validateNext(value.sType, value.pNext, validator, pPath);
+}
+
+void checkSType(VkStructureType value, VkStructureType expected, std::string_view expectedName,
+                Validator &validator, PathNode const *pPath) {
+    if (value != expected)
+        validator.report(pPath, "sType",
+                         "is " + std::to_string(static_cast<int64_t>(value)) + ", rather than " +
+                             std::string{expectedName});
+}
+
+// Members of a flag bits type hold a single one of its values, rather than any set of its bits
+template <typename T>
+constexpr bool isValidValue(T value) noexcept {
+    using Values = vk_enum_validation_detail::VkEnumValues<T>;
+    if constexpr (Values::cBitmask) {
+        auto const bits = static_cast<VkFlags>(value);
+        if (bits != 0 && (bits & (bits - 1)) == 0)
+            return (bits & Values::cMask) != 0;
+        for (uint32_t i = 0; i < Values::cCompositeCount; ++i) {
+            if (bits == Values::cComposites[i])
+                return true;
+        }
+        return false;
+    } else {
+        return vk_is_valid(value);
+    }
+}
+
+template <typename T>
+void checkEnum(T value, std::string_view member, Validator &validator, PathNode const *pPath) {
+    if (!isValidValue(value))
+        validator.report(pPath, member,
+                         "has unknown value " + std::to_string(static_cast<int64_t>(value)));
+}
+
+void reportBits(uint64_t bits, std::string_view member, Validator &validator,
+                PathNode const *pPath) {
+    std::stringstream ss;
+    ss << "has unknown bits 0x" << std::hex << std::uppercase << bits;
+    validator.report(pPath, member, ss.str());
+}
+
+template <typename FlagBits>
+void checkFlags(VkFlags value, std::string_view member, Validator &validator,
+                PathNode const *pPath) {
+    if (!vk_is_valid_flags<FlagBits>(value))
+        reportBits(value & ~vk_valid_mask<FlagBits>, member, validator, pPath);
+}
+
+// For 64-bit flags, and those without any bits yet, which have no flag bits type to check with
+void checkMask(uint64_t value, uint64_t mask, std::string_view member, Validator &validator,
+               PathNode const *pPath) {
+    if ((value & ~mask) != 0)
+        reportBits(value & ~mask, member, validator, pPath);
+}
+
+void checkBool(VkBool32 value, std::string_view member, Validator &validator,
+               PathNode const *pPath) {
+    if (value != VK_TRUE && value != VK_FALSE)
+        validator.report(pPath, member,
+                         "is " + std::to_string(value) + ", rather than VK_TRUE or VK_FALSE");
+}
+
+void checkCount(uint64_t count, std::string_view member, Validator &validator,
+                PathNode const *pPath) {
+    if (count == 0)
+        validator.report(pPath, member, "is 0, but the array it counts isn't optional");
+}
+
+void checkNotNull(void const *pointer, std::string_view member, Validator &validator,
+                  PathNode const *pPath) {
+    if (pointer == nullptr)
+        validator.report(pPath, member, "is null, but isn't optional");
+}
+
+// Returns whether there are elements to check, reporting a null array that has a count
+bool checkArray(void const *pArray, uint64_t count, bool optional, std::string_view member,
+                Validator &validator, PathNode const *pPath) {
+    if (count == 0 || pArray != nullptr)
+        return count != 0;
+    if (!optional)
+        validator.report(pPath, member, "is null, but has a count of " + std::to_string(count));
+    return false;
+}
+
+template <typename T>
+void validateStructMember(T const &value, std::string_view member, Validator &validator,
+                          PathNode const *pPath) {
+    PathNode const node{pPath, member};
+    validateStruct(value, validator, &node);
+}
+
+template <typename T>
+void validateStructPointer(T const *pValue, bool optional, std::string_view member,
+                           Validator &validator, PathNode const *pPath) {
+    if (pValue == nullptr) {
+        if (!optional)
+            validator.report(pPath, member, "is null, but isn't optional");
+        return;
+    }
+    PathNode const node{pPath, member, {}, -1, true};
+    validateStruct(*pValue, validator, &node);
+}
+
+template <typename T>
+void validateStructArray(T const *pArray, uint64_t count, bool optional, std::string_view member,
+                         Validator &validator, PathNode const *pPath) {
+    if (!checkArray(pArray, count, optional, member, validator, pPath))
+        return;
+    for (uint64_t i = 0; i < count; ++i) {
+        PathNode const node{pPath, member, {}, static_cast<int64_t>(i)};
+        validateStruct(pArray[i], validator, &node);
+    }
+}
+
+template <typename T>
+void validateStructPointerArray(T const *const *pArray, uint64_t count, bool optional,
+                                std::string_view member, Validator &validator,
+                                PathNode const *pPath) {
+    if (!checkArray(pArray, count, optional, member, validator, pPath))
+        return;
+    for (uint64_t i = 0; i < count; ++i) {
+        PathNode const node{pPath, member, {}, static_cast<int64_t>(i), true};
+        if (pArray[i] == nullptr)
+            validator.report(&node, {}, "is null");
+        else
+            validateStruct(*pArray[i], validator, &node);
+    }
+}
+
+template <typename T>
+void validateEnumArray(T const *pArray, uint64_t count, bool optional, std::string_view member,
+                       Validator &validator, PathNode const *pPath) {
+    if (!checkArray(pArray, count, optional, member, validator, pPath))
+        return;
+    bool valid = true;
+    for (uint64_t i = 0; i < count; ++i)
+        valid &= isValidValue(pArray[i]);
+    if (valid)
+        return;
+
+    // Only go back for the paths once something is known to be wrong
+    for (uint64_t i = 0; i < count; ++i) {
+        PathNode const node{pPath, member, {}, static_cast<int64_t>(i)};
+        checkEnum(pArray[i], {}, validator, &node);
+    }
+}
+
+void validateStringArray(char const *const *pArray, uint64_t count, bool optional,
+                         std::string_view member, Validator &validator, PathNode const *pPath) {
+    if (!checkArray(pArray, count, optional, member, validator, pPath))
+        return;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (pArray[i] == nullptr) {
+            PathNode const node{pPath, member, {}, static_cast<int64_t>(i)};
+            validator.report(&node, {}, "is null");
+        }
+    }
+}
+
+} // namespace vk_struct_validation_detail
+)HELPER";
+
+std::string_view chainStr = R"CHAIN(
+namespace vk_struct_validation_detail {
+
+void Validator::report(PathNode const *pPath, std::string_view member, std::string message) {
+    std::string path{member};
+    for (; pPath != nullptr; pPath = pPath->pParent) {
+        std::string node{pPath->name};
+        if (!pPath->typeName.empty())
+            node += "<" + std::string{pPath->typeName} + ">";
+        if (pPath->index >= 0)
+            node += "[" + std::to_string(pPath->index) + "]";
+        if (!path.empty())
+            node += pPath->pointer ? "->" : ".";
+        path = node + path;
+    }
+    errors.push_back({std::move(path), std::move(message)});
+}
+
+void validateNext(VkStructureType rootType, void const *pNext, Validator &validator,
+                  PathNode const *pPath) {
+    VkStructureType chained[cMaxChainLength];
+    uint32_t length = 0;
+
+    for (auto const *pCurrent = static_cast<VkBaseInStructure const *>(pNext);
+         pCurrent != nullptr; pCurrent = pCurrent->pNext) {
+        if (length == cMaxChainLength) {
+            validator.report(pPath, "pNext",
+                             "chain has more than " + std::to_string(cMaxChainLength) +
+                                 " structs, or has a cycle");
+            return;
+        }
+
+        StructInfo const *pInfo = getStructInfo(pCurrent->sType);
+        if (pInfo == nullptr) {
+            PathNode const node{pPath, "pNext", {}, length};
+            validator.report(&node, "sType",
+                             "is unknown value " +
+                                 std::to_string(static_cast<int64_t>(pCurrent->sType)));
+            chained[length++] = pCurrent->sType;
+            continue;
+        }
+
+        PathNode const node{pPath, "pNext", pInfo->name};
+        if (!canExtend(rootType, pCurrent->sType))
+            validator.report(&node, {}, "can't extend the struct it is chained onto");
+        if (!pInfo->allowDuplicates) {
+            for (uint32_t i = 0; i < length; ++i) {
+                if (chained[i] == pCurrent->sType) {
+                    validator.report(&node, {}, "is in the chain more than once");
+                    break;
+                }
+            }
+        }
+
+        pInfo->pfnValidate(pCurrent, validator, &node);
+        chained[length++] = pCurrent->sType;
+    }
+}
+
+} // namespace vk_struct_validation_detail
+
+std::vector<VkValidationError> vk_validate_struct(void const *pStruct) {
+    using namespace vk_struct_validation_detail;
+    Validator validator;
+
+    if (pStruct == nullptr) {
+        validator.report(nullptr, {}, "is null");
+        return std::move(validator.errors);
+    }
+
+    auto const *pBase = static_cast<VkBaseInStructure const *>(pStruct);
+    StructInfo const *pInfo = getStructInfo(pBase->sType);
+    if (pInfo == nullptr) {
+        validator.report(nullptr, "sType",
+                         "is unknown value " + std::to_string(static_cast<int64_t>(pBase->sType)));
+        return std::move(validator.errors);
+    }
+
+    pInfo->pfnValidate(pStruct, validator, nullptr);
+    validateNext(pBase->sType, pBase->pNext, validator, nullptr);
+
+    return std::move(validator.errors);
+}
+)CHAIN";
+
+std::string_view structInfoStr = R"INFO(
+namespace vk_struct_validation_detail {
+
+struct StructInfo {
+    std::string_view name;
+    void (*pfnValidate)(void const *pStruct, Validator &validator, PathNode const *pPath);
+    /// Whether the struct can be in a pNext chain more than once
+    bool allowDuplicates;
+};
+
+template <typename T>
+void validateAs(void const *pStruct, Validator &validator, PathNode const *pPath) {
+    validateMembers(*static_cast<T const *>(pStruct), validator, pPath);
+}
+)INFO";
+
+// Attributes of a struct's <type> that StructData doesn't have
+struct StructAttributes {
+    bool returnedOnly = false;
+    bool allowDuplicate = false;
+    std::vector<std::string_view> extends;
+};
+
+std::map<std::string_view, StructAttributes> getStructAttributes(rapidxml::xml_node<> *typesNode) {
+    std::map<std::string_view, StructAttributes> attributes;
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *categoryAttr = typeNode->first_attribute("category");
+        if (categoryAttr == nullptr || strcmp(categoryAttr->value(), "struct") != 0)
+            continue;
+
+        auto &it = attributes[typeNode->first_attribute("name")->value()];
+        if (auto *attr = typeNode->first_attribute("returnedonly"); attr != nullptr)
+            it.returnedOnly = strcmp(attr->value(), "true") == 0;
+        if (auto *attr = typeNode->first_attribute("allowduplicate"); attr != nullptr)
+            it.allowDuplicate = strcmp(attr->value(), "true") == 0;
+        if (auto *attr = typeNode->first_attribute("structextends"); attr != nullptr) {
+            std::string_view extends = attr->value();
+            while (!extends.empty()) {
+                auto end = extends.find(',');
+                it.extends.push_back(extends.substr(0, end));
+                if (end == std::string_view::npos)
+                    break;
+                extends.remove_prefix(end + 1);
+            }
+        }
+    }
+
+    return attributes;
+}
+
+struct FlagsData {
+    // Empty for flags that have no bits defined yet
+    std::string_view flagBits;
+    bool is64 = false;
+};
+
+// Returns the flag bits type and width of each bitmask type
+std::map<std::string_view, FlagsData> getFlagsData(rapidxml::xml_node<> *typesNode) {
+    std::map<std::string_view, FlagsData> flags;
+
+    for (auto *typeNode = typesNode->first_node("type"); typeNode != nullptr;
+         typeNode = typeNode->next_sibling("type")) {
+        auto *categoryAttr = typeNode->first_attribute("category");
+        if (categoryAttr == nullptr || strcmp(categoryAttr->value(), "bitmask") != 0 ||
+            typeNode->first_attribute("alias") != nullptr)
+            continue;
+
+        auto *nameNode = typeNode->first_node("name");
+        if (nameNode == nullptr)
+            continue;
+
+        FlagsData data;
+        if (auto *attr = typeNode->first_attribute("requires"); attr != nullptr)
+            data.flagBits = attr->value();
+        else if (auto *attr = typeNode->first_attribute("bitvalues"); attr != nullptr)
+            data.flagBits = attr->value();
+        if (auto *baseNode = typeNode->first_node("type"); baseNode != nullptr)
+            data.is64 = strcmp(baseNode->value(), "VkFlags64") == 0;
+
+        flags[nameNode->value()] = data;
+    }
+
+    return flags;
+}
+
+std::string toHex(uint64_t value) {
+    std::stringstream ss;
+    ss << "0x" << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << value;
+    return ss.str();
+}
+
+// Types of the registry, resolved through aliases
+struct TypeInfo {
+    std::map<std::string_view, std::string_view> const &categories;
+    std::map<std::string_view, std::string_view> const &aliases;
+
+    std::string_view resolve(std::string_view type) const {
+        auto it = aliases.find(type);
+        return (it != aliases.end()) ? it->second : type;
+    }
+
+    std::string_view category(std::string_view type) const {
+        auto it = categories.find(resolve(type));
+        return (it != categories.end()) ? it->second : std::string_view{};
+    }
+};
+
+// Writes the checks of a single member, with enums and flags checked by the enum validation,
+// other than 64-bit flags which are checked against their mask in wideMasks
+void writeMemberChecks(std::ostream &out, StructData const &structData, MemberData const &member,
+                       TypeInfo const &types, std::map<std::string_view, FlagsData> const &flags,
+                       std::set<std::string_view> const &flagBits,
+                       std::map<std::string_view, std::string> const &wideMasks) {
+    std::string_view const type = types.resolve(member.type);
+    std::string_view const category = types.category(type);
+    std::string const name{member.name};
+    std::string const quoted = "\"" + name + "\"";
+    std::string const args = ", validator, pPath);\n";
+
+    if (member.name == "pNext" || member.noautovalidity)
+        return;
+
+    if (member.name == "sType") {
+        if (!member.values.empty()) {
+            out << "    checkSType(value.sType, " << member.values << ", \"" << member.values
+                << "\"" << args;
+        }
+        return;
+    }
+
+    // Plain values, or in-place arrays of them
+    if (member.pointerDepth == 0) {
+        if (member.sizeEnum.size() > 1)
+            return;
+
+        if (member.sizeEnum.size() == 1) {
+            std::string const count = member.sizeEnum[0];
+            if (category == "struct") {
+                out << "    validateStructArray(value." << name << ", " << count << ", true, "
+                    << quoted << args;
+            } else if (category == "enum" && !wideMasks.contains(type)) {
+                out << "    validateEnumArray(value." << name << ", " << count << ", true, "
+                    << quoted << args;
+            }
+            return;
+        }
+
+        if (category == "struct") {
+            out << "    validateStructMember(value." << name << ", " << quoted << args;
+        } else if (category == "enum" && !wideMasks.contains(type)) {
+            out << "    checkEnum(value." << name << ", " << quoted << args;
+        } else if (category == "bitmask") {
+            auto flagsIt = flags.find(type);
+            if (flagsIt == flags.end())
+                return;
+            std::string_view const bits = flagsIt->second.flagBits;
+
+            if (bits.empty()) {
+                out << "    checkMask(value." << name << ", 0, " << quoted << args;
+            } else if (auto maskIt = wideMasks.find(bits); maskIt != wideMasks.end()) {
+                out << "    checkMask(value." << name << ", " << maskIt->second << ", " << quoted
+                    << args;
+            } else if (flagBits.contains(bits)) {
+                // Flags with bits that aren't known to be in the header can't be checked
+                out << "    checkFlags<" << bits << ">(value." << name << ", " << quoted << args;
+            }
+        } else if (type == "VkBool32") {
+            out << "    checkBool(value." << name << ", " << quoted << args;
+        } else {
+            // Counts of arrays that aren't optional
+            if (member.optional)
+                return;
+            for (auto const &it : structData.members) {
+                if (it.noautovalidity || it.pointerDepth == 0)
+                    continue;
+                if (it.len == member.name || it.len.starts_with(name + ",")) {
+                    out << "    checkCount(value." << name << ", " << quoted << args;
+                    return;
+                }
+            }
+        }
+        return;
+    }
+
+    // Pointers
+    std::string_view len = member.len;
+    std::string_view lenRest;
+    if (auto comma = len.find(','); comma != std::string_view::npos) {
+        lenRest = len.substr(comma + 1);
+        len = len.substr(0, comma);
+    }
+    std::string const optional = member.optional ? "true" : "false";
+
+    if (len.empty()) {
+        if (category == "struct" && member.pointerDepth == 1) {
+            out << "    validateStructPointer(value." << name << ", " << optional << ", " << quoted
+                << args;
+        }
+        return;
+    }
+    if (len == "null-terminated") {
+        if (!member.optional && member.pointerDepth == 1)
+            out << "    checkNotNull(value." << name << ", " << quoted << args;
+        return;
+    }
+
+    // Only counts that are a plain member of the same struct are understood, rather than
+    // expressions such as `(rasterizationSamples + 31) / 32`
+    if (member.altlen != member.len)
+        return;
+    MemberData const *pCount = nullptr;
+    for (auto const &it : structData.members) {
+        if (it.name == len && it.pointerDepth == 0 && it.sizeEnum.empty())
+            pCount = &it;
+    }
+    if (pCount == nullptr)
+        return;
+
+    std::string const countArgs = "value." + name + ", value." + std::string{len} + ", " +
+                                  optional + ", " + quoted + args;
+    if (member.pointerDepth == 1 && category == "struct") {
+        out << "    validateStructArray(" << countArgs;
+    } else if (member.pointerDepth == 1 && category == "enum" && !wideMasks.contains(type)) {
+        out << "    validateEnumArray(" << countArgs;
+    } else if (member.pointerDepth == 2 && category == "struct") {
+        out << "    validateStructPointerArray(" << countArgs;
+    } else if (member.pointerDepth == 2 && type == "char" && lenRest == "null-terminated") {
+        out << "    validateStringArray(" << countArgs;
+    } else {
+        out << "    checkArray(" << countArgs;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string inputFile;
+    std::string outputDir;
+    std::string outputFile = "vk_struct_validation.hpp";
+
+    for (int i = 0; i < argc; ++i) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            std::cout << helpStr << std::endl;
+            return 0;
+        } else if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input") == 0) {
+            if (i + 1 <= argc) {
+                inputFile = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--dir") == 0) {
+            if (i + 1 <= argc) {
+                outputDir = argv[i + 1];
+            }
+        } else if (strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--out") == 0) {
+            if (i + 1 <= argc) {
+                outputFile = argv[i + 1];
+            }
+        }
+    }
+
+    if (inputFile == "") {
+        std::cerr << "Error: No input file given. Type --help for help." << std::endl;
+        return 1;
+    }
+
+    // In order to parse a file, we need to load the whole thing into memory.
+    std::ifstream inFile(inputFile.c_str(), std::ifstream::in);
+    if (!inFile.is_open()) {
+        std::cerr << "Error: Failed to open file " << inputFile << std::endl;
+        return 1;
+    }
+    // Seek to the end.
+    inFile.seekg(0, std::ifstream::end);
+    // Tell us how many chars to set aside.
+    auto fileSize = inFile.tellg();
+
+    // Allocate a large enough block, and read it all into memory
+    char *xmlContent = new char[fileSize];
+    inFile.seekg(0, std::ifstream::beg);
+    inFile.read(xmlContent, fileSize);
+    inFile.close();
+
+    // XML Parsing
+    rapidxml::xml_document<> vkDoc;
+    vkDoc.parse<0>(xmlContent);
+
+    // Baselevel node should be <registry>
+    rapidxml::xml_node<> *registryNode = vkDoc.first_node("registry");
+    if (registryNode == nullptr) {
+        std::cerr << "Error: No <registry> top-level tag found. Invalid vk.xml document."
+                  << std::endl;
+        return 1;
+    }
+
+    // To retrieve the Vulkan version information
+    int vkHeaderVersion = -1;
+    {
+        rapidxml::xml_node<> *typesNode = registryNode->first_node("types");
+
+        rapidxml::xml_node<> *endTypeNode = typesNode->last_node("type");
+        for (auto *typeNode = typesNode->first_node("type"); typeNode != endTypeNode;
+             typeNode = typeNode->next_sibling()) {
+            if (strcmp("// Version of this file\n#define ", typeNode->value()) == 0) {
+                // Go through the contents, the third sibling will have the header version
+                auto *node = typeNode->first_node()->next_sibling()->next_sibling();
+                vkHeaderVersion = std::stoi(node->value());
+                break;
+            }
+        }
+    }
+    if (vkHeaderVersion == -1) {
+        std::cerr << "Error: Could not determine vk.xml header version." << std::endl;
+        return 1;
+    }
+
+    // Platforms
+    auto *platformsNode = registryNode->first_node("platforms");
+    if (platformsNode == nullptr) {
+        std::cerr << "Error: Could not find the 'platforms' node." << std::endl;
+        return 1;
+    }
+
+    auto platforms = getPlatforms(platformsNode);
+
+    // Need to be in the 'types' node
+    auto *typesNode = registryNode->first_node("types");
+    if (typesNode == nullptr) {
+        std::cerr << "Error: Could not find the 'types' node." << std::endl;
+        return 1;
+    }
+
+    auto categories = getTypeCategories(typesNode);
+    auto aliases = getTypeAliases(typesNode);
+    auto structAttributes = getStructAttributes(typesNode);
+    auto flags = getFlagsData(typesNode);
+    auto requiredTypes = getRequiredTypes(registryNode);
+    TypeInfo const types{categories, aliases};
+
+    // Only the structs that are in the header, being neither aliases nor from disabled extensions
+    std::vector<StructData> structs;
+    for (auto &it : getStructData(typesNode)) {
+        auto requiredIt = requiredTypes.find(it.name);
+        if (aliases.contains(it.name) || requiredIt == requiredTypes.end())
+            continue;
+        it.platform = requiredIt->second;
+        structs.push_back(std::move(it));
+    }
+
+    // The flag bits types in the header, with the defined bits of the 64-bit ones, which being
+    // plain VkFlags64 constants aren't covered by the enum validation
+    std::set<std::string_view> flagBits;
+    std::map<std::string_view, std::string> wideMasks;
+    for (auto const &[flagsName, data] : flags) {
+        if (data.flagBits.empty() || !requiredTypes.contains(data.flagBits))
+            continue;
+        flagBits.insert(data.flagBits);
+        if (!data.is64)
+            continue;
+
+        uint64_t mask = 0;
+        for (auto const &[valueName, value] : getEnumValues(registryNode, data.flagBits)) {
+            if (value.bitpos)
+                mask |= static_cast<uint64_t>(value.value);
+        }
+        wideMasks[data.flagBits] = toHex(mask) + "ULL";
+    }
+
+    // The sType value of each struct that has one
+    std::map<std::string_view, std::string_view> sTypes;
+    for (auto const &it : structs) {
+        for (auto const &member : it.members) {
+            if (member.name == "sType" && !member.values.empty())
+                sTypes[it.name] = member.values;
+        }
+    }
+
+    // Member checks
+    std::map<std::string_view, std::string> memberChecks;
+    for (auto const &it : structs) {
+        std::ostringstream checks;
+        bool const returnedOnly = structAttributes[it.name].returnedOnly;
+        for (auto const &member : it.members) {
+            // Returned structs only need to be set up for Vulkan to fill them in
+            if (returnedOnly && member.name != "sType")
+                continue;
+            writeMemberChecks(checks, it, member, types, flags, flagBits, wideMasks);
+        }
+        memberChecks[it.name] = checks.str();
+    }
+
+    // Output to final file
+    std::ofstream outFile(outputDir + outputFile);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Failed to open output file for writing: " << outputDir << outputFile
+                  << std::endl;
+        return 1;
+    }
+
+    outFile << headerStr;
+
+    outFile << "#ifndef VK_STRUCT_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+    outFile << "#define VK_STRUCT_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+
+    outFile << headerUsageStr;
+
+    outFile << "\n#include <vulkan/vulkan.h>\n";
+    outFile << "\n";
+
+    // Static assert checking correct/compatible header version
+    outFile << "static_assert(VK_HEADER_VERSION == " << vkHeaderVersion
+            << ", \"Incompatible VK_HEADER_VERSION!\");\n";
+
+    outFile << declarationStr;
+
+    outFile << "\n#ifdef VK_STRUCT_VALIDATION_CONFIG_MAIN\n";
+    outFile << "\n#include <cstdint>\n";
+    outFile << "#include <sstream>\n";
+    outFile << "#include <string_view>\n";
+
+    outFile << detailStr;
+
+    outFile << "\nnamespace vk_struct_validation_detail {\n";
+    // The member checks of each struct call each other, so are all declared first
+    outFile << "\n";
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "void validateMembers(" << it.name
+                << " const &, Validator &, PathNode const *);\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "\n} // namespace vk_struct_validation_detail\n";
+
+    outFile << helperStr;
+
+    outFile << "\nnamespace vk_struct_validation_detail {\n";
+    for (auto const &it : structs) {
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        std::string const &checks = memberChecks[it.name];
+
+        if (!platformDefine.empty())
+            outFile << "\n#ifdef " << platformDefine;
+        if (checks.empty()) {
+            outFile << "\nvoid validateMembers(" << it.name
+                    << " const &, Validator &, PathNode const *) {}\n";
+        } else {
+            outFile << "\nvoid validateMembers(" << it.name
+                    << " const &value, Validator &validator, PathNode const *pPath) {\n";
+            outFile << checks;
+            outFile << "}\n";
+        }
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "\n} // namespace vk_struct_validation_detail\n";
+
+    // Structs that can be found by sType, such as in a pNext chain
+    outFile << structInfoStr;
+
+    outFile << "\nStructInfo const *getStructInfo(VkStructureType sType) {\n";
+    outFile << "    switch (sType) {\n";
+    for (auto const &it : structs) {
+        auto sTypeIt = sTypes.find(it.name);
+        if (sTypeIt == sTypes.end())
+            continue;
+
+        std::string_view platformDefine = getPlatformDefine(it, platforms);
+        if (!platformDefine.empty())
+            outFile << "#ifdef " << platformDefine << "\n";
+        outFile << "    case " << sTypeIt->second << ": {\n";
+        outFile << "        static constexpr StructInfo cInfo{\"" << it.name << "\", &validateAs<"
+                << it.name << ">, " << (structAttributes[it.name].allowDuplicate ? "true" : "false")
+                << "};\n";
+        outFile << "        return &cInfo;\n";
+        outFile << "    }\n";
+        if (!platformDefine.empty())
+            outFile << "#endif // " << platformDefine << "\n";
+    }
+    outFile << "    default:\n";
+    outFile << "        return nullptr;\n";
+    outFile << "    }\n";
+    outFile << "}\n";
+
+    // The structs each struct can be chained onto, by sType, which are in the header regardless
+    // of platform
+    outFile << "\nbool canExtend(VkStructureType rootType, VkStructureType sType) {\n";
+    outFile << "    switch (sType) {\n";
+    for (auto const &it : structs) {
+        auto sTypeIt = sTypes.find(it.name);
+        if (sTypeIt == sTypes.end())
+            continue;
+
+        std::vector<std::string_view> roots;
+        for (auto extends : structAttributes[it.name].extends) {
+            if (auto rootIt = sTypes.find(types.resolve(extends)); rootIt != sTypes.end())
+                roots.push_back(rootIt->second);
+        }
+        if (roots.empty())
+            continue;
+
+        outFile << "    case " << sTypeIt->second << ":\n";
+        outFile << "        return ";
+        for (auto const &root : roots) {
+            if (&root != &roots.front())
+                outFile << " ||\n               ";
+            outFile << "rootType == " << root;
+        }
+        outFile << ";\n";
+    }
+    outFile << "    default:\n";
+    outFile << "        return false;\n";
+    outFile << "    }\n";
+    outFile << "}\n";
+    outFile << "\n} // namespace vk_struct_validation_detail\n";
+
+    outFile << chainStr;
+
+    outFile << "\n#endif // VK_STRUCT_VALIDATION_CONFIG_MAIN\n";
+
+    // Finish Up
+    outFile << "\n#endif // VK_STRUCT_VALIDATION_V" << vkHeaderVersion << "_HPP\n";
+
+    return 0;
+}
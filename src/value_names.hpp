@@ -0,0 +1,146 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef VALUE_NAMES_HPP
+#define VALUE_NAMES_HPP
+
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Removes a vendor tag from the end of the given string view
+ * @param vendorTags List of vendor tags to check against
+ * @param view String view to remove the vendor tag from
+ * @return A string_view without the vendor tag, if it was suffixed
+ */
+std::string_view removeVendorTag(const std::vector<std::string> &vendorTags,
+                                 std::string_view view) {
+    for (auto &it : vendorTags) {
+        if (view == it)
+            break;
+
+        if (strncmp(view.data() + view.size() - it.size(), it.data(), it.size()) == 0) {
+            view = view.substr(0, view.size() - it.size());
+            break;
+        }
+    }
+
+    return view;
+}
+
+/**
+ * @brief Converts a Vulkan Flag typename into the prefix that is used for it's enums
+ * @param typeName Name of the type to generate the Vk enum prefix for
+ * @return Generated prefix string
+ *
+ * Any capitalized letters except for the first has an underscore inserted before it, an underscore
+ * is added to the end, and all characters are converted to upper case.
+ */
+std::string processEnumPrefix(std::string_view typeName) {
+    std::size_t size = strlen("FlagBits");
+    if (typeName.size() > size) {
+        if (strncmp(typeName.data() + typeName.size() - size, "FlagBits", size) == 0) {
+            typeName = typeName.substr(0, typeName.size() - strlen("FlagBits"));
+        }
+    }
+
+    std::string retStr;
+    for (auto it = typeName.begin(); it != typeName.end(); ++it) {
+        if (it == typeName.begin()) {
+            retStr += ::toupper(*it);
+        } else if (::isupper(*it)) {
+            retStr += '_';
+            retStr += *it;
+        } else {
+            retStr += toupper(*it);
+        }
+    }
+    retStr += '_';
+
+    return retStr;
+}
+
+/**
+ * @brief Trims non alphanumeric characters from the string view
+ * @param view Itme to trim
+ * @return Trimmed string view
+ */
+std::string_view trimNonAlNum(std::string_view view) {
+    if (view.empty())
+        return view;
+
+    // Trim left
+    for (std::size_t i = 0; i < view.size(); ++i) {
+        if (::isalnum(view[i])) {
+            view = view.substr(i);
+            break;
+        }
+    }
+
+    if (view.empty())
+        return view;
+
+    // Trim right
+    for (std::size_t i = view.size(); i-- > 0;) {
+        if (::isalnum(view[i])) {
+            view = view.substr(0, i + 1);
+            break;
+        }
+    }
+
+    return view;
+}
+
+/**
+ * @brief Strips '_BIT' from the end of a string, if there
+ */
+std::string_view stripBit(std::string_view view) {
+    if (view.size() > strlen("_BIT")) {
+        if (view.substr(view.size() - strlen("_BIT")) == "_BIT") {
+            return view.substr(0, view.size() - strlen("_BIT"));
+        }
+    }
+
+    return view;
+}
+
+/**
+ * @brief Returns the name an enum or flag bit value is serialized as
+ * @param vendorTags List of vendor tags to check against
+ * @param prefix Prefix of the type's values, from processEnumPrefix
+ * @param name Full name of the value, such as 'VK_CULL_MODE_FRONT_BIT'
+ * @return The name without the prefix, vendor tag or '_BIT' suffix, such as 'FRONT'
+ */
+std::string_view getValueName(const std::vector<std::string> &vendorTags, std::string_view prefix,
+                              std::string_view name) {
+    // Strip prefix
+    if (strncmp(name.data(), prefix.data(), prefix.size()) == 0)
+        name = name.substr(prefix.size());
+
+    name = removeVendorTag(vendorTags, name);
+    name = trimNonAlNum(name);
+    name = stripBit(name);
+
+    if (strncmp(name.data(), prefix.data(), prefix.size()) == 0)
+        name = name.substr(prefix.size());
+
+    return name;
+}
+
+#endif // VALUE_NAMES_HPP
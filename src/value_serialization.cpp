@@ -28,104 +28,7 @@
 #include "header_str.hpp"
 #include "parse_xml.hpp"
 #include "serialization_strings.hpp"
-
-/**
- * @brief Removes a vendor tag from the end of the given string view
- * @param vendorTags List of vendor tags to check against
- * @param view String view to remove the vendor tag from
- * @return A string_view without the vendor tag, if it was suffixed
- */
-std::string_view removeVendorTag(const std::vector<std::string> &vendorTags,
-                                 std::string_view view) {
-    for (auto &it : vendorTags) {
-        if (view == it)
-            break;
-
-        if (strncmp(view.data() + view.size() - it.size(), it.data(), it.size()) == 0) {
-            view = view.substr(0, view.size() - it.size());
-            break;
-        }
-    }
-
-    return view;
-}
-
-/**
- * @brief Converts a Vulkan Flag typename into the prefix that is used for it's enums
- * @param typeName Name of the type to generate the Vk enum prefix for
- * @return Generated prefix string
- *
- * Any capitalized letters except for the first has an underscore inserted before it, an underscore
- * is added to the end, and all characters are converted to upper case.
- */
-std::string processEnumPrefix(const std::vector<std::string> &vendorTags,
-                              std::string_view typeName) {
-    std::size_t size = strlen("FlagBits");
-    if (typeName.size() > size) {
-        if (strncmp(typeName.data() + typeName.size() - size, "FlagBits", size) == 0) {
-            typeName = typeName.substr(0, typeName.size() - strlen("FlagBits"));
-        }
-    }
-
-    std::string retStr;
-    for (auto it = typeName.begin(); it != typeName.end(); ++it) {
-        if (it == typeName.begin()) {
-            retStr += ::toupper(*it);
-        } else if (::isupper(*it)) {
-            retStr += '_';
-            retStr += *it;
-        } else {
-            retStr += toupper(*it);
-        }
-    }
-    retStr += '_';
-
-    return retStr;
-}
-
-/**
- * @brief Trims non alphanumeric characters from the string view
- * @param view Itme to trim
- * @return Trimmed string view
- */
-std::string_view trimNonAlNum(std::string_view view) {
-    if (view.empty())
-        return view;
-
-    // Trim left
-    for (std::size_t i = 0; i < view.size(); ++i) {
-        if (::isalnum(view[i])) {
-            view = view.substr(i);
-            break;
-        }
-    }
-
-    if (view.empty())
-        return view;
-
-    // Trim right
-    for (std::size_t i = view.size() - 1; i >= 0; --i) {
-        if (::isalnum(view[i])) {
-            view = view.substr(0, i + 1);
-            break;
-        }
-    }
-
-    return view;
-}
-
-/**
- * @brief Strips '_BIT' from the end of a string, if there
- */
-std::string_view stripBit(std::string_view view) {
-    if (view.size() > strlen("_BIT")) {
-        if (view.substr(view.size() - strlen("_BIT")) == "_BIT") {
-            return view.substr(0, view.size() - strlen("_BIT"));
-        }
-    }
-
-    return view;
-}
+#include "value_names.hpp"
 
 std::string replaceFlagBitsSuffix(std::string str) {
     if (str.size() > strlen("FlagBits")) {
@@ -317,24 +220,10 @@ struct EnumValueSet {
             }
 
             outFile << "constexpr EnumValueSet " << it.name << "Sets[] = {\n";
-            std::string prefix = processEnumPrefix(vendors, removeVendorTag(vendors, it.name));
+            std::string prefix = processEnumPrefix(removeVendorTag(vendors, it.name));
             for (auto const &val : it.values) {
-                std::string_view name = val.name;
-
-                // Strip prefix
-                if (strncmp(name.data(), prefix.data(), prefix.size()) == 0)
-                    name = name.substr(prefix.size());
-
-                name = removeVendorTag(vendors, name);
-                name = trimNonAlNum(name);
-                name = stripBit(name);
-
-                if (strncmp(name.data(), prefix.data(), prefix.size()) == 0) {
-                    outFile << "    {\"" << name.substr(prefix.size());
-                } else {
-                    outFile << "    {\"" << name;
-                }
-                outFile << "\", " << val.value << "},\n";
+                outFile << "    {\"" << getValueName(vendors, prefix, val.name) << "\", "
+                        << val.value << "},\n";
             }
             outFile << "};\n";
         }
@@ -0,0 +1,175 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_DISPATCH_TABLE_CONFIG_MAIN
+#include "vk_dispatch_table.hpp"
+
+#include <cstring>
+#include <set>
+#include <string>
+
+// A stand-in for the loader and driver, so that the tables can be tested without a GPU
+namespace {
+
+std::set<std::string> gQueried;
+std::set<std::string> gUnavailable;
+VkInstance const cInstance = reinterpret_cast<VkInstance>(0x1000);
+VkDevice const cDevice = reinterpret_cast<VkDevice>(0x2000);
+uint32_t gDrawCount = 0;
+uint32_t gFeatureQueries = 0;
+
+VKAPI_ATTR VkResult VKAPI_CALL mockCreateInstance(VkInstanceCreateInfo const *,
+                                                  VkAllocationCallbacks const *,
+                                                  VkInstance *pInstance) {
+    *pInstance = cInstance;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL mockGetPhysicalDeviceFeatures2(VkPhysicalDevice,
+                                                          VkPhysicalDeviceFeatures2 *) {
+    ++gFeatureQueries;
+}
+
+VKAPI_ATTR void VKAPI_CALL mockCmdDraw(VkCommandBuffer, uint32_t vertexCount, uint32_t, uint32_t,
+                                       uint32_t) {
+    gDrawCount += vertexCount;
+}
+
+VKAPI_ATTR void VKAPI_CALL mockVoidFunction() {}
+
+// Every command is available unless listed in gUnavailable, with a few doing something
+PFN_vkVoidFunction mockGetProcAddr(char const *pName) {
+    gQueried.insert(pName);
+    if (gUnavailable.contains(pName))
+        return nullptr;
+
+    if (strcmp(pName, "vkCreateInstance") == 0)
+        return reinterpret_cast<PFN_vkVoidFunction>(&mockCreateInstance);
+    if (strcmp(pName, "vkGetPhysicalDeviceFeatures2") == 0 ||
+        strcmp(pName, "vkGetPhysicalDeviceFeatures2KHR") == 0)
+        return reinterpret_cast<PFN_vkVoidFunction>(&mockGetPhysicalDeviceFeatures2);
+    if (strcmp(pName, "vkCmdDraw") == 0)
+        return reinterpret_cast<PFN_vkVoidFunction>(&mockCmdDraw);
+    return &mockVoidFunction;
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL mockGetInstanceProcAddr(VkInstance instance,
+                                                                 char const *pName) {
+    // Only global commands are available without an instance
+    if (instance == VK_NULL_HANDLE && strcmp(pName, "vkCreateInstance") != 0)
+        return nullptr;
+    return mockGetProcAddr(pName);
+}
+
+VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL mockGetDeviceProcAddr(VkDevice device,
+                                                               char const *pName) {
+    if (device != cDevice)
+        return nullptr;
+    return mockGetProcAddr(pName);
+}
+
+void resetMock() {
+    gQueried.clear();
+    gUnavailable.clear();
+    gDrawCount = 0;
+    gFeatureQueries = 0;
+}
+
+} // namespace
+
+TEST_CASE("Global commands") {
+    resetMock();
+
+    VkGlobalDispatchTable table;
+    vk_load_global_dispatch_table(&table, &mockGetInstanceProcAddr);
+    REQUIRE(table.vkCreateInstance != nullptr);
+
+    VkInstance instance = VK_NULL_HANDLE;
+    REQUIRE(table.vkCreateInstance(nullptr, nullptr, &instance) == VK_SUCCESS);
+    REQUIRE(instance == cInstance);
+}
+
+TEST_CASE("Instance commands are filtered by the enabled extensions") {
+    resetMock();
+
+    VkInstanceDispatchTable table;
+    vk_load_instance_dispatch_table(&table, &mockGetInstanceProcAddr, cInstance, 0, nullptr);
+    REQUIRE(table.vkDestroyInstance != nullptr);
+    REQUIRE(table.vkCreateDevice != nullptr);
+    REQUIRE(table.vkGetDeviceProcAddr != nullptr);
+    REQUIRE(table.vkDestroySurfaceKHR == nullptr);
+    REQUIRE_FALSE(gQueried.contains("vkDestroySurfaceKHR"));
+
+    char const *const extensions[] = {"VK_KHR_surface"};
+    vk_load_instance_dispatch_table(&table, &mockGetInstanceProcAddr, cInstance, 1, extensions);
+    REQUIRE(table.vkDestroySurfaceKHR != nullptr);
+    REQUIRE(gQueried.contains("vkDestroySurfaceKHR"));
+}
+
+TEST_CASE("Promoted commands fall back to their extension's") {
+    resetMock();
+
+    // A Vulkan 1.0 instance, with only the extension that vkGetPhysicalDeviceFeatures2 came from
+    gUnavailable.insert("vkGetPhysicalDeviceFeatures2");
+    char const *const extensions[] = {"VK_KHR_get_physical_device_properties2"};
+
+    VkInstanceDispatchTable table;
+    vk_load_instance_dispatch_table(&table, &mockGetInstanceProcAddr, cInstance, 1, extensions);
+    REQUIRE(table.vkGetPhysicalDeviceFeatures2KHR != nullptr);
+    REQUIRE(table.vkGetPhysicalDeviceFeatures2 == table.vkGetPhysicalDeviceFeatures2KHR);
+
+    VkPhysicalDeviceFeatures2 features{};
+    table.vkGetPhysicalDeviceFeatures2(VK_NULL_HANDLE, &features);
+    REQUIRE(gFeatureQueries == 1);
+
+    // Without the extension, neither is available
+    vk_load_instance_dispatch_table(&table, &mockGetInstanceProcAddr, cInstance, 0, nullptr);
+    REQUIRE(table.vkGetPhysicalDeviceFeatures2 == nullptr);
+    REQUIRE(table.vkGetPhysicalDeviceFeatures2KHR == nullptr);
+}
+
+TEST_CASE("Device commands are loaded from the device") {
+    resetMock();
+
+    VkInstanceDispatchTable instanceTable;
+    vk_load_instance_dispatch_table(&instanceTable, &mockGetInstanceProcAddr, cInstance, 0,
+                                    nullptr);
+    // Using the mock's vkGetDeviceProcAddr, as the generic stand-in doesn't know about devices
+    instanceTable.vkGetDeviceProcAddr = &mockGetDeviceProcAddr;
+
+    VkDeviceDispatchTable table;
+    vk_load_device_dispatch_table(&table, instanceTable.vkGetDeviceProcAddr, cDevice, 0, nullptr);
+    REQUIRE(table.vkDestroyDevice != nullptr);
+    REQUIRE(table.vkCmdBeginRenderPass != nullptr);
+    REQUIRE(table.vkCmdPushDescriptorSetKHR == nullptr);
+
+    table.vkCmdDraw(VK_NULL_HANDLE, 3, 1, 0, 0);
+    table.vkCmdDraw(VK_NULL_HANDLE, 6, 1, 0, 0);
+    REQUIRE(gDrawCount == 9);
+
+    char const *const extensions[] = {"VK_KHR_swapchain", "VK_KHR_push_descriptor"};
+    vk_load_device_dispatch_table(&table, &mockGetDeviceProcAddr, cDevice, 2, extensions);
+    REQUIRE(table.vkCmdPushDescriptorSetKHR != nullptr);
+
+    // Commands the driver doesn't have are left null
+    gUnavailable.insert("vkCreateSampler");
+    vk_load_device_dispatch_table(&table, &mockGetDeviceProcAddr, cDevice, 0, nullptr);
+    REQUIRE(table.vkCreateSampler == nullptr);
+    REQUIRE(table.vkCmdDraw != nullptr);
+}
@@ -0,0 +1,119 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#include "vk_enum_validation.hpp"
+
+#include <vector>
+
+// The checks are usable at compile time
+static_assert(vk_is_valid(VK_FORMAT_R8G8B8A8_UNORM));
+static_assert(!vk_is_valid(static_cast<VkFormat>(0x7FFFFFFE)));
+static_assert(vk_valid_mask<VkCullModeFlagBits> == 0x3);
+
+TEST_CASE("Enum values") {
+    REQUIRE(vk_is_valid(VK_FORMAT_UNDEFINED));
+    REQUIRE(vk_is_valid(VK_FORMAT_R4G4_UNORM_PACK8));
+    REQUIRE(vk_is_valid(VK_IMAGE_LAYOUT_GENERAL));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkFormat>(4000)));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkFormat>(0x7FFFFFFE)));
+
+    // Extension and promoted values
+    REQUIRE(vk_is_valid(VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG));
+    REQUIRE(vk_is_valid(VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM));
+    REQUIRE(vk_is_valid(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2));
+    REQUIRE(vk_is_valid(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkFormat>(1000156999)));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkFormat>(1000054999)));
+}
+
+TEST_CASE("Negative values") {
+    REQUIRE(vk_is_valid(VK_SUCCESS));
+    REQUIRE(vk_is_valid(VK_ERROR_OUT_OF_HOST_MEMORY));
+    REQUIRE(vk_is_valid(VK_ERROR_OUT_OF_POOL_MEMORY));
+    REQUIRE(vk_is_valid(VK_ERROR_SURFACE_LOST_KHR));
+    REQUIRE(vk_is_valid(VK_SUBOPTIMAL_KHR));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkResult>(-14)));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkResult>(-1000000002)));
+
+    // Values of disabled extensions aren't valid
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkResult>(-1000199000)));
+}
+
+// No registry has assigned bit 30 of any of the flags tested
+constexpr VkFlags cUnusedBit = 0x40000000;
+
+TEST_CASE("Flags") {
+    VkFlags const aspects = VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_DEPTH_BIT |
+                            VK_IMAGE_ASPECT_STENCIL_BIT | VK_IMAGE_ASPECT_METADATA_BIT |
+                            VK_IMAGE_ASPECT_PLANE_0_BIT | VK_IMAGE_ASPECT_PLANE_1_BIT |
+                            VK_IMAGE_ASPECT_PLANE_2_BIT;
+    REQUIRE((vk_valid_mask<VkImageAspectFlagBits> & aspects) == aspects);
+    REQUIRE((vk_valid_mask<VkImageAspectFlagBits> & cUnusedBit) == 0);
+
+    VkFlags const layoutFlags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR |
+                                VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    REQUIRE((vk_valid_mask<VkDescriptorSetLayoutCreateFlagBits> & layoutFlags) == layoutFlags);
+    REQUIRE((vk_valid_mask<VkSamplerCreateFlagBits> & cUnusedBit) == 0);
+
+    REQUIRE(vk_is_valid_flags<VkAccessFlagBits>(0));
+    REQUIRE(vk_is_valid_flags<VkAccessFlagBits>(VK_ACCESS_INDEX_READ_BIT |
+                                                VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT));
+    REQUIRE_FALSE(vk_is_valid_flags<VkAccessFlagBits>(VK_ACCESS_INDEX_READ_BIT | cUnusedBit));
+    REQUIRE_FALSE(vk_is_valid_flags<VkSamplerCreateFlagBits>(cUnusedBit));
+
+    REQUIRE(vk_is_valid(VK_CULL_MODE_FRONT_AND_BACK));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkCullModeFlagBits>(0x4)));
+}
+
+TEST_CASE("Composite flag values") {
+    // Only single bits make up the mask, rather than values such as VK_SHADER_STAGE_ALL
+    VkFlags const stages = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT;
+    REQUIRE((vk_valid_mask<VkShaderStageFlagBits> & stages) == stages);
+    REQUIRE((vk_valid_mask<VkShaderStageFlagBits> & cUnusedBit) == 0);
+    REQUIRE(vk_is_valid_flags<VkShaderStageFlagBits>(VK_SHADER_STAGE_VERTEX_BIT |
+                                                     VK_SHADER_STAGE_COMPUTE_BIT));
+    REQUIRE_FALSE(
+        vk_is_valid_flags<VkShaderStageFlagBits>(VK_SHADER_STAGE_VERTEX_BIT | cUnusedBit));
+
+    // Though they are valid as a whole
+    REQUIRE(vk_is_valid_flags<VkShaderStageFlagBits>(VK_SHADER_STAGE_ALL_GRAPHICS));
+    REQUIRE(vk_is_valid_flags<VkShaderStageFlagBits>(VK_SHADER_STAGE_ALL));
+    REQUIRE(vk_is_valid(VK_SHADER_STAGE_ALL));
+    REQUIRE_FALSE(vk_is_valid(static_cast<VkShaderStageFlagBits>(VK_SHADER_STAGE_ALL - 1)));
+
+    VkFlags const stageArray[] = {VK_SHADER_STAGE_ALL, VK_SHADER_STAGE_FRAGMENT_BIT};
+    REQUIRE(vk_all_valid_flags<VkShaderStageFlagBits>(stageArray, 2));
+    VkFlags const badStages[] = {VK_SHADER_STAGE_ALL, VK_SHADER_STAGE_FRAGMENT_BIT | cUnusedBit};
+    REQUIRE_FALSE(vk_all_valid_flags<VkShaderStageFlagBits>(badStages, 2));
+}
+
+TEST_CASE("Whole arrays") {
+    std::vector<VkFormat> formats(1000, VK_FORMAT_R8G8B8A8_SRGB);
+    formats[10] = VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG;
+    REQUIRE(vk_all_valid(formats.data(), formats.size()));
+    REQUIRE(vk_all_valid<VkFormat>(nullptr, 0));
+
+    formats[500] = static_cast<VkFormat>(1000054999);
+    REQUIRE_FALSE(vk_all_valid(formats.data(), formats.size()));
+
+    std::vector<VkFlags> flags(1000, VK_SAMPLE_COUNT_4_BIT);
+    REQUIRE(vk_all_valid_flags<VkSampleCountFlagBits>(flags.data(), flags.size()));
+    flags.back() = 0x80;
+    REQUIRE_FALSE(vk_all_valid_flags<VkSampleCountFlagBits>(flags.data(), flags.size()));
+}
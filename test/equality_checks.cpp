@@ -20,7 +20,9 @@
 #define VK_EQUALITY_CHECK_CONFIG_MAIN
 #include "vk_equality_checks.hpp"
 
+#include <algorithm>
 #include <array>
+#include <vector>
 
 TEST_CASE("VkApplicationInfo - strcmp for null-terminated data") {
     SECTION("Empty nullptr data") {
@@ -147,4 +149,266 @@ TEST_CASE("VkPipelineViewportStateCreateInfo - Checking variable data arrays") {
         REQUIRE_FALSE(test1 == test2);
         REQUIRE(test1 != test2);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("VkPipelineVertexInputStateCreateInfo - Checking arrays of plain structs") {
+    std::array<VkVertexInputAttributeDescription, 3> data1{
+        VkVertexInputAttributeDescription{.location = 0, .format = VK_FORMAT_R8_UNORM},
+        VkVertexInputAttributeDescription{.location = 1, .offset = 4},
+        VkVertexInputAttributeDescription{.location = 2, .offset = 8},
+    };
+    std::array<VkVertexInputAttributeDescription, 3> data2 = data1;
+
+    VkPipelineVertexInputStateCreateInfo test1{.vertexAttributeDescriptionCount = data1.size(),
+                                               .pVertexAttributeDescriptions = data1.data()};
+    VkPipelineVertexInputStateCreateInfo test2{.vertexAttributeDescriptionCount = data2.size(),
+                                               .pVertexAttributeDescriptions = data2.data()};
+
+    SECTION("Same data") {
+        REQUIRE(test1 == test2);
+        REQUIRE_FALSE(test1 != test2);
+    }
+    SECTION("Different last element") {
+        data2[2].offset = 12;
+
+        REQUIRE_FALSE(test1 == test2);
+        REQUIRE(test1 != test2);
+    }
+    SECTION("Differences past the count are ignored") {
+        data2[2].offset = 12;
+        test1.vertexAttributeDescriptionCount = 2;
+        test2.vertexAttributeDescriptionCount = 2;
+
+        REQUIRE(test1 == test2);
+    }
+}
+
+TEST_CASE("VkPipelineColorBlendAttachmentState - Member diff") {
+    VkPipelineColorBlendAttachmentState test1{};
+    VkPipelineColorBlendAttachmentState test2{};
+
+    SECTION("Equal structs have no differing members") {
+        auto diff = vk_diff(test1, test2);
+
+        REQUIRE(diff.none());
+        REQUIRE(diff.size() == 8);
+    }
+    SECTION("Only changed members are reported") {
+        test2.blendEnable = VK_TRUE;
+        test2.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+
+        auto diff = vk_diff(test1, test2);
+
+        REQUIRE(diff.count() == 2);
+        REQUIRE(diff[0]);
+        REQUIRE(diff[7]);
+        REQUIRE(vk_diff_member_name<VkPipelineColorBlendAttachmentState>(0) == "blendEnable");
+        REQUIRE(vk_diff_member_name<VkPipelineColorBlendAttachmentState>(7) == "colorWriteMask");
+        REQUIRE(vk_diff_member_name<VkPipelineColorBlendAttachmentState>(8).empty());
+    }
+}
+
+TEST_CASE("VkPipelineViewportStateCreateInfo - Member diff of variable data arrays") {
+    std::array<VkViewport, 2> data1{VkViewport{.x = 1}, VkViewport{.x = 3}};
+    std::array<VkViewport, 2> data2{VkViewport{.x = 1}, VkViewport{.x = 3}};
+    std::array<VkViewport, 2> data3{VkViewport{.x = 1}, VkViewport{.x = 4}};
+
+    SECTION("Same data at different pointers") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = data1.size(),
+                                                .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = data2.size(),
+                                                .pViewports = data2.data()};
+
+        REQUIRE(vk_diff(test1, test2).none());
+    }
+    SECTION("Different data") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = data1.size(),
+                                                .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = data3.size(),
+                                                .pViewports = data3.data()};
+
+        auto diff = vk_diff(test1, test2);
+        REQUIRE(diff.count() == 1);
+        REQUIRE(vk_diff_member_name<VkPipelineViewportStateCreateInfo>(4) == "pViewports");
+        REQUIRE(diff[4]);
+    }
+    SECTION("Different counts also mark the array") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = 1, .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = 2, .pViewports = data1.data()};
+
+        auto diff = vk_diff(test1, test2);
+        REQUIRE(diff.count() == 2);
+        REQUIRE(diff[3]);
+        REQUIRE(diff[4]);
+    }
+}
+
+TEST_CASE("VkRenderPassBeginInfo - Member diff of union arrays") {
+    std::array<VkClearValue, 2> data1{};
+    std::array<VkClearValue, 2> data2{};
+    data1[1].depthStencil = data2[1].depthStencil = VkClearDepthStencilValue{.depth = 1.f};
+
+    VkRenderPassBeginInfo test1{.clearValueCount = data1.size(), .pClearValues = data1.data()};
+    VkRenderPassBeginInfo test2{.clearValueCount = data2.size(), .pClearValues = data2.data()};
+
+    SECTION("Same bytes at different pointers") {
+        REQUIRE(vk_diff(test1, test2).none());
+        REQUIRE(vk_diff_member_name<VkRenderPassBeginInfo>(6) == "pClearValues");
+    }
+    SECTION("Different bytes") {
+        data2[1].depthStencil.stencil = 1;
+
+        auto diff = vk_diff(test1, test2);
+        REQUIRE(diff.count() == 1);
+        REQUIRE(diff[6]);
+    }
+    SECTION("Differences past the count are ignored") {
+        data2[1].depthStencil.stencil = 1;
+        test1.clearValueCount = 1;
+        test2.clearValueCount = 1;
+
+        REQUIRE(vk_diff(test1, test2).none());
+    }
+    SECTION("Different counts also mark the array") {
+        test2.clearValueCount = 1;
+
+        auto diff = vk_diff(test1, test2);
+        REQUIRE(diff.count() == 2);
+        REQUIRE(diff[5]);
+        REQUIRE(diff[6]);
+    }
+    SECTION("Other members are compared as usual") {
+        test2.renderArea.extent.width = 4;
+
+        auto diff = vk_diff(test1, test2);
+        REQUIRE(diff.count() == 1);
+        REQUIRE(diff[4]);
+    }
+}
+
+TEST_CASE("Equal structs hash the same") {
+    SECTION("Strings hash by content") {
+        std::array<char, 5> str1{"Test"};
+        std::array<char, 5> str2{"Test"};
+
+        VkApplicationInfo test1{.pApplicationName = str1.data()};
+        VkApplicationInfo test2{.pApplicationName = str2.data()};
+
+        REQUIRE(test1 == test2);
+        REQUIRE(vk_hash(test1) == vk_hash(test2));
+    }
+    SECTION("Variable data arrays hash by content") {
+        std::array<VkViewport, 2> data1{VkViewport{.x = 1}, VkViewport{.x = 3}};
+        std::array<VkViewport, 2> data2{VkViewport{.x = 1}, VkViewport{.x = 3}};
+
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = data1.size(),
+                                                .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = data2.size(),
+                                                .pViewports = data2.data()};
+
+        REQUIRE(test1 == test2);
+        REQUIRE(vk_hash(test1) == vk_hash(test2));
+    }
+    SECTION("Positive and negative zero") {
+        VkSamplerCreateInfo test1{.mipLodBias = 0.f};
+        VkSamplerCreateInfo test2{.mipLodBias = -0.f};
+
+        REQUIRE(test1 == test2);
+        REQUIRE(vk_hash(test1) == vk_hash(test2));
+    }
+    SECTION("Ignores pNext") {
+        VkSamplerCreateInfo dummy{};
+        VkSamplerCreateInfo test1{};
+        VkSamplerCreateInfo test2{.pNext = &dummy};
+
+        REQUIRE(vk_hash(test1) == vk_hash(test2));
+    }
+}
+
+#ifdef __cpp_impl_three_way_comparison
+
+TEST_CASE("VkApplicationInfo - Three-way comparison of null-terminated data") {
+    std::string str1 = "aaa";
+    std::string str2 = "aaa";
+    std::string str3 = "bbb";
+
+    SECTION("Empty nullptr data") {
+        VkApplicationInfo test1{};
+        VkApplicationInfo test2{};
+
+        REQUIRE(std::is_eq(test1 <=> test2));
+    }
+    SECTION("Null data orders before real data") {
+        VkApplicationInfo test1{};
+        VkApplicationInfo test2{.pApplicationName = str1.data()};
+
+        REQUIRE(test1 < test2);
+        REQUIRE(test2 > test1);
+    }
+    SECTION("Same data string at different pointers") {
+        VkApplicationInfo test1{.pApplicationName = str1.data()};
+        VkApplicationInfo test2{.pApplicationName = str2.data()};
+
+        REQUIRE(std::is_eq(test1 <=> test2));
+    }
+    SECTION("Different data strings") {
+        VkApplicationInfo test1{.pApplicationName = str1.data()};
+        VkApplicationInfo test2{.pApplicationName = str3.data()};
+
+        REQUIRE(test1 < test2);
+        REQUIRE_FALSE(test2 < test1);
+    }
+}
+
+TEST_CASE("VkPipelineViewportStateCreateInfo - Three-way comparison of variable data arrays") {
+    std::array<VkViewport, 2> data1{VkViewport{.x = 1}, VkViewport{.x = 3}};
+    std::array<VkViewport, 2> data2{VkViewport{.x = 1}, VkViewport{.x = 3}};
+    std::array<VkViewport, 2> data3{VkViewport{.x = 1}, VkViewport{.x = 4}};
+
+    SECTION("Fewer elements orders first") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = 1, .pViewports = data3.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = 2, .pViewports = data1.data()};
+
+        REQUIRE(test1 < test2);
+    }
+    SECTION("Same data") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = data1.size(),
+                                                .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = data2.size(),
+                                                .pViewports = data2.data()};
+
+        REQUIRE(std::is_eq(test1 <=> test2));
+        REQUIRE(test1 == test2);
+    }
+    SECTION("Different data") {
+        VkPipelineViewportStateCreateInfo test1{.viewportCount = data1.size(),
+                                                .pViewports = data1.data()};
+        VkPipelineViewportStateCreateInfo test2{.viewportCount = data3.size(),
+                                                .pViewports = data3.data()};
+
+        REQUIRE(test1 < test2);
+        REQUIRE(test1 != test2);
+    }
+}
+
+TEST_CASE("VkSamplerCreateInfo - Sorted flat storage") {
+    std::vector<VkSamplerCreateInfo> samplers{
+        VkSamplerCreateInfo{.magFilter = VK_FILTER_LINEAR, .maxLod = 4.f},
+        VkSamplerCreateInfo{.magFilter = VK_FILTER_NEAREST, .maxLod = 1.f},
+        VkSamplerCreateInfo{.magFilter = VK_FILTER_LINEAR, .maxLod = 2.f},
+        VkSamplerCreateInfo{.magFilter = VK_FILTER_NEAREST, .maxLod = 1.f},
+    };
+
+    std::sort(samplers.begin(), samplers.end());
+    samplers.erase(std::unique(samplers.begin(), samplers.end()), samplers.end());
+
+    REQUIRE(samplers.size() == 3);
+    REQUIRE(std::is_sorted(samplers.begin(), samplers.end()));
+    REQUIRE(std::binary_search(samplers.begin(), samplers.end(),
+                               VkSamplerCreateInfo{.magFilter = VK_FILTER_LINEAR, .maxLod = 2.f}));
+    REQUIRE_FALSE(std::binary_search(
+        samplers.begin(), samplers.end(),
+        VkSamplerCreateInfo{.magFilter = VK_FILTER_LINEAR, .maxLod = 3.f}));
+}
+
+#endif // __cpp_impl_three_way_comparison
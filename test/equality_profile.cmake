@@ -0,0 +1,50 @@
+# Generates the equality checks again with the profile written by VkEqualityProfileTests, and
+# checks that the members listed in it are now compared first.
+#
+# Expects GENERATOR, REGISTRY, PROFILE and OUTPUT_DIR to be defined.
+
+file(MAKE_DIRECTORY ${OUTPUT_DIR})
+execute_process(
+  COMMAND ${GENERATOR} -i ${REGISTRY} -d ${OUTPUT_DIR}/ -o vk_equality_checks.hpp -p ${PROFILE}
+  RESULT_VARIABLE RESULT)
+if(NOT RESULT EQUAL 0)
+  message(FATAL_ERROR "Failed to generate the equality checks with the profile ${PROFILE}")
+endif()
+
+file(READ ${OUTPUT_DIR}/vk_equality_checks.hpp HEADER)
+
+# Checks that, in the operator== definition of the struct, each given piece of code comes after
+# the one before it.
+function(check_order STRUCT)
+  # The definition comes after the declaration
+  string(FIND "${HEADER}" "bool operator==(${STRUCT} const &lhs," START REVERSE)
+  string(SUBSTRING "${HEADER}" ${START} -1 BODY)
+  string(FIND "${BODY}" "\n}\n" END)
+  string(SUBSTRING "${BODY}" 0 ${END} BODY)
+
+  set(LAST -1)
+  foreach(CODE IN LISTS ARGN)
+    string(FIND "${BODY}" "${CODE}" POSITION)
+    if(POSITION EQUAL -1)
+      message(FATAL_ERROR "${STRUCT}: '${CODE}' not found in:\n${BODY}")
+    endif()
+    if(NOT POSITION GREATER LAST)
+      message(FATAL_ERROR "${STRUCT}: '${CODE}' isn't compared in the profiled order:\n${BODY}")
+    endif()
+    set(LAST ${POSITION})
+  endforeach()
+endfunction()
+
+# The chained return of values
+check_order(VkPipelineColorBlendAttachmentState
+  "return (lhs.colorWriteMask == rhs.colorWriteMask)"
+  "(lhs.alphaBlendOp == rhs.alphaBlendOp)"
+  "(lhs.blendEnable == rhs.blendEnable)"
+  "(lhs.srcColorBlendFactor == rhs.srcColorBlendFactor)")
+
+# Arrays, with each count still checked before its array
+check_order(VkPipelineViewportStateCreateInfo
+  "lhs.scissorCount != rhs.scissorCount"
+  "arrayEqual(lhs.pScissors, rhs.pScissors"
+  "lhs.viewportCount != rhs.viewportCount"
+  "arrayEqual(lhs.pViewports, rhs.pViewports")
@@ -0,0 +1,104 @@
+/*
+    Copyright (C) 2020 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+// Generated with --instrument
+#define VK_EQUALITY_CHECK_CONFIG_MAIN
+#include "vk_equality_checks.hpp"
+
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace {
+
+std::set<std::string> profileLines(std::string const &profile) {
+    std::set<std::string> lines;
+    std::istringstream stream(profile);
+    std::string line;
+    while (std::getline(stream, line))
+        lines.insert(line);
+    return lines;
+}
+
+} // namespace
+
+// The mismatch counts are kept for the whole run, so everything is recorded in the one test case
+TEST_CASE("Instrumented checks record mismatches and write the ordering profile") {
+    VkPipelineColorBlendAttachmentState const attachment{
+        .blendEnable = VK_TRUE,
+        .alphaBlendOp = VK_BLEND_OP_ADD,
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT,
+    };
+
+    VkViewport const viewports[2] = {{.width = 1.f}, {.width = 2.f}};
+    VkRect2D const scissors[2] = {{.extent = {1, 1}}, {.extent = {2, 2}}};
+    VkPipelineViewportStateCreateInfo const viewportState{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = 1,
+        .pViewports = &viewports[0],
+        .scissorCount = 1,
+        .pScissors = &scissors[0],
+    };
+
+    SECTION("Equal structs still compare equal") {
+        REQUIRE(attachment == attachment);
+        REQUIRE(viewportState == viewportState);
+    }
+
+    // colorWriteMask differs three times, alphaBlendOp twice and blendEnable once
+    for (int i = 0; i < 3; ++i) {
+        auto other = attachment;
+        other.colorWriteMask = VK_COLOR_COMPONENT_G_BIT;
+        if (i < 2)
+            other.alphaBlendOp = VK_BLEND_OP_SUBTRACT;
+        if (i < 1)
+            other.blendEnable = VK_FALSE;
+
+        REQUIRE(attachment != other);
+    }
+
+    // pScissors differs twice and pViewports once
+    for (int i = 0; i < 2; ++i) {
+        auto other = viewportState;
+        other.pScissors = &scissors[1];
+        if (i < 1)
+            other.pViewports = &viewports[1];
+
+        REQUIRE(viewportState != other);
+    }
+
+    std::ostringstream profile;
+    vk_equality_profile_write(profile);
+    auto const lines = profileLines(profile.str());
+
+    CHECK(lines.contains("VkPipelineColorBlendAttachmentState colorWriteMask alphaBlendOp "
+                         "blendEnable"));
+    CHECK(lines.contains("VkPipelineViewportStateCreateInfo pScissors pViewports"));
+    // Structs compared within the arrays are recorded too
+    CHECK(lines.contains("VkRect2D extent"));
+    CHECK(lines.contains("VkViewport width"));
+    // Structs that never differed are left out
+    CHECK(profile.str().find("VkOffset2D") == std::string::npos);
+
+    // Written out for the header to be generated again with this profile
+    std::ofstream profileFile(EQUALITY_PROFILE_FILE);
+    REQUIRE(profileFile.is_open());
+    profileFile << profile.str();
+}
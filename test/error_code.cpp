@@ -20,6 +20,12 @@
 #define VK_ERROR_CODE_CONFIG_MAIN
 #include "vk_error_code.hpp"
 
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 TEST_CASE("Success Case") {
     std::error_code test = VK_SUCCESS;
 
@@ -86,4 +92,192 @@ TEST_CASE("Unknown negative error cases") {
         REQUIRE(test.category().name() == std::string{"VkResult"});
         REQUIRE(test.message() == std::string{"(unrecognized negative VkResult value)"});
     }
-}
\ No newline at end of file
+}
+
+static_assert(vk_result_name(VK_ERROR_OUT_OF_HOST_MEMORY) == "VK_ERROR_OUT_OF_HOST_MEMORY");
+static_assert(vk_result_description(VK_SUCCESS) == "Command completed successfully");
+
+TEST_CASE("Names and descriptions without allocating") {
+    CHECK(vk_result_name(VK_SUCCESS) == "VK_SUCCESS");
+    CHECK(vk_result_name(VK_TIMEOUT) == "VK_TIMEOUT");
+    CHECK(vk_result_name(VK_ERROR_UNKNOWN) == "VK_ERROR_UNKNOWN");
+    CHECK(vk_result_description(VK_ERROR_OUT_OF_HOST_MEMORY) ==
+          "A host memory allocation has failed");
+
+    // Extension values, positive and negative within the same extension
+    CHECK(vk_result_name(VK_SUBOPTIMAL_KHR) == "VK_SUBOPTIMAL_KHR");
+    CHECK(vk_result_name(VK_ERROR_OUT_OF_DATE_KHR) == "VK_ERROR_OUT_OF_DATE_KHR");
+    CHECK(vk_result_name(VK_ERROR_SURFACE_LOST_KHR) == "VK_ERROR_SURFACE_LOST_KHR");
+
+    // Promoted values, and their aliases, have the core name
+    CHECK(vk_result_name(VK_ERROR_OUT_OF_POOL_MEMORY) == "VK_ERROR_OUT_OF_POOL_MEMORY");
+    CHECK(vk_result_name(VK_ERROR_OUT_OF_POOL_MEMORY_KHR) == "VK_ERROR_OUT_OF_POOL_MEMORY");
+
+    // Unknown values have neither
+    for (int value : {6, -14, 1000, -1000, 1000001002, -1000001002, 1000999000, -2000000000}) {
+        CHECK(vk_result_name(static_cast<VkResult>(value)).empty());
+        CHECK(vk_result_description(static_cast<VkResult>(value)).empty());
+    }
+}
+
+namespace {
+
+vk_expected<uint32_t> countOrFail(VkResult result) {
+    if (result < 0)
+        return result;
+    return {result, 3};
+}
+
+vk_expected<std::string> describe(VkResult result) {
+    VK_TRY_ASSIGN(auto count, countOrFail(result));
+    return std::to_string(count) + " items";
+}
+
+vk_expected<void> check(VkResult result) {
+    VK_TRY(result);
+    VK_TRY(countOrFail(result));
+    return VK_SUCCESS;
+}
+
+} // namespace
+
+// Trivial values keep the whole type trivially copyable, so it can be returned in registers
+static_assert(std::is_trivially_copyable_v<vk_expected<uint64_t>>);
+static_assert(sizeof(vk_expected<uint32_t>) == 8);
+static_assert(vk_expected<int>{5}.value() == 5);
+static_assert(!vk_expected<int>{VK_ERROR_DEVICE_LOST}.has_value());
+
+TEST_CASE("Expected values and errors") {
+    auto success = countOrFail(VK_SUCCESS);
+    REQUIRE(success);
+    REQUIRE(*success == 3);
+    REQUIRE(success.result() == VK_SUCCESS);
+    REQUIRE_FALSE(success.error());
+
+    // Other success codes still have the value
+    auto incomplete = countOrFail(VK_INCOMPLETE);
+    REQUIRE(incomplete.has_value());
+    REQUIRE(incomplete.value() == 3);
+    REQUIRE(incomplete.result() == VK_INCOMPLETE);
+
+    auto failure = countOrFail(VK_ERROR_DEVICE_LOST);
+    REQUIRE_FALSE(failure);
+    REQUIRE(failure.result() == VK_ERROR_DEVICE_LOST);
+    REQUIRE(failure.error() == std::error_code{VK_ERROR_DEVICE_LOST});
+    REQUIRE(failure.error().message() == "VK_ERROR_DEVICE_LOST");
+    REQUIRE(failure.value_or(7) == 7);
+
+    // A success code alone has no value to go with it
+    vk_expected<uint32_t> noValue = VK_INCOMPLETE;
+    REQUIRE_FALSE(noValue);
+    REQUIRE(noValue.result() == VK_ERROR_UNKNOWN);
+
+    // Values with their own resources
+    vk_expected<std::string> str{std::string{"value"}};
+    auto copy = str;
+    auto moved = std::move(str);
+    REQUIRE(*copy == "value");
+    REQUIRE(*moved == "value");
+    copy = vk_expected<std::string>{VK_ERROR_OUT_OF_HOST_MEMORY};
+    REQUIRE_FALSE(copy);
+    copy = moved;
+    REQUIRE(copy->size() == 5);
+}
+
+TEST_CASE("Propagating errors with VK_TRY") {
+    REQUIRE(*describe(VK_SUCCESS) == "3 items");
+    REQUIRE(describe(VK_ERROR_OUT_OF_DEVICE_MEMORY).result() == VK_ERROR_OUT_OF_DEVICE_MEMORY);
+
+    REQUIRE(check(VK_SUCCESS));
+    REQUIRE(check(VK_TIMEOUT));
+    REQUIRE(check(VK_ERROR_INITIALIZATION_FAILED).result() == VK_ERROR_INITIALIZATION_FAILED);
+}
+
+namespace {
+
+uint64_t resultCount(VkResultCounterSnapshot const &snapshot, VkResult result) {
+    auto it = std::find_if(snapshot.results.begin(), snapshot.results.end(),
+                           [&](VkResultCount const &count) { return count.result == result; });
+    return (it != snapshot.results.end()) ? it->count : 0;
+}
+
+uint64_t siteCount(VkResultCounterSnapshot const &snapshot, VkResult result, uint32_t line) {
+    uint64_t count = 0;
+    for (auto const &site : snapshot.sites) {
+        if (site.result == result && site.line == line)
+            count += site.count;
+    }
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Counting results per call site") {
+    auto const before = vk_result_counter_snapshot();
+
+    REQUIRE(vk_check(VK_SUCCESS) == VK_SUCCESS);
+    uint32_t const timeoutLine = __LINE__ + 1;
+    REQUIRE(vk_check(VK_TIMEOUT) == VK_TIMEOUT);
+    REQUIRE(vk_check(VK_ERROR_DEVICE_LOST, std::source_location{}) == VK_ERROR_DEVICE_LOST);
+    uint32_t const unrecognizedLine = __LINE__ + 1;
+    REQUIRE(vk_check(static_cast<VkResult>(-12345)) == static_cast<VkResult>(-12345));
+
+    auto const after = vk_result_counter_snapshot();
+    REQUIRE(resultCount(after, VK_SUCCESS) - resultCount(before, VK_SUCCESS) == 1);
+    REQUIRE(resultCount(after, VK_TIMEOUT) - resultCount(before, VK_TIMEOUT) == 1);
+    REQUIRE(resultCount(after, VK_ERROR_DEVICE_LOST) - resultCount(before, VK_ERROR_DEVICE_LOST) ==
+            1);
+    REQUIRE(after.unrecognizedCount - before.unrecognizedCount == 1);
+    REQUIRE(resultCount(after, static_cast<VkResult>(-12345)) == 0);
+
+    // Only results other than VK_SUCCESS with a location are counted per site
+    REQUIRE(siteCount(after, VK_TIMEOUT, timeoutLine) == 1);
+    REQUIRE(siteCount(after, static_cast<VkResult>(-12345), unrecognizedLine) == 1);
+    auto site = std::find_if(after.sites.begin(), after.sites.end(),
+                             [&](VkResultSiteCount const &it) { return it.line == timeoutLine; });
+    REQUIRE(site != after.sites.end());
+    REQUIRE(std::string{site->file}.find("error_code.cpp") != std::string::npos);
+    REQUIRE(std::none_of(after.sites.begin(), after.sites.end(), [](VkResultSiteCount const &it) {
+        return it.result == VK_ERROR_DEVICE_LOST || it.result == VK_SUCCESS;
+    }));
+
+    auto report = vk_result_counter_report();
+    REQUIRE(report.find("VK_TIMEOUT: ") != std::string::npos);
+    REQUIRE(report.find("(unrecognized VkResult): ") != std::string::npos);
+    REQUIRE(report.find(std::to_string(unrecognizedLine) + " (") != std::string::npos);
+    REQUIRE(report.find("as VkResult -12345") != std::string::npos);
+    REQUIRE(report.find("error_code.cpp:" + std::to_string(timeoutLine)) != std::string::npos);
+}
+
+TEST_CASE("Counting results across threads") {
+    constexpr int cThreadCount = 4;
+    constexpr int cCheckCount = 10000;
+
+    auto const before = vk_result_counter_snapshot();
+
+    uint32_t const suboptimalLine = __LINE__ + 5;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < cThreadCount; ++i) {
+        threads.emplace_back([] {
+            for (int j = 0; j < cCheckCount; ++j) {
+                vk_check((j % 100 == 0) ? VK_SUBOPTIMAL_KHR : VK_SUCCESS);
+            }
+        });
+    }
+
+    // Counts are merged from running threads too, although they may not be complete yet
+    auto const during = vk_result_counter_snapshot();
+    REQUIRE(resultCount(during, VK_SUCCESS) >= resultCount(before, VK_SUCCESS));
+
+    for (auto &thread : threads)
+        thread.join();
+
+    // Exited threads have their counts kept
+    auto const after = vk_result_counter_snapshot();
+    REQUIRE(resultCount(after, VK_SUCCESS) - resultCount(before, VK_SUCCESS) ==
+            cThreadCount * (cCheckCount - cCheckCount / 100));
+    REQUIRE(resultCount(after, VK_SUBOPTIMAL_KHR) - resultCount(before, VK_SUBOPTIMAL_KHR) ==
+            cThreadCount * cCheckCount / 100);
+    REQUIRE(siteCount(after, VK_SUBOPTIMAL_KHR, suboptimalLine) ==
+            cThreadCount * cCheckCount / 100);
+}
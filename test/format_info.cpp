@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#include "vk_format_info.hpp"
+
+#include <string_view>
+
+// The tables are usable at compile time
+static_assert(vk_format_info(VK_FORMAT_R8G8B8A8_UNORM)->blockSize == 4);
+static_assert(vk_format_info(VK_FORMAT_D32_SFLOAT)->aspects == VK_IMAGE_ASPECT_DEPTH_BIT);
+static_assert(vk_format_info(VK_FORMAT_UNDEFINED) == nullptr);
+
+TEST_CASE("Uncompressed colour formats") {
+    auto const *pInfo = vk_format_info(VK_FORMAT_R8G8B8A8_SRGB);
+    REQUIRE(pInfo != nullptr);
+    REQUIRE(pInfo->format == VK_FORMAT_R8G8B8A8_SRGB);
+    REQUIRE(pInfo->name == "VK_FORMAT_R8G8B8A8_SRGB");
+    REQUIRE(pInfo->formatClass == "32-bit");
+    REQUIRE(pInfo->blockSize == 4);
+    REQUIRE(pInfo->texelsPerBlock == 1);
+    REQUIRE(pInfo->blockExtent[0] == 1);
+    REQUIRE(pInfo->blockExtent[1] == 1);
+    REQUIRE(pInfo->blockExtent[2] == 1);
+    REQUIRE(pInfo->packed == 0);
+    REQUIRE(pInfo->compression.empty());
+    REQUIRE(pInfo->aspects == VK_IMAGE_ASPECT_COLOR_BIT);
+    REQUIRE(pInfo->planeCount == 0);
+
+    REQUIRE(pInfo->componentCount == 4);
+    REQUIRE(pInfo->components[0].name == 'R');
+    REQUIRE(pInfo->components[0].bits == 8);
+    REQUIRE(pInfo->components[0].numericType == VkFormatNumericType::SRGB);
+    REQUIRE(pInfo->components[3].name == 'A');
+    REQUIRE(pInfo->components[3].numericType == VkFormatNumericType::UNORM);
+
+    // Formats of the same class are compatible
+    REQUIRE(vk_format_info(VK_FORMAT_B8G8R8A8_UNORM)->formatClass == pInfo->formatClass);
+    REQUIRE(vk_format_info(VK_FORMAT_B8G8R8A8_UNORM)->components[0].name == 'B');
+
+    auto const *pPacked = vk_format_info(VK_FORMAT_R4G4_UNORM_PACK8);
+    REQUIRE(pPacked->packed == 8);
+    REQUIRE(pPacked->components[0].bits == 4);
+}
+
+TEST_CASE("Depth and stencil formats") {
+    REQUIRE(vk_format_info(VK_FORMAT_D16_UNORM)->aspects == VK_IMAGE_ASPECT_DEPTH_BIT);
+    REQUIRE(vk_format_info(VK_FORMAT_S8_UINT)->aspects == VK_IMAGE_ASPECT_STENCIL_BIT);
+
+    auto const *pInfo = vk_format_info(VK_FORMAT_D24_UNORM_S8_UINT);
+    REQUIRE(pInfo->aspects == (VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT));
+    REQUIRE(pInfo->componentCount == 2);
+    REQUIRE(pInfo->components[0].name == 'D');
+    REQUIRE(pInfo->components[0].bits == 24);
+    REQUIRE(pInfo->components[1].name == 'S');
+    REQUIRE(pInfo->components[1].numericType == VkFormatNumericType::UINT);
+}
+
+TEST_CASE("Compressed formats") {
+    auto const *pBC1 = vk_format_info(VK_FORMAT_BC1_RGB_UNORM_BLOCK);
+    REQUIRE(pBC1->blockSize == 8);
+    REQUIRE(pBC1->texelsPerBlock == 16);
+    REQUIRE(pBC1->blockExtent[0] == 4);
+    REQUIRE(pBC1->blockExtent[1] == 4);
+    REQUIRE(pBC1->blockExtent[2] == 1);
+    REQUIRE(pBC1->compression == "BC");
+    REQUIRE(pBC1->componentCount == 3);
+    REQUIRE(pBC1->components[0].bits == 0);
+
+    auto const *pASTC = vk_format_info(VK_FORMAT_ASTC_6x6_UNORM_BLOCK);
+    REQUIRE(pASTC->blockSize == 16);
+    REQUIRE(pASTC->texelsPerBlock == 36);
+    REQUIRE(pASTC->blockExtent[0] == 6);
+    REQUIRE(pASTC->compression == "ASTC LDR");
+
+    // From an extension
+    auto const *pPVRTC = vk_format_info(VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG);
+    REQUIRE(pPVRTC != nullptr);
+    REQUIRE(pPVRTC->format == VK_FORMAT_PVRTC1_2BPP_UNORM_BLOCK_IMG);
+    REQUIRE(pPVRTC->blockExtent[0] == 8);
+    REQUIRE(pPVRTC->blockExtent[1] == 4);
+}
+
+TEST_CASE("Multi-planar and subsampled formats") {
+    auto const *pInfo = vk_format_info(VK_FORMAT_G8_B8_R8_3PLANE_420_UNORM);
+    REQUIRE(pInfo != nullptr);
+    REQUIRE(pInfo->chroma == 420);
+    REQUIRE(pInfo->aspects == (VK_IMAGE_ASPECT_COLOR_BIT | VK_IMAGE_ASPECT_PLANE_0_BIT |
+                               VK_IMAGE_ASPECT_PLANE_1_BIT | VK_IMAGE_ASPECT_PLANE_2_BIT));
+    REQUIRE(pInfo->planeCount == 3);
+    REQUIRE(pInfo->planes[0].widthDivisor == 1);
+    REQUIRE(pInfo->planes[1].widthDivisor == 2);
+    REQUIRE(pInfo->planes[2].heightDivisor == 2);
+    REQUIRE(pInfo->planes[2].compatible == VK_FORMAT_R8_UNORM);
+    REQUIRE(pInfo->components[1].name == 'B');
+    REQUIRE(pInfo->components[1].plane == 1);
+
+    auto const *pSubsampled = vk_format_info(VK_FORMAT_G8B8G8R8_422_UNORM);
+    REQUIRE(pSubsampled->chroma == 422);
+    REQUIRE(pSubsampled->blockExtent[0] == 2);
+    REQUIRE(pSubsampled->planeCount == 0);
+}
+
+TEST_CASE("Unknown formats") {
+    REQUIRE(vk_format_info(VK_FORMAT_UNDEFINED) == nullptr);
+    REQUIRE(vk_format_info(static_cast<VkFormat>(4000)) == nullptr);
+    REQUIRE(vk_format_info(static_cast<VkFormat>(1000054999)) == nullptr);
+    REQUIRE(vk_format_info(static_cast<VkFormat>(0x7FFFFFFE)) == nullptr);
+    REQUIRE(vk_format_info(static_cast<VkFormat>(-1)) == nullptr);
+}
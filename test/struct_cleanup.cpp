@@ -0,0 +1,722 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_STRUCT_CLEANUP_CONFIG_MAIN
+#include "vk_struct_cleanup.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename T>
+T *allocate(T const &value) {
+    auto *pNew = static_cast<T *>(malloc(sizeof(T)));
+    memcpy(pNew, &value, sizeof(T));
+    return pNew;
+}
+
+char *allocateString(char const *pStr) {
+    auto *pNew = static_cast<char *>(malloc(strlen(pStr) + 1));
+    strcpy(pNew, pStr);
+    return pNew;
+}
+
+// Counts live allocations made through VkAllocationCallbacks
+struct CountingAllocator {
+    int live = 0;
+    int total = 0;
+    // When set, allocations fail and are counted in `failed` instead
+    bool fail = false;
+    int failed = 0;
+
+    VkAllocationCallbacks callbacks() {
+        VkAllocationCallbacks callbacks{};
+        callbacks.pUserData = this;
+        callbacks.pfnAllocation = [](void *pUserData, size_t size, size_t alignment,
+                                     VkSystemAllocationScope) -> void * {
+            auto *pCounter = static_cast<CountingAllocator *>(pUserData);
+            if (pCounter->fail) {
+                ++pCounter->failed;
+                return nullptr;
+            }
+            ++pCounter->live;
+            ++pCounter->total;
+            return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        };
+        callbacks.pfnFree = [](void *pUserData, void *pMemory) {
+            if (pMemory == nullptr)
+                return;
+            --static_cast<CountingAllocator *>(pUserData)->live;
+            free(pMemory);
+        };
+        return callbacks;
+    }
+
+    template <typename T>
+    T *allocate(VkAllocationCallbacks const &callbacks, T const &value) {
+        auto *pNew = static_cast<T *>(callbacks.pfnAllocation(
+            callbacks.pUserData, sizeof(T), alignof(T), VK_SYSTEM_ALLOCATION_SCOPE_OBJECT));
+        memcpy(pNew, &value, sizeof(T));
+        return pNew;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Cleanup with allocation callbacks") {
+    CountingAllocator counter;
+    auto callbacks = counter.callbacks();
+
+    VkApplicationInfo *pNext = counter.allocate(
+        callbacks, VkApplicationInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO});
+    VkInstanceCreateInfo test{
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pNext = pNext,
+        .pApplicationInfo = counter.allocate(
+            callbacks, VkApplicationInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO}),
+    };
+    REQUIRE(counter.live == 2);
+
+    vk_struct_cleanup(&test, &callbacks);
+    REQUIRE(counter.live == 0);
+}
+
+TEST_CASE("Deep copy with allocation callbacks") {
+    CountingAllocator counter;
+    auto callbacks = counter.callbacks();
+
+    REQUIRE(vk_struct_deep_copy(nullptr, &callbacks) == nullptr);
+    REQUIRE(counter.total == 0);
+
+    std::string appName = "Application";
+    VkApplicationInfo appInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                              .pApplicationName = appName.data()};
+    VkInstanceCreateInfo test{.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                              .pNext = &appInfo,
+                              .pApplicationInfo = &appInfo};
+
+    // The whole graph is the one allocation
+    auto *pCopy = static_cast<VkInstanceCreateInfo *>(vk_struct_deep_copy(&test, &callbacks));
+    REQUIRE(pCopy != nullptr);
+    REQUIRE(counter.live == 1);
+    REQUIRE(strcmp(pCopy->pApplicationInfo->pApplicationName, "Application") == 0);
+
+    callbacks.pfnFree(callbacks.pUserData, pCopy);
+    REQUIRE(counter.live == 0);
+
+    // Without callbacks, from malloc
+    pCopy = static_cast<VkInstanceCreateInfo *>(vk_struct_deep_copy(&test, nullptr));
+    REQUIRE(pCopy != nullptr);
+    free(pCopy);
+}
+
+TEST_CASE("Arena blocks from allocation callbacks") {
+    CountingAllocator counter;
+    auto callbacks = counter.callbacks();
+
+    {
+        VkStructArena arena{&callbacks, 256};
+        VkApplicationInfo test{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO};
+        for (int i = 0; i < 16; ++i)
+            REQUIRE(vk_struct_deep_copy(&test, arena) != nullptr);
+        REQUIRE(counter.live > 1);
+    }
+    REQUIRE(counter.live == 0);
+}
+
+TEST_CASE("Cleanup of null or unknown structs") {
+    vk_struct_cleanup(nullptr);
+
+    VkApplicationInfo test{.sType = static_cast<VkStructureType>(0x7FFFFFFF)};
+    vk_struct_cleanup(&test);
+}
+
+TEST_CASE("Cleanup of a heap-allocated struct graph") {
+    auto *pStages = static_cast<VkPipelineShaderStageCreateInfo *>(
+        malloc(2 * sizeof(VkPipelineShaderStageCreateInfo)));
+    for (int i = 0; i < 2; ++i) {
+        pStages[i] = {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                      .pNext = allocate(VkApplicationInfo{
+                          .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                          .pApplicationName = allocateString("Application"),
+                      }),
+                      .pName = allocateString("main")};
+    }
+
+    VkVertexInputBindingDescription binding{.binding = 0, .stride = 16};
+    VkGraphicsPipelineCreateInfo test{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = 2,
+        .pStages = pStages,
+        .pVertexInputState = allocate(VkPipelineVertexInputStateCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+            .vertexBindingDescriptionCount = 1,
+            .pVertexBindingDescriptions = allocate(binding),
+        }),
+    };
+
+    // Everything pointed to is freed, which is checked when run with a leak sanitizer
+    vk_struct_cleanup(&test);
+}
+
+TEST_CASE("Cleanup and deep copy of a long pNext chain without recursion") {
+    // Long enough to exhaust the stack, if each link took a stack frame
+    constexpr uint32_t cLinks = 200000;
+    VkApplicationInfo *pChain = nullptr;
+    for (uint32_t i = 0; i < cLinks; ++i) {
+        pChain = allocate(VkApplicationInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                                            .pNext = pChain,
+                                            .applicationVersion = i});
+    }
+    VkInstanceCreateInfo test{.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, .pNext = pChain};
+
+    VkStructArena arena;
+    auto *pCopy = static_cast<VkInstanceCreateInfo *>(vk_struct_deep_copy(&test, arena));
+    REQUIRE(pCopy != nullptr);
+    REQUIRE(vk_struct_deep_size(&test) ==
+            sizeof(VkInstanceCreateInfo) + cLinks * sizeof(VkApplicationInfo));
+
+    uint32_t links = 0;
+    bool inOrder = true;
+    for (auto const *pLink = static_cast<VkApplicationInfo const *>(pCopy->pNext);
+         pLink != nullptr; pLink = static_cast<VkApplicationInfo const *>(pLink->pNext)) {
+        inOrder = inOrder && pLink->applicationVersion == cLinks - 1 - links;
+        ++links;
+    }
+    REQUIRE(links == cLinks);
+    REQUIRE(inOrder);
+
+    vk_struct_cleanup(&test);
+}
+
+TEST_CASE("Walking a struct graph visits each struct before what it points to") {
+    std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+    VkApplicationInfo stageNext{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stages[0].pNext = &stageNext;
+    stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    VkGraphicsPipelineCreateInfo test{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = stages.size(),
+        .pStages = stages.data(),
+        .pVertexInputState = &vertexInput,
+    };
+
+    std::vector<void const *> visited;
+    vk_struct_walk(
+        &test,
+        [](void const *pStruct, void *pUserData) {
+            static_cast<std::vector<void const *> *>(pUserData)->push_back(pStruct);
+        },
+        &visited);
+
+    std::vector<void const *> expected{&test, &stages[0], &stageNext, &stages[1], &vertexInput};
+    REQUIRE(visited == expected);
+}
+
+TEST_CASE("Deep copy of null or unknown structs") {
+    VkStructArena arena;
+
+    REQUIRE(vk_struct_deep_copy(nullptr, arena) == nullptr);
+
+    VkApplicationInfo test{.sType = static_cast<VkStructureType>(0x7FFFFFFF)};
+    REQUIRE(vk_struct_deep_copy(&test, arena) == nullptr);
+}
+
+TEST_CASE("Deep copy of strings and the pNext chain") {
+    VkStructArena arena;
+
+    std::string appName = "Application";
+    std::array<char const *, 2> layers{"LayerA", "LayerB"};
+    VkApplicationInfo appInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                              .pApplicationName = appName.data()};
+    VkInstanceCreateInfo test{.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                              .pNext = &appInfo,
+                              .pApplicationInfo = &appInfo,
+                              .enabledLayerCount = layers.size(),
+                              .ppEnabledLayerNames = layers.data()};
+
+    auto *pCopy = static_cast<VkInstanceCreateInfo *>(vk_struct_deep_copy(&test, arena));
+    REQUIRE(pCopy != nullptr);
+    REQUIRE(pCopy != &test);
+    REQUIRE(pCopy->sType == VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO);
+
+    auto const *pNext = static_cast<VkApplicationInfo const *>(pCopy->pNext);
+    REQUIRE(pNext != &appInfo);
+    REQUIRE(pNext->sType == VK_STRUCTURE_TYPE_APPLICATION_INFO);
+    REQUIRE(pNext->pApplicationName != appName.data());
+    REQUIRE(strcmp(pNext->pApplicationName, "Application") == 0);
+
+    REQUIRE(pCopy->pApplicationInfo != &appInfo);
+    REQUIRE(strcmp(pCopy->pApplicationInfo->pApplicationName, "Application") == 0);
+
+    REQUIRE(pCopy->enabledLayerCount == 2);
+    REQUIRE(pCopy->ppEnabledLayerNames != layers.data());
+    REQUIRE(strcmp(pCopy->ppEnabledLayerNames[0], "LayerA") == 0);
+    REQUIRE(strcmp(pCopy->ppEnabledLayerNames[1], "LayerB") == 0);
+
+    // The copy does not depend on the source
+    appName = "Changed";
+    REQUIRE(strcmp(pNext->pApplicationName, "Application") == 0);
+}
+
+TEST_CASE("Deep copy of arrays of structs with their own data") {
+    VkStructArena arena;
+
+    std::array<VkSampler, 2> samplers{reinterpret_cast<VkSampler>(1),
+                                      reinterpret_cast<VkSampler>(2)};
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{
+        VkDescriptorSetLayoutBinding{.binding = 0, .descriptorCount = 2,
+                                     .pImmutableSamplers = samplers.data()},
+        VkDescriptorSetLayoutBinding{.binding = 1, .descriptorCount = 1},
+    };
+    VkDescriptorSetLayoutCreateInfo test{.sType =
+                                             VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                                         .bindingCount = bindings.size(),
+                                         .pBindings = bindings.data()};
+
+    auto *pCopy = static_cast<VkDescriptorSetLayoutCreateInfo *>(vk_struct_deep_copy(&test, arena));
+    REQUIRE(pCopy->pBindings != bindings.data());
+    REQUIRE(pCopy->pBindings[1].binding == 1);
+    REQUIRE(pCopy->pBindings[0].pImmutableSamplers != samplers.data());
+    REQUIRE(pCopy->pBindings[0].pImmutableSamplers[1] == reinterpret_cast<VkSampler>(2));
+    REQUIRE(pCopy->pBindings[1].pImmutableSamplers == nullptr);
+}
+
+TEST_CASE("Arena reuse after reset") {
+    VkStructArena arena{256};
+
+    void *pFirst = arena.allocate(16, 8);
+    arena.allocate(1024, 8);
+    arena.reset();
+
+    REQUIRE(arena.allocate(16, 8) == pFirst);
+
+    // Requests larger than the block size still succeed
+    auto *pLarge = static_cast<char *>(arena.allocate(4096, 16));
+    memset(pLarge, 0, 4096);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(pLarge) % 16 == 0);
+}
+
+TEST_CASE("Exactly-sized contiguous clone") {
+    std::array<VkDynamicState, 2> dynamicStates{VK_DYNAMIC_STATE_VIEWPORT,
+                                                VK_DYNAMIC_STATE_SCISSOR};
+    std::array<VkViewport, 1> viewports{VkViewport{.width = 4.f}};
+    std::array<uint32_t, 3> code{1, 2, 3};
+    char const *pName = "main";
+    VkPipelineShaderStageCreateInfo stage{.sType =
+                                              VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                                          .pName = pName};
+    VkShaderModuleCreateInfo module{.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+                                    .codeSize = code.size() * sizeof(uint32_t),
+                                    .pCode = code.data()};
+    stage.pNext = &module;
+    VkPipelineViewportStateCreateInfo viewportState{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
+        .viewportCount = viewports.size(),
+        .pViewports = viewports.data()};
+    VkPipelineDynamicStateCreateInfo dynamicState{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = dynamicStates.size(),
+        .pDynamicStates = dynamicStates.data()};
+    VkGraphicsPipelineCreateInfo test{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                      .stageCount = 1,
+                                      .pStages = &stage,
+                                      .pViewportState = &viewportState,
+                                      .pDynamicState = &dynamicState};
+
+    std::size_t const size = vk_struct_deep_size(&test);
+    REQUIRE(size >= sizeof(VkGraphicsPipelineCreateInfo) + sizeof(VkPipelineShaderStageCreateInfo) +
+                        sizeof(VkShaderModuleCreateInfo) + sizeof(code) + 5);
+
+    void *pBuffer = malloc(size);
+    auto *pCopy = static_cast<VkGraphicsPipelineCreateInfo *>(vk_struct_clone_into(&test, pBuffer));
+    REQUIRE(pCopy == pBuffer);
+
+    // Everything lies within the buffer
+    auto inBuffer = [&](void const *pData) {
+        return pData >= pBuffer && pData < static_cast<char *>(pBuffer) + size;
+    };
+    REQUIRE(inBuffer(pCopy->pStages));
+    REQUIRE(inBuffer(pCopy->pStages[0].pName));
+    REQUIRE(strcmp(pCopy->pStages[0].pName, "main") == 0);
+    REQUIRE(inBuffer(pCopy->pStages[0].pNext));
+
+    auto const *pModule = static_cast<VkShaderModuleCreateInfo const *>(pCopy->pStages[0].pNext);
+    REQUIRE(inBuffer(pModule->pCode));
+    REQUIRE(pModule->pCode[2] == 3);
+
+    REQUIRE(inBuffer(pCopy->pViewportState->pViewports));
+    REQUIRE(pCopy->pViewportState->pViewports[0].width == 4.f);
+    REQUIRE(inBuffer(pCopy->pDynamicState->pDynamicStates));
+    REQUIRE(pCopy->pDynamicState->pDynamicStates[1] == VK_DYNAMIC_STATE_SCISSOR);
+    REQUIRE(pCopy->pVertexInputState == nullptr);
+
+    free(pBuffer);
+}
+
+TEST_CASE("Relocatable blob moved to another address") {
+    REQUIRE(vk_struct_blob_size(nullptr) == 0);
+
+    std::string appName = "Application";
+    std::array<char const *, 2> layers{"LayerA", "LayerB"};
+    VkApplicationInfo appInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                              .pApplicationName = appName.data()};
+    VkInstanceCreateInfo test{.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                              .pNext = &appInfo,
+                              .pApplicationInfo = &appInfo,
+                              .enabledLayerCount = layers.size(),
+                              .ppEnabledLayerNames = layers.data()};
+
+    std::size_t const size = vk_struct_blob_size(&test);
+    REQUIRE(size > vk_struct_deep_size(&test));
+
+    std::vector<std::max_align_t> written(size / sizeof(std::max_align_t) + 1);
+    REQUIRE(vk_struct_blob_write(&test, written.data(), size - 1) == 0);
+    REQUIRE(vk_struct_blob_write(&test, written.data(), size) == size);
+
+    // As if mapped elsewhere, with the original gone
+    std::vector<std::max_align_t> mapped{written};
+    std::fill(written.begin(), written.end(), std::max_align_t{});
+
+    auto *pView = static_cast<VkInstanceCreateInfo *>(vk_struct_blob_view(mapped.data(), size));
+    REQUIRE(pView != nullptr);
+    REQUIRE(vk_struct_blob_view(mapped.data(), size) == pView);
+
+    auto const *pBegin = reinterpret_cast<std::byte const *>(mapped.data());
+    auto inBlob = [&](void const *ptr) {
+        return ptr >= pBegin && ptr < pBegin + size;
+    };
+    REQUIRE(pView->sType == VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO);
+    REQUIRE(inBlob(pView->pNext));
+    REQUIRE(inBlob(pView->pApplicationInfo));
+    REQUIRE(strcmp(pView->pApplicationInfo->pApplicationName, "Application") == 0);
+    REQUIRE(strcmp(static_cast<VkApplicationInfo const *>(pView->pNext)->pApplicationName,
+                   "Application") == 0);
+    REQUIRE(pView->enabledLayerCount == 2);
+    REQUIRE(inBlob(pView->ppEnabledLayerNames[1]));
+    REQUIRE(strcmp(pView->ppEnabledLayerNames[1], "LayerB") == 0);
+}
+
+TEST_CASE("Invalid blobs are not viewed") {
+    VkApplicationInfo test{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                           .pApplicationName = "Application"};
+
+    std::size_t const size = vk_struct_blob_size(&test);
+    std::vector<std::max_align_t> blob(size / sizeof(std::max_align_t) + 1);
+    REQUIRE(vk_struct_blob_write(&test, blob.data(), size) == size);
+
+    REQUIRE(vk_struct_blob_view(nullptr, size) == nullptr);
+    REQUIRE(vk_struct_blob_view(blob.data(), size - 1) == nullptr);
+
+    // Point the one relocated pointer, listed at the end of the blob, outside of the blob
+    auto *pBytes = reinterpret_cast<std::byte *>(blob.data());
+    uint64_t slot;
+    std::memcpy(&slot, pBytes + size - sizeof(uint64_t), sizeof(uint64_t));
+    std::intptr_t outside = static_cast<std::intptr_t>(size);
+    std::memcpy(pBytes + slot, &outside, sizeof(void *));
+    REQUIRE(vk_struct_blob_view(blob.data(), size) == nullptr);
+}
+
+TEST_CASE("Blobs with bad relocations are left untouched") {
+    VkApplicationInfo appInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                              .pApplicationName = "Application"};
+    VkInstanceCreateInfo test{.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                              .pApplicationInfo = &appInfo};
+
+    std::size_t const size = vk_struct_blob_size(&test);
+    std::vector<std::max_align_t> blob(size / sizeof(std::max_align_t) + 1);
+    REQUIRE(vk_struct_blob_write(&test, blob.data(), size) == size);
+    std::vector<std::max_align_t> const written{blob};
+
+    // The two relocations, pApplicationInfo then pApplicationName, are at the end of the blob
+    auto *pBytes = reinterpret_cast<std::byte *>(blob.data());
+    std::byte *pRelocations = pBytes + size - 2 * sizeof(uint64_t);
+
+    SECTION("Listed twice") {
+        std::memcpy(pRelocations + sizeof(uint64_t), pRelocations, sizeof(uint64_t));
+    }
+    SECTION("Out of order") {
+        std::array<std::byte, 2 * sizeof(uint64_t)> swapped;
+        std::memcpy(swapped.data(), pRelocations + sizeof(uint64_t), sizeof(uint64_t));
+        std::memcpy(swapped.data() + sizeof(uint64_t), pRelocations, sizeof(uint64_t));
+        std::memcpy(pRelocations, swapped.data(), swapped.size());
+    }
+    SECTION("Misaligned struct") {
+        // Where the root struct is, going by a copy of the blob
+        std::vector<std::max_align_t> copy{written};
+        auto const root = static_cast<std::byte *>(vk_struct_blob_view(copy.data(), size)) -
+                          reinterpret_cast<std::byte *>(copy.data());
+
+        std::byte *pSlot = pBytes + root + offsetof(VkInstanceCreateInfo, pApplicationInfo);
+        std::intptr_t offset;
+        std::memcpy(&offset, pSlot, sizeof(void *));
+        ++offset;
+        std::memcpy(pSlot, &offset, sizeof(void *));
+    }
+
+    std::vector<std::max_align_t> const changed{blob};
+    REQUIRE(vk_struct_blob_view(blob.data(), size) == nullptr);
+    REQUIRE(std::memcmp(blob.data(), changed.data(), size) == 0);
+}
+
+TEST_CASE("Library of structs found by key") {
+    std::array<VkSamplerCreateInfo, 3> samplers{};
+    for (std::size_t i = 0; i < samplers.size(); ++i) {
+        samplers[i].sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplers[i].maxLod = static_cast<float>(i);
+    }
+    std::array<VkDynamicState, 2> dynamicStates{VK_DYNAMIC_STATE_VIEWPORT,
+                                                VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamicState{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = dynamicStates.size(),
+        .pDynamicStates = dynamicStates.data()};
+    VkGraphicsPipelineCreateInfo pipeline{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                          .pDynamicState = &dynamicState,
+                                          .subpass = 2};
+
+    std::array<void const *, 4> structs{&samplers[0], &pipeline, &samplers[1], &samplers[2]};
+    std::array<uint64_t, 4> keys{30, 7, 12, 0xFFFFFFFFFFFFFFFF};
+
+    std::size_t const size = vk_struct_library_size(structs.data(), structs.size());
+    REQUIRE(size > 0);
+
+    std::vector<std::max_align_t> written(size / sizeof(std::max_align_t) + 1);
+    REQUIRE(vk_struct_library_write(structs.data(), keys.data(), structs.size(), written.data(),
+                                    size - 1) == 0);
+    REQUIRE(vk_struct_library_write(structs.data(), keys.data(), structs.size(), written.data(),
+                                    size) == size);
+
+    // As if loaded from a file elsewhere, with the originals gone
+    std::vector<std::max_align_t> mapped{written};
+    std::fill(written.begin(), written.end(), std::max_align_t{});
+    dynamicStates.fill(VK_DYNAMIC_STATE_LINE_WIDTH);
+
+    REQUIRE(vk_struct_library_count(mapped.data(), size) == 4);
+
+    auto *pPipeline =
+        static_cast<VkGraphicsPipelineCreateInfo *>(vk_struct_library_find(mapped.data(), size, 7));
+    REQUIRE(pPipeline != nullptr);
+    REQUIRE(vk_struct_library_find(mapped.data(), size, 7) == pPipeline);
+    REQUIRE(pPipeline->subpass == 2);
+    REQUIRE(pPipeline->pDynamicState->dynamicStateCount == 2);
+    REQUIRE(pPipeline->pDynamicState->pDynamicStates[1] == VK_DYNAMIC_STATE_SCISSOR);
+
+    auto const *pSampler = static_cast<VkSamplerCreateInfo const *>(
+        vk_struct_library_find(mapped.data(), size, 0xFFFFFFFFFFFFFFFF));
+    REQUIRE(pSampler != nullptr);
+    REQUIRE(pSampler->maxLod == 2.f);
+    REQUIRE(vk_struct_library_find(mapped.data(), size, 8) == nullptr);
+    REQUIRE(vk_struct_library_find(mapped.data(), size, 0) == nullptr);
+
+    // Going through every struct is in order of key
+    uint64_t key = 0;
+    REQUIRE(vk_struct_library_at(mapped.data(), size, 0, &key) == pPipeline);
+    REQUIRE(key == 7);
+    pSampler = static_cast<VkSamplerCreateInfo const *>(
+        vk_struct_library_at(mapped.data(), size, 1, &key));
+    REQUIRE(key == 12);
+    REQUIRE(pSampler->maxLod == 1.f);
+    REQUIRE(vk_struct_library_at(mapped.data(), size, 2, &key) != nullptr);
+    REQUIRE(key == 30);
+    REQUIRE(vk_struct_library_at(mapped.data(), size, 4) == nullptr);
+}
+
+TEST_CASE("Invalid libraries are not read") {
+    VkApplicationInfo appInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+                              .pApplicationName = "Application"};
+    VkBaseInStructure unknown{static_cast<VkStructureType>(0x7FFFFFF0), nullptr};
+
+    std::array<void const *, 2> structs{&appInfo, &appInfo};
+    std::array<uint64_t, 2> keys{1, 1};
+    std::size_t const size = vk_struct_library_size(structs.data(), structs.size());
+    std::vector<std::max_align_t> library(size / sizeof(std::max_align_t) + 1);
+
+    // Keys must all be different, and the structs all known
+    REQUIRE(vk_struct_library_write(structs.data(), keys.data(), 2, library.data(), size) == 0);
+    structs[1] = &unknown;
+    keys[1] = 2;
+    REQUIRE(vk_struct_library_size(structs.data(), structs.size()) == 0);
+    REQUIRE(vk_struct_library_write(structs.data(), keys.data(), 2, library.data(), size) == 0);
+
+    structs[1] = &appInfo;
+    REQUIRE(vk_struct_library_write(structs.data(), keys.data(), 2, library.data(), size) == size);
+    REQUIRE(vk_struct_library_count(library.data(), size) == 2);
+
+    REQUIRE(vk_struct_library_count(nullptr, size) == 0);
+    REQUIRE(vk_struct_library_count(library.data(), size - 1) == 0);
+    REQUIRE(vk_struct_library_find(library.data(), size - 1, 1) == nullptr);
+
+    // From a different VK_HEADER_VERSION
+    auto *pBytes = reinterpret_cast<std::byte *>(library.data());
+    uint32_t headerVersion = VK_HEADER_VERSION + 1;
+    std::memcpy(pBytes + 8, &headerVersion, sizeof(uint32_t));
+    REQUIRE(vk_struct_library_count(library.data(), size) == 0);
+    REQUIRE(vk_struct_library_find(library.data(), size, 1) == nullptr);
+}
+
+TEST_CASE("Deep size of null or unknown structs") {
+    REQUIRE(vk_struct_deep_size(nullptr) == 0);
+
+    VkApplicationInfo test{.sType = static_cast<VkStructureType>(0x7FFFFFFF)};
+    REQUIRE(vk_struct_deep_size(&test) == 0);
+}
+
+TEST_CASE("Owned structs are cleaned up when destroyed") {
+    vk_owned<VkInstanceCreateInfo> owned{VkInstanceCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pApplicationInfo = allocate(VkApplicationInfo{
+            .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+            .pApplicationName = allocateString("Application"),
+        }),
+    }};
+    REQUIRE(std::string{owned->pApplicationInfo->pApplicationName} == "Application");
+
+    // Moves hand over the same data, leaving an empty struct behind
+    auto const *pAppInfo = owned->pApplicationInfo;
+    vk_owned<VkInstanceCreateInfo> moved{std::move(owned)};
+    REQUIRE(moved->pApplicationInfo == pAppInfo);
+    REQUIRE(owned->sType == VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO);
+    REQUIRE(owned->pApplicationInfo == nullptr);
+
+    vk_owned<VkInstanceCreateInfo> assigned;
+    REQUIRE(assigned->sType == VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO);
+    assigned = std::move(moved);
+    REQUIRE(assigned->pApplicationInfo == pAppInfo);
+    REQUIRE(moved->pApplicationInfo == nullptr);
+
+    // Clones are separate copies of the whole graph
+    auto clone = assigned.clone();
+    REQUIRE(clone->pApplicationInfo != pAppInfo);
+    REQUIRE(std::string{clone->pApplicationInfo->pApplicationName} == "Application");
+
+    assigned.reset();
+    REQUIRE(assigned->pApplicationInfo == nullptr);
+    REQUIRE(std::string{clone->pApplicationInfo->pApplicationName} == "Application");
+
+    // As can structs with nothing in their pNext chain
+    vk_owned<VkPhysicalDeviceFeatures2> features;
+    features->features.geometryShader = VK_TRUE;
+    REQUIRE(features.clone()->features.geometryShader == VK_TRUE);
+}
+
+TEST_CASE("Owned structs with allocation callbacks") {
+    CountingAllocator counter;
+    auto callbacks = counter.callbacks();
+
+    {
+        vk_owned<VkInstanceCreateInfo> owned{
+            VkInstanceCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                .pNext = counter.allocate(
+                    callbacks, VkApplicationInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO}),
+                .pApplicationInfo = counter.allocate(
+                    callbacks, VkApplicationInfo{.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO}),
+            },
+            &callbacks};
+        REQUIRE(counter.live == 2);
+
+        // A clone is a single allocation from the same callbacks
+        auto clone = owned.clone();
+        REQUIRE(counter.live == 3);
+        REQUIRE(clone->pNext != nullptr);
+
+        auto moved = std::move(clone);
+        REQUIRE(counter.live == 3);
+    }
+    REQUIRE(counter.live == 0);
+}
+
+TEST_CASE("Cleanup doesn't throw when out of memory") {
+    CountingAllocator counter;
+    auto callbacks = counter.callbacks();
+
+    // Each link leaves its state structs pending while its pNext is walked, which outgrows the
+    // inline part of the walk's stack
+    auto allocateLink = [&](void const *pNext) {
+        return counter.allocate(
+            callbacks,
+            VkGraphicsPipelineCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                .pNext = pNext,
+                .pVertexInputState = counter.allocate(
+                    callbacks, VkPipelineVertexInputStateCreateInfo{
+                                   .sType =
+                                       VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO}),
+                .pViewportState = counter.allocate(
+                    callbacks, VkPipelineViewportStateCreateInfo{
+                                   .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO}),
+                .pMultisampleState = counter.allocate(
+                    callbacks,
+                    VkPipelineMultisampleStateCreateInfo{
+                        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO}),
+                .pColorBlendState = counter.allocate(
+                    callbacks,
+                    VkPipelineColorBlendStateCreateInfo{
+                        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO}),
+                .pDynamicState = counter.allocate(
+                    callbacks, VkPipelineDynamicStateCreateInfo{
+                                   .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO}),
+            });
+    };
+
+    constexpr int cLinks = 100;
+    void const *pChain = nullptr;
+    for (int i = 0; i < cLinks; ++i)
+        pChain = allocateLink(pChain);
+    REQUIRE(counter.live == cLinks * 6);
+
+    SECTION("Released by an owned struct") {
+        {
+            vk_owned<VkGraphicsPipelineCreateInfo> owned{
+                VkGraphicsPipelineCreateInfo{
+                    .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, .pNext = pChain},
+                &callbacks};
+            counter.fail = true;
+        }
+        REQUIRE(counter.failed > 0);
+        REQUIRE(counter.live == 0);
+    }
+    SECTION("Cleaned up directly") {
+        VkGraphicsPipelineCreateInfo test{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                          .pNext = pChain};
+        counter.fail = true;
+        REQUIRE_NOTHROW(vk_struct_cleanup(&test, &callbacks));
+        REQUIRE(counter.failed > 0);
+        REQUIRE(counter.live == 0);
+    }
+    SECTION("With memory to spare, the walk's stack comes from the callbacks too") {
+        VkGraphicsPipelineCreateInfo test{.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+                                          .pNext = pChain};
+        int const total = counter.total;
+        vk_struct_cleanup(&test, &callbacks);
+        REQUIRE(counter.total > total);
+        REQUIRE(counter.live == 0);
+    }
+}
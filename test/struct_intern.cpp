@@ -0,0 +1,179 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_EQUALITY_CHECK_CONFIG_MAIN
+#define VK_STRUCT_INTERN_CONFIG_MAIN
+#include "vk_struct_intern.hpp"
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Equal values intern to the same pointer") {
+    VkSamplerCreateInfo test1{.magFilter = VK_FILTER_LINEAR, .maxLod = 4.f};
+    VkSamplerCreateInfo test2{.magFilter = VK_FILTER_LINEAR, .maxLod = 4.f};
+    VkSamplerCreateInfo test3{.magFilter = VK_FILTER_NEAREST, .maxLod = 4.f};
+
+    auto stats = vk_intern_stats<VkSamplerCreateInfo>();
+
+    auto *pInterned1 = vk_intern(test1);
+    auto *pInterned2 = vk_intern(test2);
+    auto *pInterned3 = vk_intern(test3);
+
+    REQUIRE(pInterned1 == pInterned2);
+    REQUIRE(pInterned1 != pInterned3);
+    REQUIRE(*pInterned1 == test1);
+    REQUIRE(*pInterned3 == test3);
+
+    auto newStats = vk_intern_stats<VkSamplerCreateInfo>();
+    REQUIRE(newStats.hits == stats.hits + 1);
+    REQUIRE(newStats.misses == stats.misses + 2);
+}
+
+TEST_CASE("Pointed-to data is deep copied") {
+    std::array<VkSampler, 2> samplers{reinterpret_cast<VkSampler>(1),
+                                      reinterpret_cast<VkSampler>(2)};
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{
+        VkDescriptorSetLayoutBinding{.binding = 0, .descriptorCount = 2,
+                                     .pImmutableSamplers = samplers.data()},
+        VkDescriptorSetLayoutBinding{.binding = 1, .descriptorCount = 1},
+    };
+    VkDescriptorSetLayoutCreateInfo test{.bindingCount = bindings.size(),
+                                         .pBindings = bindings.data()};
+
+    auto *pInterned = vk_intern(test);
+
+    REQUIRE(*pInterned == test);
+    REQUIRE(pInterned->pBindings != bindings.data());
+    REQUIRE(pInterned->pBindings[0].pImmutableSamplers != samplers.data());
+    REQUIRE(pInterned->pBindings[1].pImmutableSamplers == nullptr);
+
+    // Changing the source data afterwards does not affect the pooled copy
+    samplers[1] = reinterpret_cast<VkSampler>(3);
+    REQUIRE(pInterned->pBindings[0].pImmutableSamplers[1] == reinterpret_cast<VkSampler>(2));
+    REQUIRE(vk_intern(test) != pInterned);
+}
+
+TEST_CASE("Strings are deep copied") {
+    std::string name = "Application";
+    VkApplicationInfo test{.pApplicationName = name.data()};
+
+    auto *pInterned = vk_intern(test);
+
+    REQUIRE(pInterned->pApplicationName != name.data());
+    REQUIRE(strcmp(pInterned->pApplicationName, "Application") == 0);
+    REQUIRE(pInterned->pEngineName == nullptr);
+
+    name = "Other";
+    REQUIRE(strcmp(pInterned->pApplicationName, "Application") == 0);
+}
+
+TEST_CASE("pNext chains are compared and deep copied") {
+    VkPhysicalDeviceVulkan12Features features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .samplerMirrorClampToEdge = VK_TRUE};
+    VkPhysicalDeviceFeatures2 test{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                                   .pNext = &features12};
+    VkPhysicalDeviceFeatures2 noChain{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+
+    auto *pInterned = vk_intern(test);
+    REQUIRE(pInterned != nullptr);
+    REQUIRE(pInterned != vk_intern(noChain));
+
+    SECTION("The chain is copied") {
+        auto const *pLink = static_cast<VkPhysicalDeviceVulkan12Features const *>(pInterned->pNext);
+        REQUIRE(pLink != &features12);
+        REQUIRE(pLink->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+        REQUIRE(pLink->samplerMirrorClampToEdge == VK_TRUE);
+        REQUIRE(pLink->pNext == nullptr);
+    }
+    SECTION("Equal chains intern to the same pointer") {
+        VkPhysicalDeviceVulkan12Features otherFeatures12 = features12;
+        VkPhysicalDeviceFeatures2 other = test;
+        other.pNext = &otherFeatures12;
+        REQUIRE(vk_intern(other) == pInterned);
+    }
+    SECTION("Changing a link afterwards interns a different value") {
+        features12.samplerMirrorClampToEdge = VK_FALSE;
+        REQUIRE(vk_intern(test) != pInterned);
+        REQUIRE(static_cast<VkPhysicalDeviceVulkan12Features const *>(pInterned->pNext)
+                    ->samplerMirrorClampToEdge == VK_TRUE);
+    }
+}
+
+TEST_CASE("Chains of pointed-to structs are compared and deep copied") {
+    VkPhysicalDeviceVulkan12Features link{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+    VkGraphicsPipelineCreateInfo test{.stageCount = stages.size(), .pStages = stages.data()};
+
+    auto *pNoChain = vk_intern(test);
+    stages[1].pNext = &link;
+    auto *pInterned = vk_intern(test);
+
+    REQUIRE(pInterned != nullptr);
+    REQUIRE(pInterned != pNoChain);
+    REQUIRE(pInterned->pStages[1].pNext != nullptr);
+    REQUIRE(pInterned->pStages[1].pNext != &link);
+    REQUIRE(vk_intern(test) == pInterned);
+}
+
+TEST_CASE("Chains with a struct that can't be interned are rejected") {
+    VkBaseInStructure unknown{.sType = static_cast<VkStructureType>(0x7FFFFFFE)};
+    VkApplicationInfo test{.pNext = &unknown};
+
+    auto stats = vk_intern_stats();
+    auto typeStats = vk_intern_stats<VkApplicationInfo>();
+
+    REQUIRE(vk_intern(test) == nullptr);
+
+    auto newStats = vk_intern_stats();
+    REQUIRE(newStats.rejections == stats.rejections + 1);
+    REQUIRE(newStats.hits == stats.hits);
+    REQUIRE(newStats.misses == stats.misses);
+    REQUIRE(vk_intern_stats<VkApplicationInfo>().rejections == typeStats.rejections + 1);
+}
+
+TEST_CASE("Concurrent interning returns a single copy") {
+    constexpr int cThreads = 8;
+    constexpr int cValues = 64;
+
+    std::array<std::vector<VkPushConstantRange const *>, cThreads> results;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < cThreads; ++i) {
+        threads.emplace_back([&results, i] {
+            for (uint32_t j = 0; j < cValues; ++j) {
+                VkPushConstantRange range{.offset = j * 4, .size = 4};
+                results[i].push_back(vk_intern(range));
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int i = 1; i < cThreads; ++i) {
+        REQUIRE(results[i] == results[0]);
+    }
+
+    auto stats = vk_intern_stats<VkPushConstantRange>();
+    REQUIRE(stats.misses == cValues);
+    REQUIRE(stats.hits == cValues * (cThreads - 1));
+}
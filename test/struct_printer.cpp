@@ -0,0 +1,263 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_STRUCT_PRINTER_CONFIG_MAIN
+#include "vk_struct_printer.hpp"
+
+#include <array>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+/// Records the size of each write, to see the pieces the text reaches the sink in
+class CountingSink final : public VkPrintSink {
+  public:
+    void write(char const *, std::size_t size) override {
+        if (writes < sizes.size())
+            sizes[writes] = size;
+        ++writes;
+        total += size;
+    }
+
+    std::array<std::size_t, 64> sizes{};
+    std::size_t writes = 0;
+    std::size_t total = 0;
+};
+
+template <typename T>
+std::string print(T const &value) {
+    char buffer[16384];
+    VkBufferSink sink{buffer, sizeof(buffer)};
+    vk_print(value, sink);
+    REQUIRE_FALSE(sink.truncated());
+    return std::string{sink.view()};
+}
+
+// Handles are pointers or 64-bit integers, depending on the platform
+template <typename T>
+T makeHandle(uintptr_t bits) {
+    if constexpr (std::is_pointer_v<T>)
+        return reinterpret_cast<T>(bits);
+    else
+        return static_cast<T>(bits);
+}
+
+} // namespace
+
+TEST_CASE("Struct printer: Plain members") {
+    VkPipelineColorBlendAttachmentState state{
+        .blendEnable = VK_TRUE,
+        .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .colorBlendOp = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .alphaBlendOp = VK_BLEND_OP_ADD,
+        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_A_BIT,
+    };
+
+    CHECK(print(state) == "VkPipelineColorBlendAttachmentState {\n"
+                          "    blendEnable = VK_TRUE\n"
+                          "    srcColorBlendFactor = ONE\n"
+                          "    dstColorBlendFactor = ZERO\n"
+                          "    colorBlendOp = ADD\n"
+                          "    srcAlphaBlendFactor = ONE\n"
+                          "    dstAlphaBlendFactor = ZERO\n"
+                          "    alphaBlendOp = ADD\n"
+                          "    colorWriteMask = A | R\n"
+                          "}\n");
+}
+
+TEST_CASE("Struct printer: Values without names") {
+    VkPipelineColorBlendAttachmentState state{
+        .blendEnable = 2,
+        .srcColorBlendFactor = static_cast<VkBlendFactor>(0x7FFF),
+        .colorWriteMask = VK_COLOR_COMPONENT_G_BIT | 0x100,
+    };
+
+    auto text = print(state);
+    CHECK(text.find("blendEnable = 2\n") != std::string::npos);
+    CHECK(text.find("srcColorBlendFactor = 32767\n") != std::string::npos);
+    CHECK(text.find("colorWriteMask = G | 0x100\n") != std::string::npos);
+
+    state.colorWriteMask = 0;
+    CHECK(print(state).find("colorWriteMask = 0\n") != std::string::npos);
+}
+
+TEST_CASE("Struct printer: Handles are only printed as whether they are null") {
+    VkDescriptorSetLayout const setLayouts[] = {
+        makeHandle<VkDescriptorSetLayout>(0x1000),
+        VK_NULL_HANDLE,
+    };
+    VkPipelineLayoutCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = 2,
+        .pSetLayouts = setLayouts,
+    };
+
+    auto text = print(createInfo);
+    CHECK(text.find("    pSetLayouts = [\n"
+                    "        non-null\n"
+                    "        VK_NULL_HANDLE\n"
+                    "    ]\n") != std::string::npos);
+
+    // Other handle values print the same
+    VkDescriptorSetLayout const otherSetLayouts[] = {
+        makeHandle<VkDescriptorSetLayout>(0x2000),
+        VK_NULL_HANDLE,
+    };
+    createInfo.pSetLayouts = otherSetLayouts;
+    CHECK(print(createInfo) == text);
+}
+
+TEST_CASE("Struct printer: Arrays, strings and pNext chains") {
+    float const priorities[] = {1.f, 0.5f};
+    VkDeviceQueueCreateInfo queueInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueCount = 2,
+        .pQueuePriorities = priorities,
+    };
+    VkPhysicalDeviceVulkan12Features features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = VK_TRUE,
+    };
+    char const *extensions[] = {"VK_KHR_swapchain", "quote\" and\ttab"};
+    VkDeviceCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &features12,
+        .queueCreateInfoCount = 1,
+        .pQueueCreateInfos = &queueInfo,
+        .enabledExtensionCount = 2,
+        .ppEnabledExtensionNames = extensions,
+    };
+
+    auto text = print(createInfo);
+    CHECK(text.starts_with("VkDeviceCreateInfo {\n"
+                           "    sType = DEVICE_CREATE_INFO\n"
+                           "    pNext = [\n"
+                           "        VkPhysicalDeviceVulkan12Features {\n"
+                           "            sType = PHYSICAL_DEVICE_VULKAN_1_2_FEATURES\n"));
+    CHECK(text.find("            timelineSemaphore = VK_TRUE\n"
+                    "        }\n"
+                    "    ]\n") != std::string::npos);
+    CHECK(text.find("    pQueueCreateInfos = [\n"
+                    "        VkDeviceQueueCreateInfo {\n"
+                    "            sType = DEVICE_QUEUE_CREATE_INFO\n"
+                    "            pNext = null\n") != std::string::npos);
+    CHECK(text.find("            pQueuePriorities = [1, 0.5]\n") != std::string::npos);
+    CHECK(text.find("    ppEnabledLayerNames = null\n") != std::string::npos);
+    CHECK(text.find("    ppEnabledExtensionNames = [\n"
+                    "        \"VK_KHR_swapchain\"\n"
+                    "        \"quote\\\" and\\x09tab\"\n"
+                    "    ]\n") != std::string::npos);
+
+    SECTION("Printing by sType is the same") {
+        char buffer[16384];
+        VkBufferSink sink{buffer, sizeof(buffer)};
+        vk_print_struct(&createInfo, sink);
+        CHECK(sink.view() == text);
+    }
+
+    SECTION("Cyclic chains are cut short") {
+        features12.pNext = &features12;
+
+        std::vector<char> buffer(1 << 20);
+        VkBufferSink sink{buffer.data(), buffer.size()};
+        vk_print(createInfo, sink);
+        CHECK_FALSE(sink.truncated());
+        CHECK(sink.view().find("        ...\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("Struct printer: Text is written to the sink in large pieces") {
+    float const priorities[] = {1.f, 0.5f};
+    std::array<VkDeviceQueueCreateInfo, 16> queueInfos;
+    for (uint32_t i = 0; i < queueInfos.size(); ++i) {
+        queueInfos[i] = VkDeviceQueueCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = i,
+            .queueCount = 2,
+            .pQueuePriorities = priorities,
+        };
+    }
+    VkDeviceCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size()),
+        .pQueueCreateInfos = queueInfos.data(),
+    };
+
+    std::string const text = print(createInfo);
+
+    CountingSink sink;
+    vk_print(createInfo, sink);
+    CHECK(sink.total == text.size());
+    CHECK(sink.writes > 1);
+    REQUIRE(sink.writes <= sink.sizes.size());
+
+    // The text is gathered before being written, with only the last piece being what's left over
+    for (std::size_t i = 0; i + 1 < sink.writes; ++i)
+        CHECK(sink.sizes[i] >= 256);
+
+    sink = CountingSink{};
+    vk_print_struct(&createInfo, sink);
+    CHECK(sink.total == text.size());
+}
+
+TEST_CASE("Struct printer: Buffer sink") {
+    VkExtent2D extent{.width = 1920, .height = 1080};
+
+    char buffer[16];
+    VkBufferSink sink{buffer, sizeof(buffer)};
+    vk_print(extent, sink);
+
+    CHECK(sink.truncated());
+    CHECK(sink.view() == "VkExtent2D {\n  ");
+    CHECK(std::string{buffer} == sink.view());
+
+    sink.reset();
+    CHECK_FALSE(sink.truncated());
+    CHECK(sink.view().empty());
+}
+
+TEST_CASE("Struct printer: Ring buffer sink") {
+    VkExtent2D extent{.width = 1920, .height = 1080};
+    std::string const single = print(extent);
+
+    char buffer[64];
+    VkRingBufferSink sink{buffer, sizeof(buffer)};
+    vk_print(extent, sink);
+
+    CHECK(sink.older() == single);
+    CHECK(sink.newer().empty());
+
+    // Only the end of what was printed is kept once wrapped
+    std::string all = single;
+    for (uint32_t i = 0; i < 4; ++i) {
+        extent.width = i;
+        vk_print(extent, sink);
+        all += print(extent);
+    }
+
+    CHECK(sink.written() == all.size());
+    CHECK(sink.older().size() + sink.newer().size() == sizeof(buffer));
+    CHECK(std::string{sink.older()} + std::string{sink.newer()} ==
+          all.substr(all.size() - sizeof(buffer)));
+}
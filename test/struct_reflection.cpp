@@ -0,0 +1,198 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#include "vk_struct_reflection.hpp"
+
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+// The tables are usable at compile time
+static_assert(vk_struct_info<VkExtent2D>().memberCount == 2);
+static_assert(vk_struct_info<VkExtent2D>().pMembers[1].offset == offsetof(VkExtent2D, height));
+static_assert(vk_struct_info(VK_STRUCTURE_TYPE_APPLICATION_INFO) ==
+              &vk_struct_info<VkApplicationInfo>());
+
+// sType traits, in both directions
+static_assert(vk_stype_v<VkApplicationInfo> == VK_STRUCTURE_TYPE_APPLICATION_INFO);
+static_assert(vk_stype_v<VkPhysicalDeviceFeatures2> ==
+              VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+static_assert(std::is_same_v<vk_type_for_stype<VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO>,
+                             VkGraphicsPipelineCreateInfo>);
+static_assert(vk_stype_info(VK_STRUCTURE_TYPE_APPLICATION_INFO)->size ==
+              sizeof(VkApplicationInfo));
+
+namespace {
+
+VkMemberInfo const &findMember(VkStructInfo const &info, std::string_view name) {
+    for (uint32_t i = 0; i < info.memberCount; ++i) {
+        if (info.pMembers[i].name == name)
+            return info.pMembers[i];
+    }
+    FAIL("No member named " << name);
+    return info.pMembers[0];
+}
+
+} // namespace
+
+TEST_CASE("Struct lookup by type and by sType") {
+    auto const *pInfo = vk_struct_info(VkTypeId::VkPipelineColorBlendStateCreateInfo);
+    REQUIRE(pInfo != nullptr);
+    REQUIRE(std::string_view{pInfo->name} == "VkPipelineColorBlendStateCreateInfo");
+    REQUIRE(pInfo->sType == VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO);
+    REQUIRE(pInfo->size == sizeof(VkPipelineColorBlendStateCreateInfo));
+    REQUIRE(pInfo->alignment == alignof(VkPipelineColorBlendStateCreateInfo));
+    REQUIRE(!pInfo->isUnion);
+    REQUIRE(vk_struct_info(pInfo->sType) == pInfo);
+
+    REQUIRE(vk_struct_info<VkExtent2D>().sType == cVkNoStructureType);
+    REQUIRE(vk_struct_info(VkTypeId::UInt32) == nullptr);
+    REQUIRE(vk_struct_info(VkTypeId::VkStructureType) == nullptr);
+    REQUIRE(vk_struct_info(static_cast<VkStructureType>(0x7FFFFFFE)) == nullptr);
+}
+
+TEST_CASE("Member kinds, types and counts") {
+    auto const &info = vk_struct_info<VkPipelineColorBlendStateCreateInfo>();
+
+    auto const &sType = findMember(info, "sType");
+    REQUIRE(sType.kind == VkMemberKind::Enum);
+    REQUIRE(sType.elementType == VkTypeId::VkStructureType);
+
+    REQUIRE(findMember(info, "pNext").kind == VkMemberKind::Next);
+    REQUIRE(findMember(info, "flags").kind == VkMemberKind::Flags);
+    REQUIRE(findMember(info, "flags").optional);
+    REQUIRE(findMember(info, "logicOpEnable").kind == VkMemberKind::Scalar);
+
+    auto const &attachments = findMember(info, "pAttachments");
+    REQUIRE(attachments.kind == VkMemberKind::Array);
+    REQUIRE(attachments.elementKind == VkMemberKind::Struct);
+    REQUIRE(attachments.elementType == VkTypeId::VkPipelineColorBlendAttachmentState);
+    REQUIRE(attachments.offset == offsetof(VkPipelineColorBlendStateCreateInfo, pAttachments));
+    REQUIRE(std::string_view{info.pMembers[attachments.countMember].name} == "attachmentCount");
+    REQUIRE(attachments.elementSize == sizeof(VkPipelineColorBlendAttachmentState));
+
+    auto const &blendConstants = findMember(info, "blendConstants");
+    REQUIRE(blendConstants.kind == VkMemberKind::FixedArray);
+    REQUIRE(blendConstants.elementType == VkTypeId::Float);
+    REQUIRE(blendConstants.fixedCount == 4);
+    REQUIRE(blendConstants.size == 4 * sizeof(float));
+    REQUIRE(blendConstants.elementSize == sizeof(float));
+}
+
+TEST_CASE("Strings, handles and unions") {
+    auto const &appInfo = vk_struct_info<VkApplicationInfo>();
+    REQUIRE(findMember(appInfo, "pApplicationName").kind == VkMemberKind::String);
+    REQUIRE(findMember(appInfo, "pApplicationName").elementType == VkTypeId::Char);
+
+    auto const &instanceInfo = vk_struct_info<VkInstanceCreateInfo>();
+    auto const &layers = findMember(instanceInfo, "ppEnabledLayerNames");
+    REQUIRE(layers.kind == VkMemberKind::StringArray);
+    REQUIRE(layers.elementKind == VkMemberKind::String);
+    REQUIRE(std::string_view{instanceInfo.pMembers[layers.countMember].name} ==
+            "enabledLayerCount");
+    REQUIRE(findMember(instanceInfo, "pApplicationInfo").kind == VkMemberKind::Pointer);
+
+    auto const &bindingInfo = vk_struct_info<VkDescriptorSetLayoutBinding>();
+    auto const &samplers = findMember(bindingInfo, "pImmutableSamplers");
+    REQUIRE(samplers.kind == VkMemberKind::Array);
+    REQUIRE(samplers.elementKind == VkMemberKind::Handle);
+
+    auto const &clearValue = vk_struct_info<VkClearValue>();
+    REQUIRE(clearValue.isUnion);
+    REQUIRE(findMember(clearValue, "color").kind == VkMemberKind::Union);
+    REQUIRE(findMember(clearValue, "depthStencil").kind == VkMemberKind::Struct);
+    REQUIRE(findMember(clearValue, "depthStencil").offset == 0);
+}
+
+TEST_CASE("Runtime sType lookup") {
+    // Core, promoted and extension sType values
+    for (auto sType : {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+                       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                       VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR}) {
+        auto const *pInfo = vk_stype_info(sType);
+        REQUIRE(pInfo != nullptr);
+        REQUIRE(pInfo->sType == sType);
+        REQUIRE(vk_struct_info(sType) != nullptr);
+        REQUIRE(std::string_view{pInfo->name} == vk_struct_info(sType)->name);
+        REQUIRE(pInfo->size == vk_struct_info(sType)->size);
+        REQUIRE(pInfo->alignment == vk_struct_info(sType)->alignment);
+    }
+
+    auto const *pInfo = vk_stype_info(vk_stype_v<VkPhysicalDevicePushDescriptorPropertiesKHR>);
+    REQUIRE(pInfo->size == sizeof(VkPhysicalDevicePushDescriptorPropertiesKHR));
+    REQUIRE(pInfo->alignment == alignof(VkPhysicalDevicePushDescriptorPropertiesKHR));
+
+    // Platform structs keep their name, but have no size unless the platform is enabled
+    auto const *pWin32Info = vk_stype_info(VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR);
+    REQUIRE(pWin32Info != nullptr);
+    REQUIRE(std::string_view{pWin32Info->name} == "VkWin32SurfaceCreateInfoKHR");
+#ifndef VK_USE_PLATFORM_WIN32_KHR
+    REQUIRE(pWin32Info->size == 0);
+#endif
+
+    // Unused values, within and beyond the tables
+    REQUIRE(vk_stype_info(static_cast<VkStructureType>(4000)) == nullptr);
+    REQUIRE(vk_stype_info(static_cast<VkStructureType>(1000000999)) == nullptr);
+    REQUIRE(vk_stype_info(static_cast<VkStructureType>(0x7FFFFFFE)) == nullptr);
+    REQUIRE(vk_stype_info(static_cast<VkStructureType>(-1)) == nullptr);
+}
+
+// Chains can be built and read at compile time
+static_assert(get<VkPhysicalDeviceVulkan12Features>(
+                  VkStructChain<VkPhysicalDeviceFeatures2, VkPhysicalDeviceVulkan12Features>{})
+                  .sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+
+TEST_CASE("Struct chains") {
+    using Chain = VkStructChain<VkPhysicalDeviceFeatures2, VkPhysicalDeviceVulkan12Features,
+                                VkPhysicalDevicePushDescriptorPropertiesKHR>;
+
+    VkPhysicalDeviceVulkan12Features vulkan12{};
+    vulkan12.timelineSemaphore = VK_TRUE;
+    Chain chain{VkPhysicalDeviceFeatures2{}, vulkan12,
+                VkPhysicalDevicePushDescriptorPropertiesKHR{}};
+
+    auto &features = get<VkPhysicalDeviceFeatures2>(chain);
+    REQUIRE(chain.root() == &features);
+    REQUIRE(features.sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2);
+    REQUIRE(features.pNext == &get<VkPhysicalDeviceVulkan12Features>(chain));
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(chain).timelineSemaphore == VK_TRUE);
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(chain).pNext ==
+            &get<VkPhysicalDevicePushDescriptorPropertiesKHR>(chain));
+    REQUIRE(get<VkPhysicalDevicePushDescriptorPropertiesKHR>(chain).sType ==
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR);
+    REQUIRE(get<VkPhysicalDevicePushDescriptorPropertiesKHR>(chain).pNext == nullptr);
+
+    // Following the links finds the same structs
+    REQUIRE(vk_find_in_chain<VkPhysicalDevicePushDescriptorPropertiesKHR>(chain.root()) ==
+            &get<VkPhysicalDevicePushDescriptorPropertiesKHR>(chain));
+    REQUIRE(vk_find_in_chain<VkApplicationInfo>(chain.root()) == nullptr);
+    REQUIRE(vk_find_in_chain<VkApplicationInfo>(VkInstanceCreateInfo{}.pNext) == nullptr);
+
+    // Copies link to their own structs
+    Chain copy = chain;
+    REQUIRE(copy.root()->pNext == &get<VkPhysicalDeviceVulkan12Features>(copy));
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(copy).timelineSemaphore == VK_TRUE);
+
+    Chain assigned;
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(assigned).timelineSemaphore == VK_FALSE);
+    assigned = chain;
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(assigned).timelineSemaphore == VK_TRUE);
+    REQUIRE(get<VkPhysicalDeviceVulkan12Features>(assigned).pNext ==
+            &get<VkPhysicalDevicePushDescriptorPropertiesKHR>(assigned));
+}
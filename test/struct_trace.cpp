@@ -0,0 +1,376 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_STRUCT_TRACE_RING_SIZE 8192
+#define VK_STRUCT_TRACE_CONFIG_MAIN
+#define VK_STRUCT_TRACE_CONFIG_DECODE
+#define VK_STRUCT_CLEANUP_CONFIG_MAIN
+#define VK_STRUCT_PRINTER_CONFIG_MAIN
+#include "vk_struct_printer.hpp"
+#include "vk_struct_trace.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+void writeTo(void const *pData, std::size_t size, void *pUserData) {
+    auto &trace = *static_cast<std::vector<std::byte> *>(pUserData);
+    auto const *pBytes = static_cast<std::byte const *>(pData);
+    trace.insert(trace.end(), pBytes, pBytes + size);
+}
+
+std::vector<std::byte> drainTrace() {
+    std::vector<std::byte> trace;
+    vk_trace_write_header(writeTo, &trace);
+    vk_trace_drain(writeTo, &trace);
+    return trace;
+}
+
+std::string print(void const *pStruct) {
+    std::vector<char> buffer(1 << 16);
+    VkBufferSink sink{buffer.data(), buffer.size()};
+    vk_print_struct(pStruct, sink);
+    REQUIRE_FALSE(sink.truncated());
+    return std::string{sink.view()};
+}
+
+struct Decoded {
+    VkTypeId type;
+    uint16_t thread;
+    uint64_t sequence;
+    std::string text;
+    /// For samplers, which are numbered by their maxLod
+    float maxLod = -1.f;
+};
+
+std::vector<Decoded> decode(std::vector<std::byte> const &trace, bool *pValid = nullptr) {
+    std::vector<Decoded> decoded;
+    bool const valid = vk_trace_decode(
+        trace.data(), trace.size(),
+        [](VkTraceRecord const &record, void *pUserData) {
+            auto &decoded = *static_cast<std::vector<Decoded> *>(pUserData);
+            decoded.push_back({record.type, record.thread, record.sequence, print(record.pStruct)});
+            if (record.type == VkTypeId::VkSamplerCreateInfo)
+                decoded.back().maxLod =
+                    static_cast<VkSamplerCreateInfo const *>(record.pStruct)->maxLod;
+        },
+        &decoded);
+
+    if (pValid != nullptr)
+        *pValid = valid;
+    else
+        CHECK(valid);
+    return decoded;
+}
+
+VkSamplerCreateInfo numberedSampler(uint32_t number) {
+    return {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = VK_FILTER_LINEAR,
+        .maxLod = static_cast<float>(number),
+    };
+}
+
+} // namespace
+
+TEST_CASE("Struct trace: Captures decode to the same structs") {
+    drainTrace();
+
+    float priorities[] = {1.f, 0.5f};
+    VkDeviceQueueCreateInfo queues[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = 0,
+            .queueCount = 2,
+            .pQueuePriorities = priorities,
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = 2,
+            .queueCount = 1,
+            .pQueuePriorities = priorities + 1,
+        },
+    };
+    char extension[] = "VK_KHR_swapchain";
+    char const *extensions[] = {extension, "VK_KHR_push_descriptor"};
+    VkPhysicalDeviceFeatures features{.geometryShader = VK_TRUE};
+    VkPhysicalDeviceVulkan12Features vulkan12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = VK_TRUE,
+    };
+    VkDeviceCreateInfo device{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &vulkan12,
+        .queueCreateInfoCount = 2,
+        .pQueueCreateInfos = queues,
+        .enabledExtensionCount = 2,
+        .ppEnabledExtensionNames = extensions,
+        .pEnabledFeatures = &features,
+    };
+
+    uint32_t specializationData[] = {7, 9};
+    VkSpecializationMapEntry entries[] = {{0, 0, 4}, {1, 4, 4}};
+    VkSpecializationInfo specialization{2, entries, sizeof(specializationData),
+                                        specializationData};
+    VkPipelineShaderStageCreateInfo stages[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .pName = "main",
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_FRAGMENT_BIT,
+            .pName = "fragMain",
+            .pSpecializationInfo = &specialization,
+        },
+    };
+    VkGraphicsPipelineCreateInfo pipeline{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = 2,
+        .pStages = stages,
+        .subpass = 3,
+    };
+
+    std::string const deviceText = print(&device);
+    std::string const pipelineText = print(&pipeline);
+
+    CHECK(vk_trace(device));
+    CHECK(vk_trace(pipeline));
+    CHECK(vk_trace_struct(&device));
+
+    // Changes after capturing aren't seen in the trace
+    extension[0] = 'X';
+    priorities[1] = 0.f;
+    specializationData[0] = 0;
+    vulkan12.timelineSemaphore = VK_FALSE;
+
+    auto decoded = decode(drainTrace());
+    REQUIRE(decoded.size() == 3);
+
+    CHECK(decoded[0].type == VkTypeId::VkDeviceCreateInfo);
+    CHECK(decoded[0].text == deviceText);
+    CHECK(decoded[1].type == VkTypeId::VkGraphicsPipelineCreateInfo);
+    CHECK(decoded[1].text == pipelineText);
+    CHECK(decoded[2].text == deviceText);
+
+    CHECK(decoded[0].thread == decoded[1].thread);
+    CHECK(decoded[1].sequence == decoded[0].sequence + 1);
+    CHECK(decoded[2].sequence == decoded[0].sequence + 2);
+
+    // Once drained, the captures are gone
+    CHECK(decode(drainTrace()).empty());
+}
+
+TEST_CASE("Struct trace: Unknown structs") {
+    drainTrace();
+
+    CHECK_FALSE(vk_trace_struct(nullptr));
+
+    VkBaseInStructure unknown{static_cast<VkStructureType>(0x7FFFFFF0), nullptr};
+    CHECK_FALSE(vk_trace_struct(&unknown));
+
+    // The chain is cut at the first struct of an unknown type
+    VkPhysicalDeviceVulkan12Features vulkan12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .pNext = &unknown,
+        .drawIndirectCount = VK_TRUE,
+    };
+    VkPhysicalDeviceFeatures2 features{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+        .pNext = &vulkan12,
+    };
+    CHECK(vk_trace(features));
+
+    auto decoded = decode(drainTrace());
+    REQUIRE(decoded.size() == 1);
+
+    vulkan12.pNext = nullptr;
+    CHECK(decoded[0].text == print(&features));
+}
+
+TEST_CASE("Struct trace: Full ring buffers drop captures") {
+    drainTrace();
+    uint64_t const droppedBefore = vk_trace_dropped();
+
+    uint32_t captured = 0;
+    while (vk_trace(numberedSampler(captured)))
+        ++captured;
+    CHECK(captured > 0);
+    CHECK_FALSE(vk_trace(numberedSampler(captured)));
+    CHECK(vk_trace_dropped() == droppedBefore + 2);
+
+    auto decoded = decode(drainTrace());
+    REQUIRE(decoded.size() == captured);
+    for (uint32_t i = 0; i < captured; ++i) {
+        auto sampler = numberedSampler(i);
+        CHECK(decoded[i].text == print(&sampler));
+    }
+
+    // The dropped captures show up as a gap in the sequence
+    uint64_t const firstSequence = decoded[0].sequence;
+    CHECK(vk_trace(numberedSampler(0)));
+    decoded = decode(drainTrace());
+    REQUIRE(decoded.size() == 1);
+    CHECK(decoded[0].sequence == firstSequence + captured + 2);
+}
+
+TEST_CASE("Struct trace: Captures wrap around the ring buffer") {
+    drainTrace();
+
+    // Captures of different sizes, so the end of the ring buffer is reached at different points
+    char const *names[] = {"a", "a much longer entry point name, to change the capture size"};
+    uint32_t number = 0;
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::string> expected;
+        for (int i = 0; i < 7; ++i, ++number) {
+            VkPipelineShaderStageCreateInfo stage{
+                .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+                .pName = names[number % 3 == 0],
+            };
+            auto sampler = numberedSampler(number);
+            REQUIRE(vk_trace(stage));
+            REQUIRE(vk_trace(sampler));
+            expected.push_back(print(&stage));
+            expected.push_back(print(&sampler));
+        }
+
+        auto decoded = decode(drainTrace());
+        REQUIRE(decoded.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+            CHECK(decoded[i].text == expected[i]);
+    }
+}
+
+TEST_CASE("Struct trace: Each thread captures into its own ring buffer") {
+    drainTrace();
+    uint64_t const droppedBefore = vk_trace_dropped();
+
+    constexpr uint32_t cThreads = 4;
+    constexpr uint32_t cCaptures = 500;
+    std::atomic<uint32_t> running{cThreads};
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 0; thread < cThreads; ++thread) {
+        threads.emplace_back([&running, thread] {
+            for (uint32_t i = 0; i < cCaptures; ++i)
+                vk_trace(numberedSampler(thread * cCaptures + i));
+            --running;
+        });
+    }
+
+    // Drained at the same time as the threads capture, then once more after they've exited
+    std::vector<std::byte> trace;
+    vk_trace_write_header(writeTo, &trace);
+    while (running != 0)
+        vk_trace_drain(writeTo, &trace);
+    for (auto &thread : threads)
+        thread.join();
+    vk_trace_drain(writeTo, &trace);
+
+    auto decoded = decode(trace);
+    CHECK(decoded.size() + (vk_trace_dropped() - droppedBefore) == cThreads * cCaptures);
+
+    // Within each thread, captures are in order, with any dropped ones skipped
+    std::vector<int64_t> lastSequence(UINT16_MAX + 1, -1);
+    std::vector<int64_t> lastNumber(cThreads, -1);
+    for (auto const &it : decoded) {
+        CHECK(static_cast<int64_t>(it.sequence) > lastSequence[it.thread]);
+        lastSequence[it.thread] = it.sequence;
+
+        REQUIRE(it.maxLod >= 0.f);
+        auto const number = static_cast<uint32_t>(it.maxLod);
+        REQUIRE(number < cThreads * cCaptures);
+        CHECK(static_cast<int64_t>(number) > lastNumber[number / cCaptures]);
+        lastNumber[number / cCaptures] = number;
+    }
+
+    // The rings of the exited threads were freed once drained
+    CHECK(decode(drainTrace()).empty());
+}
+
+TEST_CASE("Struct trace: Invalid traces") {
+    drainTrace();
+
+    VkApplicationInfo application{
+        .sType = VK_STRUCTURE_TYPE_APPLICATION_INFO,
+        .pApplicationName = "Trace",
+    };
+    VkInstanceCreateInfo instance{
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pApplicationInfo = &application,
+    };
+    REQUIRE(vk_trace(instance));
+    REQUIRE(vk_trace(instance));
+    auto const trace = drainTrace();
+    REQUIRE(decode(trace).size() == 2);
+
+    bool valid = true;
+    CHECK(decode({}, &valid).empty());
+    CHECK_FALSE(valid);
+
+    SECTION("Different header version") {
+        auto changed = trace;
+        uint32_t headerVersion = VK_HEADER_VERSION + 1;
+        std::memcpy(changed.data() + 4, &headerVersion, sizeof(uint32_t));
+        CHECK(decode(changed, &valid).empty());
+        CHECK_FALSE(valid);
+    }
+    SECTION("Truncated") {
+        auto truncated = trace;
+        truncated.pop_back();
+        CHECK(decode(truncated, &valid).size() == 1);
+        CHECK_FALSE(valid);
+    }
+    SECTION("Pointer backwards") {
+        // The first pointer to be fixed up, pApplicationInfo, made to point at the struct itself
+        auto changed = trace;
+        std::size_t const record = sizeof(vk_struct_trace_detail::StreamHeader);
+        uint64_t base;
+        std::memcpy(&base, changed.data() + record + 16, sizeof(uint64_t));
+        std::memcpy(changed.data() + record + vk_struct_trace_detail::cDataOffset +
+                        offsetof(VkInstanceCreateInfo, pApplicationInfo),
+                    &base, sizeof(uint64_t));
+        CHECK(decode(changed, &valid).empty());
+        CHECK_FALSE(valid);
+    }
+    SECTION("Array count past the end") {
+        float const priorities[] = {1.f, 0.5f};
+        VkDeviceQueueCreateInfo queue{
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueCount = 2,
+            .pQueuePriorities = priorities,
+        };
+        REQUIRE(vk_trace(queue));
+        auto changed = drainTrace();
+        REQUIRE(decode(changed).size() == 1);
+
+        uint32_t const queueCount = 100000000;
+        std::memcpy(changed.data() + sizeof(vk_struct_trace_detail::StreamHeader) +
+                        vk_struct_trace_detail::cDataOffset +
+                        offsetof(VkDeviceQueueCreateInfo, queueCount),
+                    &queueCount, sizeof(uint32_t));
+        CHECK(decode(changed, &valid).empty());
+        CHECK_FALSE(valid);
+    }
+}
@@ -0,0 +1,258 @@
+/*
+    Copyright (C) 2021 George Cave - gcave@stablecoder.ca
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <catch.hpp>
+#include <vulkan/vulkan.h>
+
+#define VK_STRUCT_VALIDATION_CONFIG_MAIN
+#include "vk_struct_validation.hpp"
+
+namespace {
+
+bool hasError(std::vector<VkValidationError> const &errors, std::string const &path) {
+    for (auto const &it : errors) {
+        if (it.path == path)
+            return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TEST_CASE("Struct validation: Valid structs have no errors") {
+    float const priorities[] = {1.f, 0.5f};
+    VkDeviceQueueCreateInfo queueInfos[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = 0,
+            .queueCount = 2,
+            .pQueuePriorities = priorities,
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueFamilyIndex = 1,
+            .queueCount = 1,
+            .pQueuePriorities = priorities,
+        },
+    };
+    char const *extensions[] = {"VK_KHR_swapchain"};
+    VkDeviceCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .queueCreateInfoCount = 2,
+        .pQueueCreateInfos = queueInfos,
+        .enabledExtensionCount = 1,
+        .ppEnabledExtensionNames = extensions,
+    };
+
+    CHECK(vk_validate_struct(&createInfo).empty());
+
+    VkPhysicalDeviceVulkan12Features features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = VK_TRUE,
+    };
+    createInfo.pNext = &features12;
+
+    CHECK(vk_validate_struct(&createInfo).empty());
+}
+
+TEST_CASE("Struct validation: Roots that can't be validated") {
+    auto errors = vk_validate_struct(nullptr);
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].path.empty());
+
+    VkBaseInStructure unknown{.sType = static_cast<VkStructureType>(0x7FFFFF00)};
+    errors = vk_validate_struct(&unknown);
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].path == "sType");
+}
+
+TEST_CASE("Struct validation: Member errors are reported by path") {
+    VkDeviceQueueCreateInfo queueInfos[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+            .queueCount = 1,
+            .pQueuePriorities = nullptr,
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+            .queueCount = 0,
+        },
+    };
+    VkDeviceCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .queueCreateInfoCount = 2,
+        .pQueueCreateInfos = queueInfos,
+        .enabledLayerCount = 1,
+        .ppEnabledLayerNames = nullptr,
+    };
+
+    auto errors = vk_validate_struct(&createInfo);
+    CHECK(errors.size() == 4);
+    CHECK(hasError(errors, "pQueueCreateInfos[0].pQueuePriorities"));
+    CHECK(hasError(errors, "pQueueCreateInfos[1].sType"));
+    CHECK(hasError(errors, "pQueueCreateInfos[1].queueCount"));
+    CHECK(hasError(errors, "ppEnabledLayerNames"));
+
+    char const *layers[] = {"VK_LAYER_KHRONOS_validation", nullptr};
+    createInfo.enabledLayerCount = 2;
+    createInfo.ppEnabledLayerNames = layers;
+    createInfo.queueCreateInfoCount = 0;
+    createInfo.pQueueCreateInfos = nullptr;
+
+    errors = vk_validate_struct(&createInfo);
+    CHECK(errors.size() == 2);
+    CHECK(hasError(errors, "queueCreateInfoCount"));
+    CHECK(hasError(errors, "ppEnabledLayerNames[1]"));
+}
+
+TEST_CASE("Struct validation: Enum, flag and bool values") {
+    VkSamplerCreateInfo samplerInfo{
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = VK_FILTER_LINEAR,
+        .minFilter = static_cast<VkFilter>(0x7FFF),
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .anisotropyEnable = 2,
+    };
+
+    auto errors = vk_validate_struct(&samplerInfo);
+    CHECK(errors.size() == 2);
+    CHECK(hasError(errors, "minFilter"));
+    CHECK(hasError(errors, "anisotropyEnable"));
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .flags = 0x40000000,
+    };
+
+    errors = vk_validate_struct(&layoutInfo);
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].path == "flags");
+
+    // Combined values such as VK_SHADER_STAGE_ALL don't let any other bits through
+    VkPushConstantRange const ranges[] = {
+        {.stageFlags = VK_SHADER_STAGE_ALL, .size = 4},
+        {.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | 0x40000000, .size = 4},
+    };
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pushConstantRangeCount = 2,
+        .pPushConstantRanges = ranges,
+    };
+
+    errors = vk_validate_struct(&pipelineLayoutInfo);
+    REQUIRE(errors.size() == 1);
+    CHECK(errors[0].path == "pPushConstantRanges[1].stageFlags");
+    CHECK(errors[0].message == "has unknown bits 0x40000000");
+}
+
+TEST_CASE("Struct validation: Nested pointer and array paths") {
+    VkPipelineShaderStageCreateInfo stages[] = {
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_VERTEX_BIT,
+            .pName = "main",
+        },
+        {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = static_cast<VkShaderStageFlagBits>(0x3),
+            .pName = nullptr,
+        },
+    };
+    VkDynamicState const dynamicStates[] = {VK_DYNAMIC_STATE_VIEWPORT,
+                                            static_cast<VkDynamicState>(0x7FFF)};
+    VkPipelineDynamicStateCreateInfo dynamicState{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = 2,
+        .pDynamicStates = dynamicStates,
+    };
+    VkGraphicsPipelineCreateInfo pipelineInfo{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .stageCount = 2,
+        .pStages = stages,
+        .pDynamicState = &dynamicState,
+    };
+
+    auto errors = vk_validate_struct(&pipelineInfo);
+    CHECK(errors.size() == 3);
+    CHECK(hasError(errors, "pStages[1].stage"));
+    CHECK(hasError(errors, "pStages[1].pName"));
+    CHECK(hasError(errors, "pDynamicState->pDynamicStates[1]"));
+}
+
+TEST_CASE("Struct validation: Malformed pNext chains") {
+    VkPhysicalDeviceVulkan12Features features12{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+    };
+    VkInstanceCreateInfo instanceInfo{
+        .sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO,
+        .pNext = &features12,
+    };
+
+    SECTION("Struct that can't extend the root") {
+        auto errors = vk_validate_struct(&instanceInfo);
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].path == "pNext<VkPhysicalDeviceVulkan12Features>");
+    }
+
+    float const priority = 1.f;
+    VkDeviceQueueCreateInfo queueInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
+        .queueCount = 1,
+        .pQueuePriorities = &priority,
+    };
+    VkDeviceCreateInfo createInfo{
+        .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &features12,
+        .queueCreateInfoCount = 1,
+        .pQueueCreateInfos = &queueInfo,
+    };
+
+    SECTION("Errors within chained structs") {
+        features12.drawIndirectCount = 5;
+
+        auto errors = vk_validate_struct(&createInfo);
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].path == "pNext<VkPhysicalDeviceVulkan12Features>.drawIndirectCount");
+    }
+
+    SECTION("Duplicate structs") {
+        VkPhysicalDeviceVulkan12Features duplicate = features12;
+        features12.pNext = &duplicate;
+
+        auto errors = vk_validate_struct(&createInfo);
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].path == "pNext<VkPhysicalDeviceVulkan12Features>");
+    }
+
+    SECTION("Unknown structs") {
+        VkBaseInStructure unknown{.sType = static_cast<VkStructureType>(0x7FFFFF00)};
+        features12.pNext = &unknown;
+
+        auto errors = vk_validate_struct(&createInfo);
+        REQUIRE(errors.size() == 1);
+        CHECK(errors[0].path == "pNext[1].sType");
+    }
+
+    SECTION("Cyclic chains") {
+        features12.pNext = &features12;
+
+        auto errors = vk_validate_struct(&createInfo);
+        CHECK_FALSE(errors.empty());
+        CHECK(hasError(errors, "pNext"));
+    }
+}